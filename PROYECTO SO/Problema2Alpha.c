@@ -5,45 +5,36 @@
 #include <unistd.h>
 #include <time.h>
 
+#include "espera_fifo.h"
+#include "banco.h"
+#include "vehiculos_en_curso.h"
+
+#ifndef VEHICULOS_POR_HORA
 #define VEHICULOS_POR_HORA 500
+#endif
+#ifndef HORAS_SIMULACION
 #define HORAS_SIMULACION 24
+#endif
+#ifndef UNIDAD_SUBTRAMO_US
+#define UNIDAD_SUBTRAMO_US 35000  // us por unidad de tiempo de subtramo
+#endif
 #define TOTAL_VEHICULOS (VEHICULOS_POR_HORA * HORAS_SIMULACION)
 #define SEGUNDOS_POR_HORA_SIMULACION 30  // segundos simulan 1 hora
 #define TOTAL_SEGUNDOS_SIMULACION (SEGUNDOS_POR_HORA_SIMULACION * HORAS_SIMULACION)  // minutos para 24 horas
 
 // Estructuras de datos
-typedef enum { AUTO, CAMION } vehicleType;
-typedef enum { DIR_1A4, DIR_4A1 } Direccion;
-
 typedef struct {
     int id;              // Identificación del vehículo
     vehicleType tipo;    // Auto o camion
     Direccion dir;       // direccion de conduccion 
     time_t horaEntrada;  // Hora de creación del vehículo
+    unsigned int semillaViaje; // Sorteos de su recorrido
 } Vehiculo;
 
-typedef struct {
-    sem_t semaforo;      // Impide la entrada superior a la capacidad del subtramo
-    int capacidad;
-    int vehiculosPresentes;
-    int contadorAutos;
-    int contadorCamiones;
-    pthread_mutex_t mutex;
-} Subtramo;
-
-typedef struct {
-    sem_t semaforo;      // Para la capacidad deseada del hombrillo (Ilimitadas en la practica)
-    int vehiculosEsperando; // Contador actual de vehículos esperando
-    int maxEspera;    // Máximo histórico de vehículos esperando
-    time_t tiempoMaxEspera;  //Tiempo de espera más largo registrado
-    time_t tiempoTotalEspera; //Suma acumulada de todos los tiempos de espera
-    int totalVehiculosEsperado; //Total de vehículos que han esperado
-    pthread_mutex_t mutex;
-} Hombrillo;
-
 // Variables globales
 Subtramo subtramos[4];
 Hombrillo hombrillos[3];
+int mostrarOcupacion = 1;  // Ocupación de cada subtramo en cada entrada y salida
 
 // Estadísticas
 int estadisticasHorarias[24][2] = {0}; // [hora][direccion] - 0:DIR_1A4, 1:DIR_4A1
@@ -56,18 +47,10 @@ pthread_mutex_t statsMutex = PTHREAD_MUTEX_INITIALIZER;
 void inicializar_recursos()
 {
     // Configurar capacidades de subtramos
-    subtramos[0].capacidad = 4;  // Subtramo 1
-    subtramos[1].capacidad = 2;  // Subtramo 2 (2 autos o 1 camion)
-    subtramos[2].capacidad = 1;  // Subtramo 3
-    subtramos[3].capacidad = 3;  // Subtramo 4
-    
-    for (int i = 0; i < 4; i++) {
-        sem_init(&subtramos[i].semaforo, 0, subtramos[i].capacidad);
-        pthread_mutex_init(&subtramos[i].mutex, NULL);
-        subtramos[i].vehiculosPresentes = 0;
-        subtramos[i].contadorAutos = 0;
-        subtramos[i].contadorCamiones = 0;
-    }
+    iniciar_subtramo(0, 4);  // Subtramo 1
+    iniciar_subtramo(1, 2);  // Subtramo 2 (2 autos o 1 camion)
+    iniciar_subtramo(2, 1);  // Subtramo 3
+    iniciar_subtramo(3, 3);  // Subtramo 4
     
     for (int i = 0; i < 3; i++) {
         sem_init(&hombrillos[i].semaforo, 0, 9999); // Capacidad ilimitada
@@ -80,28 +63,6 @@ void inicializar_recursos()
     }
 }
 
-// Función para verificar si puede entrar al subtramo 2
-int puede_entrar_subtramo2(vehicleType tipo) // TIENE DETALLES GRAVES
-{
-    pthread_mutex_lock(&subtramos[1].mutex);
-    
-    int puede_entrar = 0;
-    if (tipo == AUTO)
-    {
-        puede_entrar = (subtramos[1].contadorAutos < 2);
-        printf("🔍 Verificación Subtramo 2 - Autos: %d/%d - %s\n", 
-               subtramos[1].contadorAutos, 2, puede_entrar ? "Puede entrar" : "LLENO");
-    } else { // CAMION
-        puede_entrar = (subtramos[1].contadorCamiones == 0 && subtramos[1].contadorAutos == 0);
-        printf("🔍 Verificación Subtramo 2 - Camiones: %d, Autos: %d - %s\n", 
-               subtramos[1].contadorCamiones, subtramos[1].contadorAutos, 
-               puede_entrar ? "Puede entrar" : "LLENO");
-    }
-    
-    pthread_mutex_unlock(&subtramos[1].mutex);
-    return puede_entrar;
-}
-
 // Obtener la hora actual de simulación (0-23)
 int obtener_hora_actual()
 {
@@ -148,23 +109,9 @@ void* vehiculoThread(void* arg)
     // Actualizar estadísticas horarias
     actualizar_estadisticas_horarias(v->dir);
     
-    // El vehículo comienza en el primer subtramo
+    // El vehículo comienza en el primer subtramo (si está lleno espera turno en la entrada)
     printf("➡️  Vehículo %d entrando DIRECTAMENTE al subtramo %d\n", v->id, inicio + 1);
-    sem_wait(&subtramos[inicio].semaforo);
-    
-    // Actualizar contadores del primer subtramo
-    pthread_mutex_lock(&subtramos[inicio].mutex);
-    subtramos[inicio].vehiculosPresentes++;
-    if (v->tipo == AUTO) {
-        subtramos[inicio].contadorAutos++;
-    } else {
-        subtramos[inicio].contadorCamiones++;
-    }
-    estadisticasSubtramos[inicio][v->dir]++;
-    printf("📊 Subtramo %d - Autos: %d, Camiones: %d, Total: %d\n", 
-           inicio + 1, subtramos[inicio].contadorAutos, 
-           subtramos[inicio].contadorCamiones, subtramos[inicio].vehiculosPresentes);
-    pthread_mutex_unlock(&subtramos[inicio].mutex);
+    entrar_subtramo(inicio, v->id, v->tipo, v->dir, -1);
     
     // Recorrer todos los subtramos
     for (int i = inicio; i != fin + paso; i += paso) {
@@ -175,39 +122,18 @@ void* vehiculoThread(void* arg)
             printf("🎉 Vehículo %d COMPLETÓ su viaje en subtramo %d\n", v->id, i + 1);
             
             // Salir del subtramo actual antes de terminar
-            pthread_mutex_lock(&subtramos[i].mutex);
-            subtramos[i].vehiculosPresentes--;
-            if (v->tipo == AUTO) {
-                subtramos[i].contadorAutos--;
-            } else {
-                subtramos[i].contadorCamiones--;
-            }
-            pthread_mutex_unlock(&subtramos[i].mutex);
-            sem_post(&subtramos[i].semaforo);
-            
+            salir_subtramo(i, v->tipo);
             break;
         }
         
         // Simular tiempo en el subtramo actual (reducido proporcionalmente)
-        int tiempo_subtramo = (rand() % 2) + 1; // 1-2 segundos (antes 1-2)
+        int tiempo_subtramo = (rand_r(&v->semillaViaje) % 2) + 1; // 1-2 segundos (antes 1-2)
         printf("🚗 Vehículo %d CIRCULANDO en subtramo %d (%d segundos)\n", 
                v->id, i + 1, tiempo_subtramo);
-        usleep(tiempo_subtramo*35000);  // 0.035 (0.035 o 0.07) segundos
+        usleep(tiempo_subtramo * UNIDAD_SUBTRAMO_US);  // 0.035 o 0.07 segundos por defecto
         
         // Salir del subtramo actual
-        pthread_mutex_lock(&subtramos[i].mutex);
-        subtramos[i].vehiculosPresentes--;
-        if (v->tipo == AUTO) {
-            subtramos[i].contadorAutos--;
-        } else {
-            subtramos[i].contadorCamiones--;
-        }
-        printf("📊 Subtramo %d - Autos: %d, Camiones: %d, Total: %d\n", 
-               i + 1, subtramos[i].contadorAutos, 
-               subtramos[i].contadorCamiones, subtramos[i].vehiculosPresentes);
-        pthread_mutex_unlock(&subtramos[i].mutex);
-        
-        sem_post(&subtramos[i].semaforo);
+        salir_subtramo(i, v->tipo);
         printf("✅ Vehículo %d SALIÓ del subtramo %d\n", v->id, i + 1);
         
         // Calcular índice del hombrillo
@@ -218,54 +144,13 @@ void* vehiculoThread(void* arg)
             hombrillo_idx = i - 1;  // Hombrillo entre i-1 e i
         }
         
-        // VERIFICAR si el SIGUIENTE subtramo está lleno
-        int siguiente_lleno = 0;
+        // ENTRAR al siguiente subtramo. Si está LLENO el vehículo espera su
+        // turno en el hombrillo y el que libere el sitio se lo cede
+        time_t inicio_espera = time(NULL);
+        long inicioPaso = usegundos_ahora();
         
-        if (siguiente == 1) { // Subtramo 2 - verificación especial
-            siguiente_lleno = !puede_entrar_subtramo2(v->tipo);
-        } else {
-            // Para otros subtramos, verificar capacidad normal
-            pthread_mutex_lock(&subtramos[siguiente].mutex);
-            siguiente_lleno = (subtramos[siguiente].vehiculosPresentes >= subtramos[siguiente].capacidad);
-            pthread_mutex_unlock(&subtramos[siguiente].mutex);
-        }
-        
-        if (siguiente_lleno) {
-            // IR AL HOMBRILLO a esperar
-            printf("🟡 Vehículo %d → Subtramo %d LLENO, YENDO al hombrillo %d\n", 
-                   v->id, siguiente + 1, hombrillo_idx + 1);
-            
-            time_t inicio_espera = time(NULL);
-            
-            // Entrar al hombrillo
-            pthread_mutex_lock(&hombrillos[hombrillo_idx].mutex);
-            hombrillos[hombrillo_idx].vehiculosEsperando++;
-            if (hombrillos[hombrillo_idx].vehiculosEsperando > hombrillos[hombrillo_idx].maxEspera) {
-                hombrillos[hombrillo_idx].maxEspera = hombrillos[hombrillo_idx].vehiculosEsperando;
-            }
-            pthread_mutex_unlock(&hombrillos[hombrillo_idx].mutex);
-            
-            // Esperar activamente hasta que haya espacio 
-            int puede_avanzar = 0;
-            while (!puede_avanzar)
-            {
-                usleep(30000);  // Verificar cada 0.03 segundos
-                
-                if (siguiente == 1) { // Subtramo 2
-                    puede_avanzar = puede_entrar_subtramo2(v->tipo);
-                } else {
-                    // Para otros subtramos
-                    pthread_mutex_lock(&subtramos[siguiente].mutex);
-                    puede_avanzar = (subtramos[siguiente].vehiculosPresentes < subtramos[siguiente].capacidad);
-                    pthread_mutex_unlock(&subtramos[siguiente].mutex);
-                }
-            }
-            
-            // Salir del hombrillo
-            pthread_mutex_lock(&hombrillos[hombrillo_idx].mutex);
-            hombrillos[hombrillo_idx].vehiculosEsperando--;
-            pthread_mutex_unlock(&hombrillos[hombrillo_idx].mutex);
-            
+        if (entrar_subtramo(siguiente, v->id, v->tipo, v->dir, hombrillo_idx)) {
+            anotar_espera(inicioPaso);
             time_t fin_espera = time(NULL);
             time_t duracion_espera = fin_espera - inicio_espera;
             
@@ -284,28 +169,12 @@ void* vehiculoThread(void* arg)
             printf("🟢 Vehículo %d → Subtramo %d tiene ESPACIO, AVANZANDO directamente\n", 
                    v->id, siguiente + 1);
         }
-        
-        // ENTRAR al siguiente subtramo
-        printf("➡️  Vehículo %d ENTRANDO al subtramo %d\n", v->id, siguiente + 1);
-        sem_wait(&subtramos[siguiente].semaforo);
-        
-        // Actualizar contadores del subtramo
-        pthread_mutex_lock(&subtramos[siguiente].mutex); //ACTUALIZACION FUERA DE TIEMPO
-        subtramos[siguiente].vehiculosPresentes++;
-        if (v->tipo == AUTO) {
-            subtramos[siguiente].contadorAutos++;
-        } else {
-            subtramos[siguiente].contadorCamiones++;
-        }
-        estadisticasSubtramos[siguiente][v->dir]++;
-        printf("📊 Subtramo %d - Autos: %d, Camiones: %d, Total: %d\n", 
-               siguiente + 1, subtramos[siguiente].contadorAutos, 
-               subtramos[siguiente].contadorCamiones, subtramos[siguiente].vehiculosPresentes);
-        pthread_mutex_unlock(&subtramos[siguiente].mutex);
+        printf("➡️  Vehículo %d ENTRÓ al subtramo %d\n", v->id, siguiente + 1);
     }
     
     printf("🏁 Vehículo %d terminó su recorrido\n", v->id);
     free(v);
+    vehiculo_terminado();
     return NULL;
 }
 
@@ -348,6 +217,21 @@ void mostrar_estadisticas()
         printf("  Total vehículos que esperaron: %d\n", hombrillos[i].totalVehiculosEsperado);
     }
     
+    // Despertares de los vehículos que esperaron turno
+    long despertares = 0, traspasos = 0;
+    double latencia = 0;
+    for (int i = 0; i < 4; i++) {
+        despertares += subtramos[i].despertares;
+        traspasos += subtramos[i].traspasos;
+        latencia += subtramos[i].latenciaTraspaso;
+    }
+    printf("\n🔔 ESPERAS DE TURNO (hombrillos y entradas):\n");
+    printf("  Vehículos que esperaron turno: %ld\n", traspasos);
+    if (traspasos > 0) {
+        printf("  Despertares por vehículo admitido: %.2f\n", (double)despertares / traspasos);
+        printf("  Latencia media desde que se cede el sitio: %.1f us\n", latencia / traspasos);
+    }
+    
     printf("\n📦 TOTAL DE VEHÍCULOS EN EL DÍA: %d\n", totalVehiculosDia);
     printf("==========================================\n");
 }
@@ -356,7 +240,6 @@ void mostrar_estadisticas()
 void limpiar_recursos()
 {
     for (int i = 0; i < 4; i++) {
-        sem_destroy(&subtramos[i].semaforo);
         pthread_mutex_destroy(&subtramos[i].mutex);
     }
     
@@ -369,7 +252,7 @@ void limpiar_recursos()
 }
 
 int main() {
-    srand(time(NULL)); // Semilla de tiempo aleatoria
+    configurar_banco(); // SEMILLA o la hora, y el fichero de ESPERAS
     inicioSimulacion = time(NULL);
     inicializar_recursos();
 
@@ -395,13 +278,12 @@ int main() {
         
         Vehiculo* v = malloc(sizeof(Vehiculo));
         v->id = vehiculosGenerados + 1;
-        v->tipo = (rand() % 4 == 0) ? CAMION : AUTO; // 75% autos / 25% camiones
-        v->dir = (rand() % 2) ? DIR_1A4 : DIR_4A1;   // 50% de cada direcion
+        v->tipo = (rand_r(&semillaLlegadas) % 4 == 0) ? CAMION : AUTO; // 75% autos / 25% camiones
+        v->dir = (rand_r(&semillaLlegadas) % 2) ? DIR_1A4 : DIR_4A1;   // 50% de cada direcion
         v->horaEntrada = time(NULL);
+        v->semillaViaje = rand_r(&semillaLlegadas);
         
-        pthread_t hilo;
-        pthread_create(&hilo, NULL, vehiculoThread, v); // Crea e inicia hilo del vehiculo
-        pthread_detach(hilo);  // Para terminar el hilo correctamente
+        lanzar_vehiculo(vehiculoThread, v);  // Crea e inicia el hilo del vehículo
         
         vehiculosGenerados++;
         
@@ -413,18 +295,18 @@ int main() {
         }*/
         
         // Esperar tiempo calculado para mantener tasa de 500/hora en tiempo simulado
-        usleep(55000 + (rand() % 10001)); // 0.055 - 0.065 segundos para generar vehiculo
+        usleep(55000 + (rand_r(&semillaLlegadas) % 10001)); // 0.055 - 0.065 segundos para generar vehiculo
 
     }
     
     printf("✅ GENERACIÓN DE VEHÍCULOS COMPLETADA\n");
     printf("⏳ Esperando que terminen los vehículos en circulación...\n");
     
-    // Esperar a que terminen los vehículos (tiempo adicional para que terminen)
-    sleep(10);
+    esperar_vehiculos_en_curso();
     
     mostrar_estadisticas();
     limpiar_recursos();
+    terminar_banco();
     
     printf("🎯 SIMULACIÓN COMPLETADA EXITOSAMENTE\n");
     printf("⏱️  Tiempo real de ejecución: %.0f segundos\n", difftime(time(NULL), inicioSimulacion));
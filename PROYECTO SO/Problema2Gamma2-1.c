@@ -5,8 +5,18 @@
 #include <unistd.h>
 #include <time.h>
 
+#include "banco.h"
+#include "vehiculos_en_curso.h"
+
+#ifndef VEHICULOS_POR_HORA
 #define VEHICULOS_POR_HORA 500
+#endif
+#ifndef HORAS_SIMULACION
 #define HORAS_SIMULACION 24
+#endif
+#ifndef UNIDAD_SUBTRAMO_US
+#define UNIDAD_SUBTRAMO_US 40000  // us por unidad de tiempo de subtramo
+#endif
 #define TOTAL_VEHICULOS (VEHICULOS_POR_HORA * HORAS_SIMULACION)
 #define SEGUNDOS_POR_HORA_SIMULACION 30
 #define TOTAL_SEGUNDOS_SIMULACION (SEGUNDOS_POR_HORA_SIMULACION * HORAS_SIMULACION)
@@ -20,6 +30,7 @@ typedef struct {
     vehicleType tipo; // Auto o camion
     Direccion dir;    //Direccion de conducion
     time_t horaEntrada;
+    unsigned int semillaViaje; // Sorteos de su recorrido
 } Vehiculo;
 
 typedef struct {
@@ -266,10 +277,10 @@ void* vehiculoThread(void* arg)
         int siguiente = i + paso;
         
         // Simular tiempo en el subtramo actual
-        int tiempo_subtramo = (rand() % 2) + 1; // Random: 1 , 2 (viaje lento, viaje rapido)
+        int tiempo_subtramo = (rand_r(&v->semillaViaje) % 2) + 1; // Random: 1 , 2 (viaje lento, viaje rapido)
         printf(" Vehículo %d CIRCULANDO en subtramo %d (%d segundos)\n", 
                v->id, i + 1, tiempo_subtramo);
-        usleep(tiempo_subtramo*40000); // 0.04 / 0.08 segundos
+        usleep(tiempo_subtramo * UNIDAD_SUBTRAMO_US); // 0.04 / 0.08 segundos por defecto
         
         if (siguiente == fin + paso) //(Ultimo subtramo)
         {
@@ -325,6 +336,7 @@ void* vehiculoThread(void* arg)
         
         // ENTRADA AL SIGUIENTE SUBTRAMO 
         time_t inicio_espera = time(NULL);
+        long inicioPaso = usegundos_ahora();
         int en_hombrillo = 0;
         
         // Intentar entrar al siguiente subtramo
@@ -419,11 +431,14 @@ void* vehiculoThread(void* arg)
         
         // Actualizar estadísticas del siguiente subtramo
         estadisticasSubtramos[siguiente][v->dir]++;
+        if (en_hombrillo)
+            anotar_espera(inicioPaso);
         printf(" Vehículo %d ENTRÓ al subtramo %d\n", v->id, siguiente + 1);
     }
     
     printf(" Vehículo %d terminó su recorrido\n", v->id);
     free(v); // Libera memoria de vehiculo
+    vehiculo_terminado();
     return NULL; // Finaliza el hilo asociado
 }
 
@@ -486,7 +501,7 @@ void limpiar_recursos()
 }
 
 int main() {
-    srand(time(NULL)); // Para variar resultados
+    configurar_banco(); // SEMILLA o la hora, y el fichero de ESPERAS
     inicioSimulacion = time(NULL);
     inicializar_recursos();
 
@@ -510,26 +525,26 @@ int main() {
         
         Vehiculo* v = malloc(sizeof(Vehiculo));
         v->id = vehiculosGenerados + 1;
-        v->tipo = (rand() % 4 == 0) ? CAMION : AUTO; // 75% autos, 25% camiones
-        v->dir = (rand() % 2) ? DIR_1A4 : DIR_4A1;   // direccion fifty fifty 
+        v->tipo = (rand_r(&semillaLlegadas) % 4 == 0) ? CAMION : AUTO; // 75% autos, 25% camiones
+        v->dir = (rand_r(&semillaLlegadas) % 2) ? DIR_1A4 : DIR_4A1;   // direccion fifty fifty 
         v->horaEntrada = time(NULL);                 // Hora de creacion del vehiculo
+        v->semillaViaje = rand_r(&semillaLlegadas);
         
-        pthread_t hilo;
-        pthread_create(&hilo, NULL, vehiculoThread, v);// Crea e inicia hilo del vehiculo
-        pthread_detach(hilo); // Separa el hilo (Para que el hilo finalice correctamente)
+        lanzar_vehiculo(vehiculoThread, v);  // Crea e inicia el hilo del vehículo
         
         vehiculosGenerados++;
-        usleep(55000 + (rand() % 10001)); //Genera un vehiculo cada 0.055 - 0.065 segundos
+        usleep(55000 + (rand_r(&semillaLlegadas) % 10001)); //Genera un vehiculo cada 0.055 - 0.065 segundos
                                           //Para mantener tasa de 500 vehiculos per hora
     }
     
     printf(" GENERACIÓN DE VEHÍCULOS COMPLETADA\n");
     printf(" Esperando que terminen los vehículos en circulación...\n");
     
-    sleep(20); //Tiempo extra para que la simulacion termine
+    esperar_vehiculos_en_curso();
     
     mostrar_estadisticas();
     limpiar_recursos();
+    terminar_banco();
     
     printf(" SIMULACIÓN COMPLETADA EXITOSAMENTE\n");
     printf("  Tiempo real de ejecución: %.0f segundos\n", difftime(time(NULL), inicioSimulacion));
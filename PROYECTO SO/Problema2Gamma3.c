@@ -5,8 +5,18 @@
 #include <unistd.h>
 #include <time.h>
 
+#include "banco.h"
+#include "vehiculos_en_curso.h"
+
+#ifndef VEHICULOS_POR_HORA
 #define VEHICULOS_POR_HORA 500
+#endif
+#ifndef HORAS_SIMULACION
 #define HORAS_SIMULACION 24
+#endif
+#ifndef UNIDAD_SUBTRAMO_US
+#define UNIDAD_SUBTRAMO_US 35000  // us por unidad de tiempo de subtramo
+#endif
 #define TOTAL_VEHICULOS (VEHICULOS_POR_HORA * HORAS_SIMULACION)
 #define SEGUNDOS_POR_HORA_SIMULACION 30
 #define TOTAL_SEGUNDOS_SIMULACION (SEGUNDOS_POR_HORA_SIMULACION * HORAS_SIMULACION)
@@ -20,6 +30,7 @@ typedef struct {
     vehicleType tipo;
     Direccion dir;
     time_t horaEntrada;
+    unsigned int semillaViaje; // Sorteos de su recorrido
 } Vehiculo;
 
 typedef struct {
@@ -247,10 +258,10 @@ void* vehiculoThread(void* arg) {
         }
         
         // Simular tiempo en el subtramo actual
-        int tiempo_subtramo = (rand() % 2) + 1;
+        int tiempo_subtramo = (rand_r(&v->semillaViaje) % 2) + 1;
         printf("🚗 Vehículo %d CIRCULANDO en subtramo %d (%d segundos)\n", 
                v->id, i + 1, tiempo_subtramo);
-        usleep(tiempo_subtramo * 35000);
+        usleep(tiempo_subtramo * UNIDAD_SUBTRAMO_US);
         
         // Salir del subtramo actual
         if (i == 1) {
@@ -284,6 +295,7 @@ void* vehiculoThread(void* arg) {
         
         // *** ENTRADA AL SIGUIENTE SUBTRAMO - VERSIÓN CORREGIDA ***
         time_t inicio_espera = time(NULL);
+        long inicioPaso = usegundos_ahora();
         int en_hombrillo = 0;
         
         if (siguiente == 1) {
@@ -364,11 +376,14 @@ void* vehiculoThread(void* arg) {
         }
         
         estadisticasSubtramos[siguiente][v->dir]++;
+        if (en_hombrillo)
+            anotar_espera(inicioPaso);
         printf("➡️  Vehículo %d ENTRÓ al subtramo %d\n", v->id, siguiente + 1);
     }
     
     printf("🏁 Vehículo %d terminó su recorrido\n", v->id);
     free(v);
+    vehiculo_terminado();
     return NULL;
 }
 
@@ -427,7 +442,7 @@ void limpiar_recursos() {
 }
 
 int main() {
-    srand(time(NULL));
+    configurar_banco(); // SEMILLA o la hora, y el fichero de ESPERAS
     inicioSimulacion = time(NULL);
     inicializar_recursos();
 
@@ -448,25 +463,25 @@ int main() {
         
         Vehiculo* v = malloc(sizeof(Vehiculo));
         v->id = vehiculosGenerados + 1;
-        v->tipo = (rand() % 4 == 0) ? CAMION : AUTO;
-        v->dir = (rand() % 2) ? DIR_1A4 : DIR_4A1;
+        v->tipo = (rand_r(&semillaLlegadas) % 4 == 0) ? CAMION : AUTO;
+        v->dir = (rand_r(&semillaLlegadas) % 2) ? DIR_1A4 : DIR_4A1;
         v->horaEntrada = time(NULL);
+        v->semillaViaje = rand_r(&semillaLlegadas);
         
-        pthread_t hilo;
-        pthread_create(&hilo, NULL, vehiculoThread, v);
-        pthread_detach(hilo);
+        lanzar_vehiculo(vehiculoThread, v);  // Crea e inicia el hilo del vehículo
         
         vehiculosGenerados++;
-        usleep(55000 + (rand() % 10001));
+        usleep(55000 + (rand_r(&semillaLlegadas) % 10001));
     }
     
     printf("✅ GENERACIÓN DE VEHÍCULOS COMPLETADA\n");
     printf("⏳ Esperando que terminen los vehículos en circulación...\n");
     
-    sleep(10);
+    esperar_vehiculos_en_curso();
     
     mostrar_estadisticas();
     limpiar_recursos();
+    terminar_banco();
     
     printf("🎯 SIMULACIÓN COMPLETADA EXITOSAMENTE\n");
     printf("⏱️  Tiempo real de ejecución: %.0f segundos\n", difftime(time(NULL), inicioSimulacion));
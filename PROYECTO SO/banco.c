@@ -0,0 +1,40 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "banco.h"
+
+unsigned int semillaLlegadas;
+FILE* ficheroEsperas = NULL;
+
+void configurar_banco()
+{
+    const char* semilla = getenv("SEMILLA");
+    semillaLlegadas = semilla != NULL ? (unsigned int)strtoul(semilla, NULL, 10) : (unsigned int)time(NULL);
+    const char* esperas = getenv("ESPERAS");
+    if (esperas != NULL && (ficheroEsperas = fopen(esperas, "w")) == NULL) {
+        perror(esperas);
+        exit(1);
+    }
+}
+
+long usegundos_ahora()
+{
+    struct timespec ahora;
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    return ahora.tv_sec * 1000000L + ahora.tv_nsec / 1000;
+}
+
+void anotar_espera(long desde)
+{
+    if (ficheroEsperas != NULL)
+        fprintf(ficheroEsperas, "%ld\n", usegundos_ahora() - desde);
+}
+
+void terminar_banco()
+{
+    if (ficheroEsperas != NULL) {
+        fclose(ficheroEsperas);
+        ficheroEsperas = NULL;
+    }
+}
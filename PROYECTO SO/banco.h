@@ -0,0 +1,30 @@
+// Enganche de las variantes (Problema2*.c) con el banco de pruebas
+// ab_variantes (simulador/programas/ab_variantes.c)
+//
+// Con SEMILLA en el entorno las llegadas y los recorridos salen de esa
+// semilla y no de la hora, así que todas las variantes ven el mismo día.
+// Con ESPERAS cada vehículo que para en un hombrillo anota en ese fichero
+// los microsegundos que tardó en entrar al subtramo siguiente. Se compila
+// junto a la variante:
+//   gcc -O2 -pthread Problema2Gamma.c banco.c vehiculos_en_curso.c -o Problema2Gamma
+#ifndef BANCO_H
+#define BANCO_H
+
+#include <stdio.h>
+
+extern unsigned int semillaLlegadas;
+extern FILE* ficheroEsperas;
+
+// SEMILLA o la hora, y el fichero de ESPERAS. Al principio de main
+void configurar_banco();
+
+// Reloj monotónico en microsegundos
+long usegundos_ahora();
+
+// Espera de un vehículo que paró en un hombrillo, desde usegundos_ahora()
+void anotar_espera(long desde);
+
+// Cierra el fichero de ESPERAS, si lo hay
+void terminar_banco();
+
+#endif
@@ -5,6 +5,8 @@
 #include <unistd.h>
 #include <time.h>
 
+#include "vehiculos_en_curso.h"
+
 #define VEHICULOS_POR_HORA 500
 #define HORAS_SIMULACION 24
 #define TOTAL_VEHICULOS (VEHICULOS_POR_HORA * HORAS_SIMULACION)
@@ -302,6 +304,7 @@ void* vehiculoThread(void* arg)
     
     printf("🏁 Vehículo %d terminó su recorrido\n", v->id);
     free(v);
+    vehiculo_terminado();
     return NULL;
 }
 
@@ -388,9 +391,7 @@ int main() {
         v->dir = (rand() % 2) ? DIR_1A4 : DIR_4A1;
         v->horaEntrada = time(NULL);
         
-        pthread_t hilo;
-        pthread_create(&hilo, NULL, vehiculoThread, v);
-        pthread_detach(hilo);
+        lanzar_vehiculo(vehiculoThread, v);  // Crea e inicia el hilo del vehículo
         
         vehiculosGenerados++;
         
@@ -406,8 +407,7 @@ int main() {
     printf("✅ GENERACIÓN DE VEHÍCULOS COMPLETADA\n");
     printf("⏳ Esperando que terminen los vehículos en circulación...\n");
     
-    // Esperar a que terminen los vehículos (simulación simplificada)
-    sleep(30);
+    esperar_vehiculos_en_curso();
     
     mostrar_estadisticas();
     limpiar_recursos();
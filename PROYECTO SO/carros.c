@@ -5,14 +5,14 @@
 #include <unistd.h>
 #include <time.h>
 
+#include "espera_fifo.h"
+#include "vehiculos_en_curso.h"
+
 #define VEHICULOS_POR_HORA 500
 #define HORAS_SIMULACION 24
 #define TOTAL_VEHICULOS (VEHICULOS_POR_HORA * HORAS_SIMULACION)
 
 // Estructuras de datos
-typedef enum { AUTO, CAMION } vehicleType;
-typedef enum { DIR_1A4, DIR_4A1 } Direccion;
-
 typedef struct {
     int id;              // Identificación del vehículo
     vehicleType tipo;
@@ -20,28 +20,10 @@ typedef struct {
     time_t horaEntrada;  // Hora de creación del vehículo
 } Vehiculo;
 
-typedef struct {
-    sem_t semaforo;
-    int capacidad;
-    int vehiculosPresentes;
-    int contadorAutos;
-    int contadorCamiones;
-    pthread_mutex_t mutex;
-} Subtramo;
-
-typedef struct {
-    sem_t semaforo;
-    int vehiculosEsperando;
-    int maxEspera;
-    time_t tiempoMaxEspera;
-    time_t tiempoTotalEspera;
-    int totalVehiculosEsperado;
-    pthread_mutex_t mutex;
-} Hombrillo;
-
 // Variables globales
 Subtramo subtramos[4];
 Hombrillo hombrillos[3];
+int mostrarOcupacion = 0;  // Ocupación de cada subtramo en cada entrada y salida
 
 // Estadísticas
 int estadisticasHorarias[24][2] = {0}; // [hora][direccion] - 0:DIR_1A4, 1:DIR_4A1
@@ -53,18 +35,10 @@ pthread_mutex_t statsMutex = PTHREAD_MUTEX_INITIALIZER;
 // Inicialización de recursos
 void inicializar_recursos() {
     // Configurar capacidades de subtramos
-    subtramos[0].capacidad = 4;  // Subtramo 1
-    subtramos[1].capacidad = 2;  // Subtramo 2 (2 autos o 1 camion)
-    subtramos[2].capacidad = 1;  // Subtramo 3
-    subtramos[3].capacidad = 3;  // Subtramo 4
-    
-    for (int i = 0; i < 4; i++) {
-        sem_init(&subtramos[i].semaforo, 0, subtramos[i].capacidad);
-        pthread_mutex_init(&subtramos[i].mutex, NULL);
-        subtramos[i].vehiculosPresentes = 0;
-        subtramos[i].contadorAutos = 0;
-        subtramos[i].contadorCamiones = 0;
-    }
+    iniciar_subtramo(0, 4);  // Subtramo 1
+    iniciar_subtramo(1, 2);  // Subtramo 2 (2 autos o 1 camion)
+    iniciar_subtramo(2, 1);  // Subtramo 3
+    iniciar_subtramo(3, 3);  // Subtramo 4
     
     for (int i = 0; i < 3; i++) {
         sem_init(&hombrillos[i].semaforo, 0, 999); // Capacidad ilimitada
@@ -77,22 +51,6 @@ void inicializar_recursos() {
     }
 }
 
-// Función para verificar si puede entrar al subtramo 2
-int puede_entrar_subtramo2(vehicleType tipo) {
-    pthread_mutex_lock(&subtramos[1].mutex);
-    
-    int puede_entrar = 0;
-    if (tipo == AUTO) {
-        puede_entrar = (subtramos[1].contadorAutos < 2);
-    } else { // CAMION
-        puede_entrar = (subtramos[1].contadorCamiones == 0 && 
-                       subtramos[1].contadorAutos == 0);
-    }
-    
-    pthread_mutex_unlock(&subtramos[1].mutex);
-    return puede_entrar;
-}
-
 // Obtener la hora actual de simulación (0-23)
 int obtener_hora_actual() {
     time_t ahora = time(NULL);
@@ -133,20 +91,9 @@ void* vehiculoThread(void* arg) {
     // Actualizar estadísticas horarias
     actualizar_estadisticas_horarias(v->dir);
     
-    // El vehículo comienza en el primer subtramo
+    // El vehículo comienza en el primer subtramo (si está lleno espera turno en la entrada)
     printf("➡️  Vehículo %d entrando DIRECTAMENTE al subtramo %d\n", v->id, inicio + 1);
-    sem_wait(&subtramos[inicio].semaforo);
-    
-    // Actualizar contadores del primer subtramo
-    pthread_mutex_lock(&subtramos[inicio].mutex);
-    subtramos[inicio].vehiculosPresentes++;
-    if (v->tipo == AUTO) {
-        subtramos[inicio].contadorAutos++;
-    } else {
-        subtramos[inicio].contadorCamiones++;
-    }
-    estadisticasSubtramos[inicio][v->dir]++;
-    pthread_mutex_unlock(&subtramos[inicio].mutex);
+    entrar_subtramo(inicio, v->id, v->tipo, v->dir, -1);
     
     // Recorrer todos los subtramos
     for (int i = inicio; i != fin + paso; i += paso) {
@@ -159,16 +106,7 @@ void* vehiculoThread(void* arg) {
         sleep(tiempo_subtramo);
         
         // Salir del subtramo actual
-        pthread_mutex_lock(&subtramos[i].mutex);
-        subtramos[i].vehiculosPresentes--;
-        if (v->tipo == AUTO) {
-            subtramos[i].contadorAutos--;
-        } else {
-            subtramos[i].contadorCamiones--;
-        }
-        pthread_mutex_unlock(&subtramos[i].mutex);
-        
-        sem_post(&subtramos[i].semaforo);
+        salir_subtramo(i, v->tipo);
         printf("✅ Vehículo %d SALIÓ del subtramo %d\n", v->id, i + 1);
         
         // Verificar si es el último subtramo
@@ -185,59 +123,11 @@ void* vehiculoThread(void* arg) {
             hombrillo_idx = i - 1;  // Hombrillo entre i-1 e i
         }
         
-        // VERIFICAR si el SIGUIENTE subtramo está lleno
-        int siguiente_lleno = 0;
-        pthread_mutex_lock(&subtramos[siguiente].mutex);
-        if (subtramos[siguiente].vehiculosPresentes >= subtramos[siguiente].capacidad) {
-            siguiente_lleno = 1;
-        } else if (siguiente == 1) { // Verificación especial para subtramo 2
-            if (!puede_entrar_subtramo2(v->tipo)) {
-                siguiente_lleno = 1;
-            }
-        }
-        pthread_mutex_unlock(&subtramos[siguiente].mutex);
+        // ENTRAR al siguiente subtramo. Si está LLENO el vehículo espera su
+        // turno en el hombrillo y el que libere el sitio se lo cede
+        time_t inicio_espera = time(NULL);
         
-        if (siguiente_lleno) {
-            // IR AL HOMBRILLO a esperar
-            printf("🟡 Vehículo %d → Subtramo %d LLENO, YENDO al hombrillo %d\n", 
-                   v->id, siguiente + 1, hombrillo_idx + 1);
-            
-            time_t inicio_espera = time(NULL);
-            
-            // Entrar al hombrillo
-            pthread_mutex_lock(&hombrillos[hombrillo_idx].mutex);
-            hombrillos[hombrillo_idx].vehiculosEsperando++;
-            if (hombrillos[hombrillo_idx].vehiculosEsperando > hombrillos[hombrillo_idx].maxEspera) {
-                hombrillos[hombrillo_idx].maxEspera = hombrillos[hombrillo_idx].vehiculosEsperando;
-            }
-            pthread_mutex_unlock(&hombrillos[hombrillo_idx].mutex);
-            
-            // Esperar activamente hasta que haya espacio
-            int puede_avanzar = 0;
-            while (!puede_avanzar) {
-                usleep(500000);  // Verificar cada 0.5 segundos
-                
-                pthread_mutex_lock(&subtramos[siguiente].mutex);
-                if (subtramos[siguiente].vehiculosPresentes < subtramos[siguiente].capacidad) {
-                    if (siguiente == 1) { // Subtramo 2
-                        if (v->tipo == AUTO) {
-                            puede_avanzar = (subtramos[1].contadorAutos < 2);
-                        } else {
-                            puede_avanzar = (subtramos[1].contadorCamiones == 0 && 
-                                           subtramos[1].contadorAutos == 0);
-                        }
-                    } else {
-                        puede_avanzar = 1;
-                    }
-                }
-                pthread_mutex_unlock(&subtramos[siguiente].mutex);
-            }
-            
-            // Salir del hombrillo
-            pthread_mutex_lock(&hombrillos[hombrillo_idx].mutex);
-            hombrillos[hombrillo_idx].vehiculosEsperando--;
-            pthread_mutex_unlock(&hombrillos[hombrillo_idx].mutex);
-            
+        if (entrar_subtramo(siguiente, v->id, v->tipo, v->dir, hombrillo_idx)) {
             time_t fin_espera = time(NULL);
             time_t duracion_espera = fin_espera - inicio_espera;
             
@@ -256,24 +146,11 @@ void* vehiculoThread(void* arg) {
             printf("🟢 Vehículo %d → Subtramo %d tiene ESPACIO, AVANZANDO directamente\n", 
                    v->id, siguiente + 1);
         }
-        
-        // ENTRAR al siguiente subtramo
-        printf("➡️  Vehículo %d ENTRANDO al subtramo %d\n", v->id, siguiente + 1);
-        sem_wait(&subtramos[siguiente].semaforo);
-        
-        // Actualizar contadores del subtramo
-        pthread_mutex_lock(&subtramos[siguiente].mutex);
-        subtramos[siguiente].vehiculosPresentes++;
-        if (v->tipo == AUTO) {
-            subtramos[siguiente].contadorAutos++;
-        } else {
-            subtramos[siguiente].contadorCamiones++;
-        }
-        estadisticasSubtramos[siguiente][v->dir]++;
-        pthread_mutex_unlock(&subtramos[siguiente].mutex);
+        printf("➡️  Vehículo %d ENTRÓ al subtramo %d\n", v->id, siguiente + 1);
     }
     
     free(v);
+    vehiculo_terminado();
     return NULL;
 }
 
@@ -315,6 +192,21 @@ void mostrar_estadisticas() {
         printf("  Total vehículos que esperaron: %d\n", hombrillos[i].totalVehiculosEsperado);
     }
     
+    // Despertares de los vehículos que esperaron turno
+    long despertares = 0, traspasos = 0;
+    double latencia = 0;
+    for (int i = 0; i < 4; i++) {
+        despertares += subtramos[i].despertares;
+        traspasos += subtramos[i].traspasos;
+        latencia += subtramos[i].latenciaTraspaso;
+    }
+    printf("\n🔔 ESPERAS DE TURNO (hombrillos y entradas):\n");
+    printf("  Vehículos que esperaron turno: %ld\n", traspasos);
+    if (traspasos > 0) {
+        printf("  Despertares por vehículo admitido: %.2f\n", (double)despertares / traspasos);
+        printf("  Latencia media desde que se cede el sitio: %.1f us\n", latencia / traspasos);
+    }
+    
     printf("\n📦 TOTAL DE VEHÍCULOS EN EL DÍA: %d\n", totalVehiculosDia);
     printf("==========================================\n");
 }
@@ -322,7 +214,6 @@ void mostrar_estadisticas() {
 // Función para limpiar recursos
 void limpiar_recursos() {
     for (int i = 0; i < 4; i++) {
-        sem_destroy(&subtramos[i].semaforo);
         pthread_mutex_destroy(&subtramos[i].mutex);
     }
     
@@ -357,9 +248,7 @@ int main() {
         v->dir = (rand() % 2) ? DIR_1A4 : DIR_4A1;
         v->horaEntrada = time(NULL);
         
-        pthread_t hilo;
-        pthread_create(&hilo, NULL, vehiculoThread, v);
-        pthread_detach(hilo);
+        lanzar_vehiculo(vehiculoThread, v);  // Crea e inicia el hilo del vehículo
         
         vehiculosGenerados++;
         
@@ -375,8 +264,7 @@ int main() {
     printf("✅ GENERACIÓN DE VEHÍCULOS COMPLETADA\n");
     printf("⏳ Esperando que terminen los vehículos en circulación...\n");
     
-    // Esperar a que terminen los vehículos (simulación simplificada)
-    sleep(30);
+    esperar_vehiculos_en_curso();
     
     mostrar_estadisticas();
     limpiar_recursos();
@@ -0,0 +1,157 @@
+#include <stdio.h>
+
+#include "espera_fifo.h"
+
+void iniciar_subtramo(int s, int capacidad)
+{
+    Subtramo* st = &subtramos[s];
+    st->capacidad = capacidad;
+    pthread_mutex_init(&st->mutex, NULL);
+    st->vehiculosPresentes = 0;
+    st->contadorAutos = 0;
+    st->contadorCamiones = 0;
+    for (int d = 0; d < 2; d++) {
+        st->primero[d] = NULL;
+        st->ultimo[d] = NULL;
+    }
+    st->turnos = 0;
+    st->despertares = 0;
+    st->traspasos = 0;
+    st->latenciaTraspaso = 0;
+}
+
+static void mostrar_ocupacion(int s)
+{
+    if (mostrarOcupacion)
+        printf("📊 Subtramo %d - Autos: %d, Camiones: %d, Total: %d\n", 
+               s + 1, subtramos[s].contadorAutos, 
+               subtramos[s].contadorCamiones, subtramos[s].vehiculosPresentes);
+}
+
+// El subtramo 2 admite 2 autos o 1 camión
+int cabe_en_subtramo(int s, vehicleType tipo)
+{
+    if (subtramos[s].vehiculosPresentes >= subtramos[s].capacidad)
+        return 0;
+    if (s == 1) {
+        if (tipo == AUTO)
+            return subtramos[1].contadorCamiones == 0 && subtramos[1].contadorAutos < 2;
+        return subtramos[1].contadorCamiones == 0 && subtramos[1].contadorAutos == 0;
+    }
+    return 1;
+}
+
+void ocupar_subtramo(int s, vehicleType tipo, Direccion dir)
+{
+    subtramos[s].vehiculosPresentes++;
+    if (tipo == AUTO) {
+        subtramos[s].contadorAutos++;
+    } else {
+        subtramos[s].contadorCamiones++;
+    }
+    estadisticasSubtramos[s][dir]++;
+    mostrar_ocupacion(s);
+}
+
+// El sitio libre pasa directamente al primero de la cola (el de menor turno
+// entre las dos direcciones) si cabe, y solo se despierta a ese. Nadie se
+// cuela: si el primero no cabe, los de detrás tampoco entran
+void ceder_sitio(int s)
+{
+    Subtramo* st = &subtramos[s];
+    for (;;) {
+        int d;
+        if (st->primero[0] == NULL && st->primero[1] == NULL)
+            return;
+        if (st->primero[1] == NULL)
+            d = 0;
+        else if (st->primero[0] == NULL)
+            d = 1;
+        else
+            d = (st->primero[0]->turno < st->primero[1]->turno) ? 0 : 1;
+
+        EsperaTurno* e = st->primero[d];
+        if (!cabe_en_subtramo(s, e->tipo))
+            return;
+        st->primero[d] = e->siguiente;
+        if (st->primero[d] == NULL)
+            st->ultimo[d] = NULL;
+
+        ocupar_subtramo(s, e->tipo, e->dir);
+        e->concedido = 1;
+        clock_gettime(CLOCK_MONOTONIC, &e->concedidoEn);
+        pthread_cond_signal(&e->cond);
+    }
+}
+
+int entrar_subtramo(int s, int id, vehicleType tipo, Direccion dir, int hombrillo_idx)
+{
+    Subtramo* st = &subtramos[s];
+    pthread_mutex_lock(&st->mutex);
+    if (st->primero[0] == NULL && st->primero[1] == NULL && cabe_en_subtramo(s, tipo)) {
+        ocupar_subtramo(s, tipo, dir);
+        pthread_mutex_unlock(&st->mutex);
+        return 0;
+    }
+
+    EsperaTurno e;
+    pthread_cond_init(&e.cond, NULL);
+    e.concedido = 0;
+    e.turno = st->turnos++;
+    e.tipo = tipo;
+    e.dir = dir;
+    e.siguiente = NULL;
+    if (st->ultimo[dir] != NULL) {
+        st->ultimo[dir]->siguiente = &e;
+    } else {
+        st->primero[dir] = &e;
+    }
+    st->ultimo[dir] = &e;
+
+    if (hombrillo_idx >= 0) {
+        // IR AL HOMBRILLO a esperar
+        printf("🟡 Vehículo %d → Subtramo %d LLENO, YENDO al hombrillo %d\n", 
+               id, s + 1, hombrillo_idx + 1);
+        pthread_mutex_lock(&hombrillos[hombrillo_idx].mutex);
+        hombrillos[hombrillo_idx].vehiculosEsperando++;
+        if (hombrillos[hombrillo_idx].vehiculosEsperando > hombrillos[hombrillo_idx].maxEspera) {
+            hombrillos[hombrillo_idx].maxEspera = hombrillos[hombrillo_idx].vehiculosEsperando;
+        }
+        pthread_mutex_unlock(&hombrillos[hombrillo_idx].mutex);
+    }
+
+    // Espera pasiva: un solo despertar, cuando el sitio ya es suyo
+    while (!e.concedido) {
+        pthread_cond_wait(&e.cond, &st->mutex);
+        st->despertares++;
+    }
+    struct timespec ahora;
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    st->traspasos++;
+    st->latenciaTraspaso += (ahora.tv_sec - e.concedidoEn.tv_sec) * 1e6 + 
+                            (ahora.tv_nsec - e.concedidoEn.tv_nsec) / 1e3;
+    pthread_mutex_unlock(&st->mutex);
+    pthread_cond_destroy(&e.cond);
+
+    if (hombrillo_idx >= 0) {
+        // Salir del hombrillo
+        pthread_mutex_lock(&hombrillos[hombrillo_idx].mutex);
+        hombrillos[hombrillo_idx].vehiculosEsperando--;
+        pthread_mutex_unlock(&hombrillos[hombrillo_idx].mutex);
+    }
+    return 1;
+}
+
+void salir_subtramo(int s, vehicleType tipo)
+{
+    pthread_mutex_lock(&subtramos[s].mutex);
+    subtramos[s].vehiculosPresentes--;
+    if (tipo == AUTO) {
+        subtramos[s].contadorAutos--;
+    } else {
+        subtramos[s].contadorCamiones--;
+    }
+    mostrar_ocupacion(s);
+    ceder_sitio(s);
+    pthread_mutex_unlock(&subtramos[s].mutex);
+}
@@ -0,0 +1,82 @@
+// Turnos FIFO para entrar a los subtramos, compartidos por
+// Problema2Alpha.c, Problema2Beta.c, camion.c y carros.c
+//
+// Quien no cabe en un subtramo, o llega cuando ya hay cola, se pone a la
+// cola de su dirección (en un hombrillo o en la entrada) y duerme en su
+// propia variable de condición. El que libera sitio lo ocupa por el
+// primero de la cola y lo despierta solo a él: un despertar por vehículo
+// admitido y nadie se cuela.
+//
+// Cada programa define subtramos, hombrillos, estadisticasSubtramos y
+// mostrarOcupacion, y se compila junto a espera_fifo.c:
+//   gcc -O2 -pthread Problema2Alpha.c espera_fifo.c banco.c vehiculos_en_curso.c -o Problema2Alpha
+#ifndef ESPERA_FIFO_H
+#define ESPERA_FIFO_H
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <time.h>
+
+typedef enum { AUTO, CAMION } vehicleType;
+typedef enum { DIR_1A4, DIR_4A1 } Direccion;
+
+// Un vehículo esperando turno para entrar a un subtramo, en un hombrillo o
+// en la entrada. Vive en la pila de su hilo mientras espera
+typedef struct EsperaTurno {
+    pthread_cond_t cond;         // Solo se le despierta cuando ya tiene sitio
+    int concedido;               // Quien liberó el sitio ya lo ocupó por él
+    unsigned long turno;         // Orden de llegada entre las dos colas del subtramo
+    vehicleType tipo;
+    Direccion dir;
+    struct timespec concedidoEn; // Para medir cuánto tarda en seguir
+    struct EsperaTurno* siguiente;
+} EsperaTurno;
+
+typedef struct {
+    int capacidad;
+    int vehiculosPresentes;
+    int contadorAutos;
+    int contadorCamiones;
+    pthread_mutex_t mutex;       // Protege contadores y colas: comprobar y entrar es atómico
+    EsperaTurno* primero[2];     // Cola FIFO por dirección: la de un hombrillo o la de la entrada
+    EsperaTurno* ultimo[2];
+    unsigned long turnos;
+    long despertares;            // Veces que se despertó a un vehículo de la cola
+    long traspasos;              // Vehículos que entraron con el sitio ya cedido
+    double latenciaTraspaso;     // Suma en us desde que se cede el sitio hasta que el vehículo sigue
+} Subtramo;
+
+typedef struct {
+    sem_t semaforo;      // Para la capacidad deseada del hombrillo (Ilimitadas en la practica)
+    int vehiculosEsperando; // Contador actual de vehículos esperando
+    int maxEspera;    // Máximo histórico de vehículos esperando
+    time_t tiempoMaxEspera;  //Tiempo de espera más largo registrado
+    time_t tiempoTotalEspera; //Suma acumulada de todos los tiempos de espera
+    int totalVehiculosEsperado; //Total de vehículos que han esperado
+    pthread_mutex_t mutex;
+} Hombrillo;
+
+// Del programa
+extern Subtramo subtramos[4];
+extern Hombrillo hombrillos[3];
+extern int estadisticasSubtramos[4][2];  // [subtramo][direccion]
+extern int mostrarOcupacion;             // Imprimir la ocupación en cada entrada y salida
+
+// Subtramo vacío, sin cola y con sus contadores a cero
+void iniciar_subtramo(int s, int capacidad);
+
+// Con el mutex del subtramo tomado
+int cabe_en_subtramo(int s, vehicleType tipo);
+void ocupar_subtramo(int s, vehicleType tipo, Direccion dir);
+void ceder_sitio(int s);
+
+// Entrar al subtramo s. Si no cabe, o si ya hay vehículos esperando turno,
+// el vehículo id se pone a la cola de su dirección (en el hombrillo
+// hombrillo_idx, o en la entrada si es -1) y duerme hasta que quien libere
+// el sitio se lo ceda. Devuelve 1 si tuvo que esperar
+int entrar_subtramo(int s, int id, vehicleType tipo, Direccion dir, int hombrillo_idx);
+
+// Salir del subtramo s y ceder el sitio al primero que espere turno
+void salir_subtramo(int s, vehicleType tipo);
+
+#endif
@@ -5,6 +5,8 @@
 #include <unistd.h>
 #include <time.h>
 
+#include "vehiculos_en_curso.h"
+
 #define NUM_SUBTRAMOS 4
 #define MAX_VEHICULOS 2000
 #define HORAS_SIMULACION 24
@@ -168,6 +170,7 @@ void* vehiculo_thread(void* arg) {
     
     printf("Vehículo %d completó su viaje\n", v->id);
     free(v);
+    vehiculo_terminado();
     return NULL;
 }
 
@@ -182,9 +185,7 @@ void* generador_vehiculos(void* arg) {
         v->direccion = (rand() % 2) ? DIR_1A4 : DIR_4A1;
         v->hora_entrada = time(NULL);
         
-        pthread_t hilo;
-        pthread_create(&hilo, NULL, vehiculo_thread, v);
-        pthread_detach(hilo);
+        lanzar_vehiculo(vehiculo_thread, v);  // Crea e inicia el hilo del vehículo
         
         vehiculos_generados++;
         total_vehiculos_dia++;
@@ -224,8 +225,9 @@ int main() {
     pthread_t generador;
     pthread_create(&generador, NULL, generador_vehiculos, NULL);
     
-    // Esperar a que termine la simulación (en realidad debería tener una condición de parada)
-    sleep(HORAS_SIMULACION * 2); // Simulación acelerada
+    // Primero a que se hayan creado todos los vehículos, luego a que salgan
+    pthread_join(generador, NULL);
+    esperar_vehiculos_en_curso();
     
     mostrar_estadisticas();
     
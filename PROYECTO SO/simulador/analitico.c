@@ -0,0 +1,167 @@
+#include <stdio.h>
+#include <math.h>
+
+#include "analitico.h"
+
+#define MAX_ITERACIONES 200
+#define TOLERANCIA 1e-9
+
+// Probabilidad de esperar en una M/M/c con a erlangs de carga (a < c), por
+// la recurrencia de la B de Erlang, que no desborda con c grande
+static double erlang_c(int c, double a)
+{
+    double b = 1;
+    for (int k = 1; k <= c; k++)
+        b = a * b / (k + a * b);
+    return c * b / (c - a * (1 - b));
+}
+
+// Variabilidad de un sentido que se queda con la fracción p de un flujo
+static double separar(double variabilidad, double p)
+{
+    return p * variabilidad + 1 - p;
+}
+
+void estimar_dia(EstimacionDia* e)
+{
+    int n = NUM_SUBTRAMOS;
+
+    // Llegadas: llegadaMin + uniforme en [0, llegadaRango)
+    double rango = (double)USEG_LLEGADA_RANGO;
+    double entreLlegadas = USEG_LLEGADA_MIN + (rango - 1) / 2;
+    double variabilidadEntrada = (rango * rango - 1) / 12 / (entreLlegadas * entreLlegadas);
+    double lambda = 1 / entreLlegadas;  // Por us
+
+    double generables = floor((USEG_TOTAL_SIMULACION - 1) / entreLlegadas) + 1;
+    e->vehiculosDia = generables < TOTAL_VEHICULOS ? generables : TOTAL_VEHICULOS;
+    e->llegadasPorHora = e->vehiculosDia / HORAS_SIMULACION;
+
+    double p[2];
+    p[DIR_4A1] = (double)escenario.sentido4a1.numerador / escenario.sentido4a1.denominador;
+    p[DIR_1A4] = 1 - p[DIR_4A1];
+    double q = (double)escenario.camiones.numerador / escenario.camiones.denominador;
+
+    // Tiempo en un subtramo: 1 o 2 unidades con la misma probabilidad
+    double u = (double)USEG_POR_UNIDAD_SUBTRAMO;
+    double tiempo = 1.5 * u, tiempo2 = 2.5 * u * u;
+
+    double trabajo[MAX_SUBTRAMOS], variabilidadServicio[MAX_SUBTRAMOS], carga[MAX_SUBTRAMOS];
+    e->cuello = 0;
+    e->saturado = 0;
+    for (int i = 0; i < n; i++) {
+        double wa = autopista.peso[i][AUTO], wc = autopista.peso[i][CAMION];
+        double peso = (1 - q) * wa + q * wc;
+        double peso2 = (1 - q) * wa * wa + q * wc * wc;
+        trabajo[i] = tiempo * peso;
+        variabilidadServicio[i] = tiempo2 * peso2 / (trabajo[i] * trabajo[i]) - 1;
+        carga[i] = lambda * trabajo[i];
+        e->utilizacion[i] = carga[i] / autopista.capacidad[i];
+        if (e->utilizacion[i] > e->utilizacion[e->cuello])
+            e->cuello = i;
+    }
+    if (e->utilizacion[e->cuello] >= 1)
+        e->saturado = 1;
+
+    double aguanta = autopista.capacidad[e->cuello] / trabajo[e->cuello] * USEG_POR_HORA;
+    e->salidasPorHora = e->llegadasPorHora < aguanta ? e->llegadasPorHora : aguanta;
+
+    // Variabilidad de las llegadas de cada sentido a cada subtramo, hasta
+    // el punto fijo. Un subtramo saturado sale a su ritmo máximo
+    double llegada[2][MAX_SUBTRAMOS];
+    for (int d = 0; d < 2; d++)
+        for (int i = 0; i < n; i++)
+            llegada[d][i] = 1;
+    for (e->iteraciones = 1; e->iteraciones <= MAX_ITERACIONES; e->iteraciones++) {
+        double cambio = 0;
+        for (int d = 0; d < 2; d++) {
+            double anterior = separar(variabilidadEntrada, p[d]);
+            for (int i = autopista.entrada[d]; i >= 0; i = autopista.siguiente[d][i]) {
+                cambio = fmax(cambio, fabs(llegada[d][i] - anterior));
+                llegada[d][i] = anterior;
+
+                double total = p[DIR_1A4] * llegada[DIR_1A4][i] + p[DIR_4A1] * llegada[DIR_4A1][i];
+                double rho = fmin(e->utilizacion[i], 1);
+                double salida = 1 + (1 - rho * rho) * (total - 1)
+                              + rho * rho * (variabilidadServicio[i] - 1) / sqrt(autopista.capacidad[i]);
+                e->variabilidad[i] = total;
+                anterior = separar(salida, p[d]);
+            }
+        }
+        if (cambio < TOLERANCIA)
+            break;
+    }
+
+    // La variabilidad de intervalos sueltos exagera la de la fila cuanto
+    // más cargado está el subtramo: a la larga los dos sentidos son el
+    // flujo de la entrada retrasado, casi regular. Se mezclan las dos
+    // (método híbrido de Whitt) con el peso de la utilización al cuadrado
+    for (int i = 0; i < n; i++) {
+        double rho = fmin(e->utilizacion[i], 1);
+        e->variabilidad[i] = rho * rho * variabilidadEntrada + (1 - rho * rho) * e->variabilidad[i];
+    }
+
+    for (int i = 0; i < n; i++) {
+        int c = autopista.capacidad[i];
+        if (e->utilizacion[i] >= 1) {
+            e->probEspera[i] = 1;
+            e->espera[i] = -1;
+            continue;
+        }
+        e->probEspera[i] = erlang_c(c, carga[i]);
+        e->espera[i] = (e->variabilidad[i] + variabilidadServicio[i]) / 2 * trabajo[i] / (c - carga[i]);
+    }
+
+    // En el hombrillo entre i y el siguiente esperan los que no caben en
+    // el siguiente; a la entrada del primer subtramo no hay hombrillo
+    double tiempoTotal[MAX_HOMBRILLOS] = {0};
+    for (int h = 0; h < NUM_HOMBRILLOS; h++)
+        e->esperaronHombrillo[h] = 0;
+    for (int d = 0; d < 2; d++) {
+        for (int i = autopista.entrada[d]; autopista.siguiente[d][i] >= 0; i = autopista.siguiente[d][i]) {
+            int h = autopista.hombrillo[d][i], j = autopista.siguiente[d][i];
+            double esperan = e->vehiculosDia * p[d] * e->probEspera[j];
+            e->esperaronHombrillo[h] += esperan;
+            if (e->espera[j] < 0 || tiempoTotal[h] < 0)
+                tiempoTotal[h] = -1;
+            else
+                tiempoTotal[h] += esperan * e->espera[j];
+        }
+    }
+    for (int h = 0; h < NUM_HOMBRILLOS; h++) {
+        if (tiempoTotal[h] < 0)
+            e->esperaHombrillo[h] = -1;
+        else
+            e->esperaHombrillo[h] = e->esperaronHombrillo[h] > 0 ? tiempoTotal[h] / e->esperaronHombrillo[h] : 0;
+    }
+}
+
+void mostrar_estimacion(const EstimacionDia* e)
+{
+    printf("\n🧮 ========== ESTIMACIÓN ANALÍTICA ==========\n");
+    printf("📦 Vehículos en el día: %.0f (%.1f por hora)\n", e->vehiculosDia, e->llegadasPorHora);
+    printf("🏁 Salidas por hora: %.1f  🚧 Cuello de botella: subtramo %d (utilización %.3f)%s\n",
+           e->salidasPorHora, e->cuello + 1, e->utilizacion[e->cuello],
+           e->saturado ? " ⚠️  SATURADO: las esperas crecen todo el día" : "");
+
+    printf("\nSubtramo | Utilización | Variab. llegadas | P(esperar) | Espera media (us)\n");
+    printf("---------|-------------|------------------|------------|------------------\n");
+    for (int i = 0; i < NUM_SUBTRAMOS; i++) {
+        printf("%8d | %11.3f | %16.3f | %10.3f | ", i + 1, e->utilizacion[i], e->variabilidad[i], e->probEspera[i]);
+        if (e->espera[i] < 0)
+            printf("%17s\n", "sin límite");
+        else
+            printf("%17.0f\n", e->espera[i]);
+    }
+
+    printf("\nHombrillo | Esperan en el día | Espera media (us)\n");
+    printf("----------|-------------------|------------------\n");
+    for (int h = 0; h < NUM_HOMBRILLOS; h++) {
+        printf("%5d-%-3d | %17.1f | ", h + 1, h + 2, e->esperaronHombrillo[h]);
+        if (e->esperaHombrillo[h] < 0)
+            printf("%17s\n", "sin límite");
+        else
+            printf("%17.0f\n", e->esperaHombrillo[h]);
+    }
+    printf("(esperan en el día: orientativo, suele salir de más; la espera media es la cifra fiable)\n");
+    printf("(%d iteraciones hasta el punto fijo)\n", e->iteraciones);
+}
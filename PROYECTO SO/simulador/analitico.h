@@ -0,0 +1,47 @@
+// Estimación analítica de un día, sin simularlo
+//
+// Cada subtramo es una estación con tantos servidores como unidades de
+// capacidad, compartida por los dos sentidos: un vehículo ocupa peso
+// unidades durante 1 o 2 unidades de subtramo, y aquí cuenta como un
+// cliente que da peso·tiempo de trabajo a la estación (un camión de peso 2
+// en el subtramo 2 ocupa dos unidades a la vez; se aproxima por el doble de
+// trabajo en una). En los motores el hombrillo no tiene tope y quien espera
+// en él ya ha soltado el subtramo anterior, así que no hay bloqueo: la
+// autopista es una fila de colas GI/G/c recorrida en los dos sentidos.
+//
+// Se resuelve por dos momentos (el QNA de Whitt): la variabilidad de las
+// llegadas a cada subtramo sale de mezclar las salidas de sus vecinos de
+// cada sentido, y como un sentido alimenta al otro se itera hasta que no
+// cambia. La probabilidad de esperar es la C de Erlang y la espera de los
+// que esperan la de Allen y Cunneen. Supone la política "cabe" y un régimen
+// estable; la utilización es exacta (ley de Little), el resto aproximado.
+// Los vehículos que esperan en cada hombrillo salen casi siempre de más, y
+// muy de más en los subtramos poco cargados (hasta 16 veces en estimar
+// --validar): solo sirven para ordenar los hombrillos, no como cifra.
+#ifndef ANALITICO_H
+#define ANALITICO_H
+
+#include "trafico.h"
+
+typedef struct {
+    double vehiculosDia;                        // Los que genera el día
+    double llegadasPorHora;                     // Entre los dos sentidos
+    double salidasPorHora;                      // Las que aguanta el cuello de botella, si no llegan a tanto
+    int cuello;                                 // Subtramo más cargado
+    int saturado;                               // Utilización del cuello >= 1: las esperas crecen todo el día
+
+    double utilizacion[MAX_SUBTRAMOS];          // Fracción media de la capacidad ocupada
+    double variabilidad[MAX_SUBTRAMOS];         // Coeficiente de variación al cuadrado de las llegadas
+    double probEspera[MAX_SUBTRAMOS];           // De no caber al llegar
+    double espera[MAX_SUBTRAMOS];               // Media de los que no caben, en us
+
+    double esperaronHombrillo[MAX_HOMBRILLOS];  // Vehículos del día que esperan en él
+    double esperaHombrillo[MAX_HOMBRILLOS];     // Media de los que esperan, en us
+    int iteraciones;
+} EstimacionDia;
+
+// Con el escenario y la autopista actuales
+void estimar_dia(EstimacionDia* e);
+void mostrar_estimacion(const EstimacionDia* e);
+
+#endif
@@ -0,0 +1,109 @@
+#define _GNU_SOURCE  // sem_clockwait
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <sched.h>
+
+#include "buzon.h"
+
+void buzon_iniciar(Buzon* b, unsigned long capacidad)
+{
+    unsigned long tamano = 2;
+    while (tamano < capacidad)
+        tamano *= 2;
+    b->casillas = malloc(tamano * sizeof(CasillaBuzon));
+    if (b->casillas == NULL) {
+        perror("malloc");
+        exit(1);
+    }
+    for (unsigned long i = 0; i < tamano; i++)
+        b->casillas[i].secuencia = i;
+    b->mascara = tamano - 1;
+    b->escritura = 0;
+    b->lectura = 0;
+    b->dormido = 0;
+    sem_init(&b->despertar, 0, 0);
+}
+
+void buzon_destruir(Buzon* b)
+{
+    sem_destroy(&b->despertar);
+    free(b->casillas);
+    b->casillas = NULL;
+}
+
+void buzon_enviar(Buzon* b, int tipo, void* dato, long long valor)
+{
+    unsigned long pos = __atomic_load_n(&b->escritura, __ATOMIC_RELAXED);
+    CasillaBuzon* c;
+    for (;;) {
+        c = &b->casillas[pos & b->mascara];
+        unsigned long sec = __atomic_load_n(&c->secuencia, __ATOMIC_ACQUIRE);
+        long diferencia = (long)(sec - pos);
+        if (diferencia == 0) {
+            if (__atomic_compare_exchange_n(&b->escritura, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                break;
+            // pos ya trae el valor actual
+        } else if (diferencia < 0) {
+            // Lleno: el consumidor todavía no leyó esta casilla
+            sched_yield();
+            pos = __atomic_load_n(&b->escritura, __ATOMIC_RELAXED);
+        } else {
+            pos = __atomic_load_n(&b->escritura, __ATOMIC_RELAXED);
+        }
+    }
+    c->m.tipo = tipo;
+    c->m.dato = dato;
+    c->m.valor = valor;
+    __atomic_store_n(&c->secuencia, pos + 1, __ATOMIC_RELEASE);
+
+    // Empareja con la barrera de buzon_esperar(): o el consumidor ve el
+    // mensaje antes de dormirse o aquí se ve que está dormido
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&b->dormido, __ATOMIC_RELAXED)
+        && __atomic_exchange_n(&b->dormido, 0, __ATOMIC_ACQ_REL))
+        sem_post(&b->despertar);
+}
+
+int buzon_recibir(Buzon* b, Mensaje* m)
+{
+    CasillaBuzon* c = &b->casillas[b->lectura & b->mascara];
+    if (__atomic_load_n(&c->secuencia, __ATOMIC_ACQUIRE) != b->lectura + 1)
+        return 0;
+    *m = c->m;
+    __atomic_store_n(&c->secuencia, b->lectura + b->mascara + 1, __ATOMIC_RELEASE);
+    b->lectura++;
+    return 1;
+}
+
+static int hay_mensaje(Buzon* b)
+{
+    CasillaBuzon* c = &b->casillas[b->lectura & b->mascara];
+    return __atomic_load_n(&c->secuencia, __ATOMIC_ACQUIRE) == b->lectura + 1;
+}
+
+void buzon_esperar(Buzon* b, const struct timespec* hasta)
+{
+    __atomic_store_n(&b->dormido, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (hay_mensaje(b)) {
+        // Si un productor ya nos vio dormidos hay un sem_post en camino
+        if (!__atomic_exchange_n(&b->dormido, 0, __ATOMIC_ACQ_REL))
+            sem_wait(&b->despertar);
+        return;
+    }
+
+    int r;
+    do {
+        r = hasta ? sem_clockwait(&b->despertar, CLOCK_MONOTONIC, hasta)
+                  : sem_wait(&b->despertar);
+    } while (r == -1 && errno == EINTR);
+
+    if (r == -1) {
+        // Venció el plazo: retirarse, salvo que un productor ya haya hecho el post
+        if (!__atomic_exchange_n(&b->dormido, 0, __ATOMIC_ACQ_REL))
+            sem_wait(&b->despertar);
+    }
+}
@@ -0,0 +1,46 @@
+// Buzón acotado sin bloqueo: varios productores, un consumidor (MPSC)
+//
+// Anillo con un número de secuencia por casilla (estilo Vyukov): un
+// productor reserva casilla con un CAS sobre la posición de escritura y la
+// publica con su número de secuencia; el consumidor la lee sin ningún CAS.
+// El semáforo solo se usa cuando el consumidor está dormido.
+#ifndef BUZON_H
+#define BUZON_H
+
+#include <semaphore.h>
+#include <time.h>
+
+typedef struct {
+    int tipo;
+    void* dato;
+    long long valor;
+} Mensaje;
+
+typedef struct {
+    unsigned long secuencia;
+    Mensaje m;
+} CasillaBuzon;
+
+typedef struct {
+    // Cada posición en su propia línea de caché: escriben hilos distintos
+    unsigned long escritura __attribute__((aligned(64)));
+    unsigned long lectura __attribute__((aligned(64)));
+    int dormido;
+    sem_t despertar;
+    unsigned long mascara;
+    CasillaBuzon* casillas;
+} Buzon;
+
+void buzon_iniciar(Buzon* b, unsigned long capacidad);  // Se redondea a potencia de dos
+void buzon_destruir(Buzon* b);
+
+// Productores. Si el buzón está lleno cede el núcleo hasta que haya sitio
+void buzon_enviar(Buzon* b, int tipo, void* dato, long long valor);
+
+// Consumidor
+int buzon_recibir(Buzon* b, Mensaje* m);  // 1 si había mensaje
+// Duerme hasta que llegue un mensaje o hasta el instante (CLOCK_MONOTONIC)
+// hasta; hasta == NULL espera sin límite
+void buzon_esperar(Buzon* b, const struct timespec* hasta);
+
+#endif
@@ -0,0 +1,213 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "cache_dias.h"
+#include "politica.h"
+#include "motor_des.h"
+
+#define FNV_BASE 0xCBF29CE484222325ULL
+#define FNV_PRIMO 0x100000001B3ULL
+
+static size_t tam_fichero(unsigned long long capacidad)
+{
+    return sizeof(CabeceraCache) + capacidad * sizeof(EntradaCache);
+}
+
+static void proyectar(CacheDias* c)
+{
+    struct stat st;
+    if (fstat(c->fd, &st) < 0) {
+        perror("fstat caché");
+        exit(1);
+    }
+    c->tam = (size_t)st.st_size;
+    c->cab = mmap(NULL, c->tam, PROT_READ | PROT_WRITE, MAP_SHARED, c->fd, 0);
+    if (c->cab == MAP_FAILED) {
+        perror("mmap caché");
+        exit(1);
+    }
+    c->entradas = (EntradaCache*)(c->cab + 1);
+}
+
+// Deja el fichero con una tabla vacía de esa capacidad, ya proyectada.
+// Truncar a 0 primero hace que todo lo que se amplía salga a cero
+static void vaciar(CacheDias* c, unsigned long long capacidad)
+{
+    if (c->cab != NULL)
+        munmap(c->cab, c->tam);
+    if (ftruncate(c->fd, 0) < 0 || ftruncate(c->fd, (off_t)tam_fichero(capacidad)) < 0) {
+        perror("ftruncate caché");
+        exit(1);
+    }
+    proyectar(c);
+    memcpy(c->cab->magia, CACHE_MAGIA, sizeof(c->cab->magia));
+    c->cab->formato = CACHE_FORMATO;
+    c->cab->tamEntrada = sizeof(EntradaCache);
+    c->cab->capacidad = capacidad;
+    c->cab->usadas = 0;
+}
+
+static int formato_valido(const CacheDias* c)
+{
+    return c->tam >= sizeof(CabeceraCache)
+        && memcmp(c->cab->magia, CACHE_MAGIA, sizeof(c->cab->magia)) == 0
+        && c->cab->formato == CACHE_FORMATO
+        && c->cab->tamEntrada == sizeof(EntradaCache)
+        && c->cab->capacidad > 0
+        && c->tam == tam_fichero(c->cab->capacidad);
+}
+
+int abrir_cache(CacheDias* c, const char* fichero)
+{
+    c->fd = open(fichero, O_RDWR | O_CREAT, 0644);
+    if (c->fd < 0) {
+        perror(fichero);
+        return -1;
+    }
+    c->cab = NULL;
+    flock(c->fd, LOCK_EX);
+
+    struct stat st;
+    if (fstat(c->fd, &st) < 0) {
+        perror(fichero);
+        close(c->fd);
+        return -1;
+    }
+    if (st.st_size == 0) {
+        vaciar(c, CACHE_ENTRADAS_INICIALES);
+    } else {
+        proyectar(c);
+        if (!formato_valido(c)) {
+            fprintf(stderr, "%s: no es una caché de esta versión; se empieza de cero\n", fichero);
+            vaciar(c, CACHE_ENTRADAS_INICIALES);
+        }
+    }
+
+    flock(c->fd, LOCK_UN);
+    return 0;
+}
+
+void cerrar_cache(CacheDias* c)
+{
+    munmap(c->cab, c->tam);
+    close(c->fd);
+    c->fd = -1;
+    c->cab = NULL;
+}
+
+void bloquear_cache(CacheDias* c)
+{
+    flock(c->fd, LOCK_EX);
+    struct stat st;
+    if (fstat(c->fd, &st) == 0 && (size_t)st.st_size != c->tam) {
+        munmap(c->cab, c->tam);
+        proyectar(c);
+    }
+}
+
+void soltar_cache(CacheDias* c)
+{
+    flock(c->fd, LOCK_UN);
+}
+
+// Posición de la clave, o de la entrada libre donde iría
+static unsigned long long buscar_sitio(const CacheDias* c, unsigned long long clave)
+{
+    unsigned long long i = clave % c->cab->capacidad;
+    while (c->entradas[i].ocupada && c->entradas[i].clave != clave)
+        i = (i + 1) % c->cab->capacidad;
+    return i;
+}
+
+int buscar_en_cache(const CacheDias* c, unsigned long long clave, Estadisticas* est)
+{
+    const EntradaCache* e = &c->entradas[buscar_sitio(c, clave)];
+    if (!e->ocupada)
+        return 0;
+    *est = e->est;
+    return 1;
+}
+
+// Se copian las entradas fuera, se vacía el fichero al doble y se vuelven
+// a meter; así sigue siendo el mismo fichero (y el mismo flock)
+static void crecer(CacheDias* c)
+{
+    unsigned long long usadas = c->cab->usadas, capacidad = c->cab->capacidad;
+    EntradaCache* copia = malloc(usadas * sizeof(EntradaCache));
+    if (copia == NULL) {
+        perror("malloc");
+        exit(1);
+    }
+    unsigned long long n = 0;
+    for (unsigned long long i = 0; i < capacidad; i++)
+        if (c->entradas[i].ocupada)
+            copia[n++] = c->entradas[i];
+
+    vaciar(c, 2 * capacidad);
+    for (unsigned long long k = 0; k < n; k++)
+        c->entradas[buscar_sitio(c, copia[k].clave)] = copia[k];
+    c->cab->usadas = n;
+    free(copia);
+}
+
+void guardar_en_cache(CacheDias* c, unsigned long long clave, const Estadisticas* est)
+{
+    if (10 * (c->cab->usadas + 1) > 7 * c->cab->capacidad)
+        crecer(c);
+    EntradaCache* e = &c->entradas[buscar_sitio(c, clave)];
+    if (!e->ocupada) {
+        e->clave = clave;
+        e->ocupada = 1;
+        c->cab->usadas++;
+    }
+    e->est = *est;
+}
+
+static unsigned long long mezclar(unsigned long long h, const void* datos, size_t n)
+{
+    const unsigned char* p = datos;
+    for (size_t i = 0; i < n; i++) {
+        h ^= p[i];
+        h *= FNV_PRIMO;
+    }
+    return h;
+}
+
+static unsigned long long mezclar_entero(unsigned long long h, long long x)
+{
+    return mezclar(h, &x, sizeof(x));
+}
+
+// Campo a campo y no la estructura entera, para que el relleno entre
+// campos y los derivados no cuenten
+unsigned long long clave_dia(unsigned int semilla)
+{
+    unsigned long long h = FNV_BASE;
+    h = mezclar_entero(h, VERSION_MOTOR_DES);
+    h = mezclar_entero(h, semilla);
+
+    h = mezclar_entero(h, escenario.vehiculosPorHora);
+    h = mezclar_entero(h, escenario.horas);
+    h = mezclar_entero(h, escenario.segundosPorHora);
+    h = mezclar_entero(h, escenario.camiones.numerador);
+    h = mezclar_entero(h, escenario.camiones.denominador);
+    h = mezclar_entero(h, escenario.sentido4a1.numerador);
+    h = mezclar_entero(h, escenario.sentido4a1.denominador);
+    h = mezclar_entero(h, escenario.llegadaMin);
+    h = mezclar_entero(h, escenario.llegadaRango);
+    h = mezclar_entero(h, escenario.unidadSubtramo);
+
+    h = mezclar_entero(h, autopista.numSubtramos);
+    for (int i = 0; i < autopista.numSubtramos; i++) {
+        h = mezclar_entero(h, autopista.capacidad[i]);
+        h = mezclar_entero(h, autopista.peso[i][AUTO]);
+        h = mezclar_entero(h, autopista.peso[i][CAMION]);
+    }
+    return mezclar(h, politicaAdmision->nombre, strlen(politicaAdmision->nombre));
+}
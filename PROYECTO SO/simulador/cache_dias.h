@@ -0,0 +1,63 @@
+// Caché en disco de días simulados con el motor des
+//
+// Un fichero proyectado en memoria con una tabla hash de direccionamiento
+// abierto. Cada entrada guarda las Estadisticas de un día bajo una clave de
+// 64 bits (FNV-1a) que resume el escenario, la autopista, la política, la
+// semilla y VERSION_MOTOR_DES: si cambia cualquiera sale otra clave, así
+// que nunca hay que invalidar nada a mano. La tabla dobla su tamaño al
+// pasar del 70% de ocupación.
+//
+// Varios procesos pueden compartir el fichero: las consultas y las tandas
+// de escrituras van entre bloquear_cache() y soltar_cache() (flock), y
+// bloquear_cache() vuelve a proyectarlo si otro proceso lo hizo crecer.
+// Es una caché: si el fichero no tiene el formato de esta versión se
+// empieza de cero.
+#ifndef CACHE_DIAS_H
+#define CACHE_DIAS_H
+
+#include <stddef.h>
+
+#include "trafico.h"
+
+#define CACHE_MAGIA "DIASDES\n"
+#define CACHE_FORMATO 1
+#define CACHE_ENTRADAS_INICIALES 1024
+
+typedef struct {
+    char magia[8];
+    unsigned int formato;
+    unsigned int tamEntrada;        // sizeof(EntradaCache): cambia si cambia Estadisticas
+    unsigned long long capacidad;   // Entradas de la tabla
+    unsigned long long usadas;
+} CabeceraCache;
+
+typedef struct {
+    unsigned long long clave;
+    int ocupada;
+    Estadisticas est;
+} EntradaCache;
+
+typedef struct {
+    int fd;
+    size_t tam;                     // Bytes proyectados
+    CabeceraCache* cab;
+    EntradaCache* entradas;
+} CacheDias;
+
+// -1 (tras explicar el error en stderr) si no se puede abrir o crear
+int abrir_cache(CacheDias* c, const char* fichero);
+void cerrar_cache(CacheDias* c);
+
+void bloquear_cache(CacheDias* c);
+void soltar_cache(CacheDias* c);
+
+// Con la caché bloqueada. buscar_en_cache() devuelve 1 y copia el día en
+// est si estaba
+int buscar_en_cache(const CacheDias* c, unsigned long long clave, Estadisticas* est);
+void guardar_en_cache(CacheDias* c, unsigned long long clave, const Estadisticas* est);
+
+// Clave del día con esta semilla en el escenario, la autopista y la
+// política actuales
+unsigned long long clave_dia(unsigned int semilla);
+
+#endif
@@ -0,0 +1,66 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "cola_eventos.h"
+
+static int evento_antes(const Evento* a, const Evento* b)
+{
+    if (a->tiempo != b->tiempo)
+        return a->tiempo < b->tiempo;
+    return a->secuencia < b->secuencia;
+}
+
+void programar_evento(ListaEventos* l, tiempo_us tiempo, int tipo, void* dato)
+{
+    if (l->cantidad == l->capacidad) {
+        l->capacidad = l->capacidad ? l->capacidad * 2 : 1024;
+        l->eventos = realloc(l->eventos, l->capacidad * sizeof(Evento));
+        if (l->eventos == NULL) {
+            perror("realloc");
+            exit(1);
+        }
+    }
+
+    // Flotar el nuevo evento hasta su posición
+    Evento e = { tiempo, l->secuencia++, tipo, dato };
+    int i = l->cantidad++;
+    while (i > 0) {
+        int padre = (i - 1) / 2;
+        if (!evento_antes(&e, &l->eventos[padre]))
+            break;
+        l->eventos[i] = l->eventos[padre];
+        i = padre;
+    }
+    l->eventos[i] = e;
+}
+
+// Saca el evento más próximo (la lista no debe estar vacía)
+Evento extraer_evento(ListaEventos* l)
+{
+    Evento primero = l->eventos[0];
+    Evento ultimo = l->eventos[--l->cantidad];
+
+    // Hundir el último elemento desde la raíz
+    int i = 0;
+    for (;;) {
+        int hijo = 2 * i + 1;
+        if (hijo >= l->cantidad)
+            break;
+        if (hijo + 1 < l->cantidad && evento_antes(&l->eventos[hijo + 1], &l->eventos[hijo]))
+            hijo++;
+        if (!evento_antes(&l->eventos[hijo], &ultimo))
+            break;
+        l->eventos[i] = l->eventos[hijo];
+        i = hijo;
+    }
+    if (l->cantidad > 0)
+        l->eventos[i] = ultimo;
+    return primero;
+}
+
+void liberar_lista_eventos(ListaEventos* l)
+{
+    free(l->eventos);
+    l->eventos = NULL;
+    l->cantidad = l->capacidad = 0;
+}
@@ -0,0 +1,25 @@
+// Lista de eventos futuros: montículo binario ordenado por (tiempo, secuencia)
+#ifndef COLA_EVENTOS_H
+#define COLA_EVENTOS_H
+
+#include "trafico.h"
+
+typedef struct {
+    tiempo_us tiempo;
+    unsigned long long secuencia;  // Desempata en orden de programación
+    int tipo;
+    void* dato;
+} Evento;
+
+typedef struct {
+    Evento* eventos;
+    int cantidad;
+    int capacidad;
+    unsigned long long secuencia;
+} ListaEventos;
+
+void programar_evento(ListaEventos* l, tiempo_us tiempo, int tipo, void* dato);
+Evento extraer_evento(ListaEventos* l);
+void liberar_lista_eventos(ListaEventos* l);
+
+#endif
@@ -0,0 +1,126 @@
+// Implementación con el orden de memoria de Lê, Pop, Cohen y Zappa Nardelli
+// ("Correct and Efficient Work-Stealing for Weak Memory Models", 2013)
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "cola_robo.h"
+
+struct ArregloRobo {
+    long tamano;  // Potencia de dos
+    ArregloRobo* sig;
+    void* elementos[];
+};
+
+static ArregloRobo* nuevo_arreglo(long tamano)
+{
+    ArregloRobo* a = malloc(sizeof(ArregloRobo) + tamano * sizeof(void*));
+    if (a == NULL) {
+        perror("malloc");
+        exit(1);
+    }
+    a->tamano = tamano;
+    a->sig = NULL;
+    return a;
+}
+
+static void* leer(ArregloRobo* a, long i)
+{
+    return __atomic_load_n(&a->elementos[i & (a->tamano - 1)], __ATOMIC_RELAXED);
+}
+
+static void escribir(ArregloRobo* a, long i, void* elemento)
+{
+    __atomic_store_n(&a->elementos[i & (a->tamano - 1)], elemento, __ATOMIC_RELAXED);
+}
+
+void cola_robo_iniciar(ColaRobo* c, long capacidadInicial)
+{
+    long tamano = 16;
+    while (tamano < capacidadInicial)
+        tamano *= 2;
+    c->arriba = 0;
+    c->abajo = 0;
+    c->arreglo = nuevo_arreglo(tamano);
+    c->viejos = NULL;
+}
+
+void cola_robo_destruir(ColaRobo* c)
+{
+    free(c->arreglo);
+    while (c->viejos) {
+        ArregloRobo* sig = c->viejos->sig;
+        free(c->viejos);
+        c->viejos = sig;
+    }
+    c->arreglo = NULL;
+}
+
+static ArregloRobo* crecer(ColaRobo* c, ArregloRobo* a, long arriba, long abajo)
+{
+    ArregloRobo* nuevo = nuevo_arreglo(a->tamano * 2);
+    for (long i = arriba; i < abajo; i++)
+        escribir(nuevo, i, leer(a, i));
+    a->sig = c->viejos;
+    c->viejos = a;
+    __atomic_store_n(&c->arreglo, nuevo, __ATOMIC_RELEASE);
+    return nuevo;
+}
+
+void cola_robo_meter(ColaRobo* c, void* elemento)
+{
+    long abajo = __atomic_load_n(&c->abajo, __ATOMIC_RELAXED);
+    long arriba = __atomic_load_n(&c->arriba, __ATOMIC_ACQUIRE);
+    ArregloRobo* a = __atomic_load_n(&c->arreglo, __ATOMIC_RELAXED);
+    if (abajo - arriba > a->tamano - 1)
+        a = crecer(c, a, arriba, abajo);
+    escribir(a, abajo, elemento);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&c->abajo, abajo + 1, __ATOMIC_RELAXED);
+}
+
+void* cola_robo_sacar(ColaRobo* c)
+{
+    long abajo = __atomic_load_n(&c->abajo, __ATOMIC_RELAXED) - 1;
+    ArregloRobo* a = __atomic_load_n(&c->arreglo, __ATOMIC_RELAXED);
+    __atomic_store_n(&c->abajo, abajo, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long arriba = __atomic_load_n(&c->arriba, __ATOMIC_RELAXED);
+
+    if (arriba > abajo) {
+        // Vacía
+        __atomic_store_n(&c->abajo, abajo + 1, __ATOMIC_RELAXED);
+        return ROBO_VACIA;
+    }
+    void* elemento = leer(a, abajo);
+    if (arriba == abajo) {
+        // Último elemento: se compite con los ladrones
+        if (!__atomic_compare_exchange_n(&c->arriba, &arriba, arriba + 1, 0,
+                                         __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+            elemento = ROBO_VACIA;
+        __atomic_store_n(&c->abajo, abajo + 1, __ATOMIC_RELAXED);
+    }
+    return elemento;
+}
+
+void* cola_robo_robar(ColaRobo* c)
+{
+    long arriba = __atomic_load_n(&c->arriba, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long abajo = __atomic_load_n(&c->abajo, __ATOMIC_ACQUIRE);
+    if (arriba >= abajo)
+        return ROBO_VACIA;
+
+    ArregloRobo* a = __atomic_load_n(&c->arreglo, __ATOMIC_ACQUIRE);
+    void* elemento = leer(a, arriba);
+    if (!__atomic_compare_exchange_n(&c->arriba, &arriba, arriba + 1, 0,
+                                     __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+        return ROBO_REINTENTAR;
+    return elemento;
+}
+
+long cola_robo_tamano(ColaRobo* c)
+{
+    long abajo = __atomic_load_n(&c->abajo, __ATOMIC_SEQ_CST);
+    long arriba = __atomic_load_n(&c->arriba, __ATOMIC_SEQ_CST);
+    return (abajo > arriba) ? abajo - arriba : 0;
+}
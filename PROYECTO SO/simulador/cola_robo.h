@@ -0,0 +1,33 @@
+// Cola de doble extremo con robo de trabajo (Chase-Lev)
+//
+// Solo el hilo dueño mete y saca por abajo (LIFO, sin bloqueo en el caso
+// normal); cualquier otro hilo puede robar por arriba (FIFO). El arreglo
+// crece cuando se llena; los arreglos viejos se liberan al destruir la cola
+// porque un ladrón puede estar leyéndolos todavía.
+#ifndef COLA_ROBO_H
+#define COLA_ROBO_H
+
+typedef struct ArregloRobo ArregloRobo;
+
+typedef struct {
+    long arriba;             // Siguiente elemento a robar
+    long abajo;              // Siguiente hueco libre del dueño
+    ArregloRobo* arreglo;
+    ArregloRobo* viejos;     // Arreglos reemplazados al crecer
+} ColaRobo;
+
+#define ROBO_VACIA NULL
+#define ROBO_REINTENTAR ((void*)1)  // Otro hilo ganó la carrera; puede quedar trabajo
+
+void cola_robo_iniciar(ColaRobo* c, long capacidadInicial);
+void cola_robo_destruir(ColaRobo* c);
+
+// Solo el dueño
+void cola_robo_meter(ColaRobo* c, void* elemento);
+void* cola_robo_sacar(ColaRobo* c);  // ROBO_VACIA si no hay nada
+
+// Cualquier hilo
+void* cola_robo_robar(ColaRobo* c);  // ROBO_VACIA, ROBO_REINTENTAR o el elemento
+long cola_robo_tamano(ColaRobo* c);  // Aproximado si hay otros hilos operando
+
+#endif
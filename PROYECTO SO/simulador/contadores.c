@@ -0,0 +1,111 @@
+#include <string.h>
+
+#include "contadores.h"
+
+#define SUMAR(p, n) __atomic_fetch_add((p), (n), __ATOMIC_RELAXED)
+#define LEER(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+
+// Último fragmento que tomó este hilo, y de qué contadores
+static __thread ContadoresRepartidos* duenoFragmento;
+static __thread int indiceFragmento;
+
+static void maximo_int(int* p, int v)
+{
+    int actual = LEER(p);
+    while (v > actual && !__atomic_compare_exchange_n(p, &actual, v, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+}
+
+static void maximo_tiempo(tiempo_us* p, tiempo_us v)
+{
+    tiempo_us actual = LEER(p);
+    while (v > actual && !__atomic_compare_exchange_n(p, &actual, v, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+}
+
+void iniciar_contadores(ContadoresRepartidos* c)
+{
+    memset(c, 0, sizeof(*c));
+}
+
+FragmentoContadores* fragmento_del_hilo(ContadoresRepartidos* c)
+{
+    if (duenoFragmento != c) {
+        duenoFragmento = c;
+        indiceFragmento = SUMAR(&c->siguienteFragmento, 1) % MAX_FRAGMENTOS;
+    }
+    return &c->fragmento[indiceFragmento];
+}
+
+void contar_llegada(FragmentoContadores* f, const Vehiculo* v)
+{
+    SUMAR(&f->horarias[obtener_hora_simulacion(v->horaEntrada)][v->dir], 1);
+    SUMAR(&f->llegadas, 1);
+}
+
+void contar_subtramo(FragmentoContadores* f, int subtramo, Direccion dir)
+{
+    SUMAR(&f->subtramos[subtramo][dir], 1);
+}
+
+void contar_salida_subtramo(FragmentoContadores* f, int subtramo)
+{
+    SUMAR(&f->salidas[subtramo], 1);
+}
+
+void contar_completado(FragmentoContadores* f)
+{
+    SUMAR(&f->completados, 1);
+}
+
+void contar_entrada_hombrillo(ContadoresRepartidos* c, int h)
+{
+    maximo_int(&c->maxEspera[h], SUMAR(&c->esperando[h], 1) + 1);
+}
+
+void contar_salida_hombrillo(ContadoresRepartidos* c, FragmentoContadores* f, int h, tiempo_us espera)
+{
+    SUMAR(&c->esperando[h], -1);
+    maximo_tiempo(&f->tiempoMaxEspera[h], espera);
+    SUMAR(&f->tiempoTotalEspera[h], espera);
+    SUMAR(&f->totalEsperado[h], 1);
+}
+
+void juntar_contadores(const ContadoresRepartidos* c, Estadisticas* est)
+{
+    iniciar_estadisticas(est);
+    for (int k = 0; k < MAX_FRAGMENTOS; k++) {
+        const FragmentoContadores* f = &c->fragmento[k];
+        for (int hora = 0; hora < 24; hora++)
+            for (int d = 0; d < 2; d++)
+                est->estadisticasHorarias[hora][d] += LEER(&f->horarias[hora][d]);
+        for (int i = 0; i < NUM_SUBTRAMOS; i++)
+            for (int d = 0; d < 2; d++)
+                est->estadisticasSubtramos[i][d] += LEER(&f->subtramos[i][d]);
+        for (int h = 0; h < NUM_HOMBRILLOS; h++) {
+            EstadisticaHombrillo* eh = &est->hombrillos[h];
+            tiempo_us maximo = LEER(&f->tiempoMaxEspera[h]);
+            if (maximo > eh->tiempoMaxEspera)
+                eh->tiempoMaxEspera = maximo;
+            eh->tiempoTotalEspera += LEER(&f->tiempoTotalEspera[h]);
+            eh->totalVehiculosEsperado += LEER(&f->totalEsperado[h]);
+        }
+        est->totalVehiculosDia += LEER(&f->llegadas);
+        est->vehiculosCompletados += LEER(&f->completados);
+    }
+    for (int h = 0; h < NUM_HOMBRILLOS; h++) {
+        est->hombrillos[h].vehiculosEsperando = LEER(&c->esperando[h]);
+        est->hombrillos[h].maxEspera = LEER(&c->maxEspera[h]);
+    }
+}
+
+void ocupacion_contadores(const ContadoresRepartidos* c, int ocupacion[MAX_SUBTRAMOS])
+{
+    for (int i = 0; i < NUM_SUBTRAMOS; i++) {
+        ocupacion[i] = 0;
+        for (int k = 0; k < MAX_FRAGMENTOS; k++) {
+            const FragmentoContadores* f = &c->fragmento[k];
+            ocupacion[i] += LEER(&f->subtramos[i][0]) + LEER(&f->subtramos[i][1]) - LEER(&f->salidas[i]);
+        }
+    }
+}
@@ -0,0 +1,61 @@
+// Estadísticas repartidas en fragmentos, sin statsMutex
+//
+// Cada hilo suma en su propio fragmento (alineado a una línea de caché,
+// para que dos hilos no se disputen la misma línea) con incrementos
+// atómicos relajados, que sin competencia no esperan a nadie. Los
+// fragmentos solo se juntan al final o cuando alguien pide una foto con
+// juntar_contadores(). Con más hilos que fragmentos algunos hilos comparten
+// fragmento: los incrementos atómicos siguen siendo correctos.
+//
+// Lo único común es la ocupación actual de cada hombrillo, porque su
+// máximo histórico depende de cuántos hay a la vez en todos los hilos.
+//
+// No tiene punteros: puede vivir en memoria compartida entre procesos.
+#ifndef CONTADORES_H
+#define CONTADORES_H
+
+#include "trafico.h"
+
+#define MAX_FRAGMENTOS 64
+#define LINEA_CACHE 64
+
+typedef struct {
+    int horarias[24][2];                   // Como en Estadisticas
+    int subtramos[MAX_SUBTRAMOS][2];
+    int salidas[MAX_SUBTRAMOS];            // Con subtramos, la ocupación actual
+    tiempo_us tiempoMaxEspera[MAX_HOMBRILLOS];
+    tiempo_us tiempoTotalEspera[MAX_HOMBRILLOS];
+    int totalEsperado[MAX_HOMBRILLOS];
+    int llegadas;
+    int completados;
+} __attribute__((aligned(LINEA_CACHE))) FragmentoContadores;
+
+typedef struct {
+    FragmentoContadores fragmento[MAX_FRAGMENTOS];
+    int esperando[MAX_HOMBRILLOS];
+    int maxEspera[MAX_HOMBRILLOS];
+    int siguienteFragmento;                // Para repartirlos entre los hilos
+} ContadoresRepartidos;
+
+void iniciar_contadores(ContadoresRepartidos* c);
+
+// El fragmento del hilo que llama; se asigna la primera vez, por turnos
+FragmentoContadores* fragmento_del_hilo(ContadoresRepartidos* c);
+
+// Lo mismo que registrar_llegada(), registrar_entrada_hombrillo(), etc.
+void contar_llegada(FragmentoContadores* f, const Vehiculo* v);
+void contar_subtramo(FragmentoContadores* f, int subtramo, Direccion dir);
+void contar_salida_subtramo(FragmentoContadores* f, int subtramo);
+void contar_completado(FragmentoContadores* f);
+void contar_entrada_hombrillo(ContadoresRepartidos* c, int h);
+void contar_salida_hombrillo(ContadoresRepartidos* c, FragmentoContadores* f, int h, tiempo_us espera);
+
+// Suma los fragmentos en est. Se puede llamar con la simulación en marcha
+// (cada contador es exacto, aunque no todos del mismo instante)
+void juntar_contadores(const ContadoresRepartidos* c, Estadisticas* est);
+
+// Vehículos dentro de cada subtramo: entradas menos salidas de todos los
+// fragmentos (vivo.h)
+void ocupacion_contadores(const ContadoresRepartidos* c, int ocupacion[MAX_SUBTRAMOS]);
+
+#endif
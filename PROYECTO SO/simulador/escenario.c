@@ -0,0 +1,209 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "escenario.h"
+#include "politica.h"
+
+#define MAX_LINEA 1024
+
+// Un entero en [min, max] que ocupa todo el texto. -1 si no
+static int leer_entero(const char* texto, long long min, long long max, long long* valor)
+{
+    char* fin;
+    long long n = strtoll(texto, &fin, 10);
+    if (fin == texto || *fin != '\0' || n < min || n > max)
+        return -1;
+    *valor = n;
+    return 0;
+}
+
+// "N/D" con 0 <= N <= D
+static int leer_proporcion(const char* texto, Proporcion* p)
+{
+    char* fin;
+    long num = strtol(texto, &fin, 10);
+    if (fin == texto || *fin != '/')
+        return -1;
+    const char* resto = fin + 1;
+    long den = strtol(resto, &fin, 10);
+    if (fin == resto || *fin != '\0' || den < 1 || den > 1000000 || num < 0 || num > den)
+        return -1;
+    p->numerador = (int)num;
+    p->denominador = (int)den;
+    return 0;
+}
+
+void fijar_escenario()
+{
+    escenario.totalVehiculos = escenario.vehiculosPorHora * escenario.horas;
+    escenario.usegPorHora = escenario.segundosPorHora * USEG_POR_SEGUNDO;
+    escenario.usegTotal = escenario.usegPorHora * escenario.horas;
+}
+
+int aplicar_opcion_escenario(const char* clave, const char* valor)
+{
+    long long n;
+    int ok;
+
+    // Las horas del día van a la tabla de 24 de estadisticasHorarias, y
+    // aleatorio() da 31 bits, así que los rangos no pueden pasar de ahí
+    if (strcmp(clave, "vehiculos-por-hora") == 0) {
+        ok = leer_entero(valor, 1, 10000000, &n) == 0;
+        if (ok)
+            escenario.vehiculosPorHora = (int)n;
+    } else if (strcmp(clave, "horas") == 0) {
+        ok = leer_entero(valor, 1, 24, &n) == 0;
+        if (ok)
+            escenario.horas = (int)n;
+    } else if (strcmp(clave, "segundos-por-hora") == 0) {
+        ok = leer_entero(valor, 1, 1000000, &n) == 0;
+        if (ok)
+            escenario.segundosPorHora = (int)n;
+    } else if (strcmp(clave, "camiones") == 0) {
+        ok = leer_proporcion(valor, &escenario.camiones) == 0;
+    } else if (strcmp(clave, "sentido-4a1") == 0) {
+        ok = leer_proporcion(valor, &escenario.sentido4a1) == 0;
+    } else if (strcmp(clave, "llegada-min-us") == 0) {
+        ok = leer_entero(valor, 0, 1000000000LL, &n) == 0;
+        if (ok)
+            escenario.llegadaMin = n;
+    } else if (strcmp(clave, "llegada-rango-us") == 0) {
+        ok = leer_entero(valor, 1, 1LL << 30, &n) == 0;
+        if (ok)
+            escenario.llegadaRango = n;
+    } else if (strcmp(clave, "unidad-subtramo-us") == 0) {
+        ok = leer_entero(valor, 1, 1000000000LL, &n) == 0;
+        if (ok)
+            escenario.unidadSubtramo = n;
+    } else if (strcmp(clave, "subtramos") == 0) {
+        ok = leer_autopista(valor) == 0;
+    } else if (strcmp(clave, "politica") == 0) {
+        ok = elegir_politica(valor) == 0;
+        if (!ok) {
+            fprintf(stderr, "Políticas de admisión:\n");
+            mostrar_politicas(stderr);
+        }
+    } else {
+        fprintf(stderr, "Opción de escenario desconocida: %s\n", clave);
+        return -1;
+    }
+
+    if (!ok) {
+        fprintf(stderr, "Valor no válido para %s: %s\n", clave, valor);
+        return -1;
+    }
+    fijar_escenario();
+    return 0;
+}
+
+int cargar_escenario(const char* fichero)
+{
+    FILE* f = fopen(fichero, "r");
+    if (f == NULL) {
+        perror(fichero);
+        return -1;
+    }
+
+    char linea[MAX_LINEA];
+    int numLinea = 0;
+    int resultado = 0;
+    while (resultado == 0 && fgets(linea, sizeof(linea), f) != NULL) {
+        numLinea++;
+        char* p = strchr(linea, '#');
+        if (p != NULL)
+            *p = '\0';
+
+        // Sin espacios a los lados de la clave ni del valor
+        char* clave = linea;
+        while (isspace((unsigned char)*clave))
+            clave++;
+        if (*clave == '\0')
+            continue;
+        char* igual = strchr(clave, '=');
+        if (igual == NULL) {
+            fprintf(stderr, "%s:%d: falta '=' en \"%s\"\n", fichero, numLinea, clave);
+            resultado = -1;
+            break;
+        }
+        char* valor = igual + 1;
+        for (p = igual; p > clave && isspace((unsigned char)p[-1]); p--)
+            ;
+        *p = '\0';
+        while (isspace((unsigned char)*valor))
+            valor++;
+        for (p = valor + strlen(valor); p > valor && isspace((unsigned char)p[-1]); p--)
+            ;
+        *p = '\0';
+
+        if (aplicar_opcion_escenario(clave, valor) < 0) {
+            fprintf(stderr, "%s:%d: línea no válida\n", fichero, numLinea);
+            resultado = -1;
+        }
+    }
+
+    fclose(f);
+    return resultado;
+}
+
+// "--clave=valor" con una clave del escenario; deja en *valor el texto tras '='
+static int separar_opcion(const char* arg, char* clave, size_t tam, const char** valor)
+{
+    static const char* claves[] = {
+        "escenario", "vehiculos-por-hora", "horas", "segundos-por-hora",
+        "camiones", "sentido-4a1", "llegada-min-us", "llegada-rango-us",
+        "unidad-subtramo-us", "subtramos", "politica",
+    };
+
+    if (strncmp(arg, "--", 2) != 0)
+        return 0;
+    const char* igual = strchr(arg, '=');
+    if (igual == NULL || (size_t)(igual - arg - 2) >= tam)
+        return 0;
+    memcpy(clave, arg + 2, igual - arg - 2);
+    clave[igual - arg - 2] = '\0';
+    for (size_t i = 0; i < sizeof(claves) / sizeof(claves[0]); i++) {
+        if (strcmp(clave, claves[i]) == 0) {
+            *valor = igual + 1;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int es_opcion_escenario(const char* arg)
+{
+    char clave[32];
+    const char* valor;
+    return separar_opcion(arg, clave, sizeof(clave), &valor);
+}
+
+int leer_argumentos_escenario(int argc, char* argv[])
+{
+    char clave[32];
+    const char* valor;
+
+    // Primero los ficheros, para que las opciones sueltas los corrijan
+    for (int i = 1; i < argc; i++) {
+        if (separar_opcion(argv[i], clave, sizeof(clave), &valor) &&
+            strcmp(clave, "escenario") == 0 && cargar_escenario(valor) < 0)
+            return -1;
+    }
+    for (int i = 1; i < argc; i++) {
+        if (separar_opcion(argv[i], clave, sizeof(clave), &valor) &&
+            strcmp(clave, "escenario") != 0 && aplicar_opcion_escenario(clave, valor) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+void mostrar_escenario()
+{
+    printf("📋 Camiones: %d/%d  Sentido 4→1: %d/%d  Llegadas: %lld+[0,%lld) us  Subtramo: %lld us por unidad  Hora: %d s\n",
+           escenario.camiones.numerador, escenario.camiones.denominador,
+           escenario.sentido4a1.numerador, escenario.sentido4a1.denominador,
+           escenario.llegadaMin, escenario.llegadaRango, escenario.unidadSubtramo,
+           escenario.segundosPorHora);
+    printf("📋 Política de admisión: %s (%s)\n", politicaAdmision->nombre, politicaAdmision->descripcion);
+}
@@ -0,0 +1,35 @@
+// Carga del escenario (trafico.h) desde un fichero y la línea de órdenes
+//
+// Fichero: una opción clave=valor por línea; '#' empieza un comentario.
+// En la línea de órdenes la misma opción va como --clave=valor, y
+// --escenario=FICHERO carga un fichero. Las opciones de la línea de
+// órdenes se aplican después del fichero, estén donde estén. Sin nada se
+// usa el escenario base (escenarios/base.txt):
+//
+//   vehiculos-por-hora=500    horas=24    segundos-por-hora=30
+//   camiones=1/4              sentido-4a1=1/2
+//   llegada-min-us=55000      llegada-rango-us=10001
+//   unidad-subtramo-us=35000  subtramos=4,2/1/2,1,3
+//   politica=cabe
+//
+// subtramos usa el formato de leer_autopista() y politica es una de las
+// de politica.h (cabe, fifo o camiones)
+#ifndef ESCENARIO_H
+#define ESCENARIO_H
+
+#include "trafico.h"
+
+// Cada una devuelve -1 (tras explicar el error en stderr) si algo no vale
+int aplicar_opcion_escenario(const char* clave, const char* valor);
+int cargar_escenario(const char* fichero);
+int leer_argumentos_escenario(int argc, char* argv[]);
+
+// Si el argumento es de los que lee leer_argumentos_escenario()
+int es_opcion_escenario(const char* arg);
+
+// Recalcula los derivados; aplicar_opcion_escenario() ya la llama
+void fijar_escenario();
+
+void mostrar_escenario();
+
+#endif
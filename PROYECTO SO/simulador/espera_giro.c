@@ -0,0 +1,183 @@
+#define _GNU_SOURCE  // syscall
+
+#include <stdio.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include "espera_giro.h"
+
+static int giroMaximo = GIRO_MAX_VUELTAS;
+
+void configurar_giro(int maxVueltas)
+{
+    giroMaximo = maxVueltas > 0 ? maxVueltas : 0;
+}
+
+static void futex_esperar(void* palabra, int privado, int valor)
+{
+    syscall(SYS_futex, palabra, FUTEX_WAIT | privado, valor, NULL, NULL, 0);
+}
+
+static void futex_despertar(void* palabra, int privado, int cuantos)
+{
+    syscall(SYS_futex, palabra, FUTEX_WAKE | privado, cuantos, NULL, NULL, 0);
+}
+
+static inline void relajar_cpu()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ volatile("yield");
+#endif
+}
+
+static void contar(long* contador, long n)
+{
+    __atomic_add_fetch(contador, n, __ATOMIC_RELAXED);
+}
+
+// Gira con espera exponencial hasta que listo() o hasta que se acabe la
+// ventana del sitio, y la ajusta con lo que ha pasado
+static int girar(int* ventana, EstadisticaGiro* est, int (*listo)(void*), void* arg)
+{
+    int actual = __atomic_load_n(ventana, __ATOMIC_RELAXED);
+    int maximo = actual > GIRO_MIN_VUELTAS ? actual : GIRO_MIN_VUELTAS;
+    if (maximo > giroMaximo)
+        maximo = giroMaximo;
+
+    int pausa = 1;
+    for (int vueltas = 1; vueltas <= maximo; vueltas++) {
+        for (int k = 0; k < pausa; k++)
+            relajar_cpu();
+        if (pausa < GIRO_PAUSA_MAX)
+            pausa *= 2;
+        if (listo(arg)) {
+            // Hacia el doble de lo que hizo falta, con un margen
+            int nueva = actual + (2 * vueltas - actual) / 8;
+            __atomic_store_n(ventana, nueva < giroMaximo ? nueva : giroMaximo, __ATOMIC_RELAXED);
+            contar(&est->vueltas, vueltas);
+            contar(&est->enGiro, 1);
+            return 1;
+        }
+    }
+    __atomic_store_n(ventana, actual - actual / 8 - (actual > 0), __ATOMIC_RELAXED);
+    contar(&est->vueltas, maximo);
+    return 0;
+}
+
+void iniciar_semaforo_giro(SemaforoGiro* s, int valor, int compartido)
+{
+    s->valor = valor;
+    s->durmientes = 0;
+    s->ventana = giroMaximo / 2;
+    s->privado = compartido ? 0 : FUTEX_PRIVATE_FLAG;
+    s->est = (EstadisticaGiro){0};
+}
+
+int intentar_semaforo_giro(SemaforoGiro* s)
+{
+    int v = __atomic_load_n(&s->valor, __ATOMIC_SEQ_CST);
+    while (v > 0) {
+        if (__atomic_compare_exchange_n(&s->valor, &v, v - 1, 1, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+            return 1;
+    }
+    return 0;
+}
+
+static int semaforo_libre(void* arg)
+{
+    return intentar_semaforo_giro(arg);
+}
+
+void esperar_semaforo_giro(SemaforoGiro* s)
+{
+    if (intentar_semaforo_giro(s))
+        return;
+    contar(&s->est.esperas, 1);
+    if (girar(&s->ventana, &s->est, semaforo_libre, s))
+        return;
+
+    // Empareja con senalar_semaforo_giro(): o aquí se ve la plaza o allí
+    // se ve que hay alguien aparcado
+    __atomic_add_fetch(&s->durmientes, 1, __ATOMIC_SEQ_CST);
+    while (!intentar_semaforo_giro(s))
+        futex_esperar(&s->valor, s->privado, 0);
+    __atomic_sub_fetch(&s->durmientes, 1, __ATOMIC_RELAXED);
+    contar(&s->est.aparcadas, 1);
+}
+
+void senalar_semaforo_giro(SemaforoGiro* s)
+{
+    __atomic_add_fetch(&s->valor, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&s->durmientes, __ATOMIC_SEQ_CST) > 0)
+        futex_despertar(&s->valor, s->privado, 1);
+}
+
+void iniciar_aviso_giro(AvisoGiro* a, int compartido)
+{
+    a->secuencia = 0;
+    a->durmientes = 0;
+    a->ventana = giroMaximo / 2;
+    a->privado = compartido ? 0 : FUTEX_PRIVATE_FLAG;
+    a->est = (EstadisticaGiro){0};
+}
+
+unsigned int leer_aviso_giro(AvisoGiro* a)
+{
+    return __atomic_load_n(&a->secuencia, __ATOMIC_SEQ_CST);
+}
+
+typedef struct {
+    AvisoGiro* a;
+    unsigned int visto;
+} EsperaAviso;
+
+static int aviso_cambiado(void* arg)
+{
+    EsperaAviso* e = arg;
+    return leer_aviso_giro(e->a) != e->visto;
+}
+
+void esperar_aviso_giro(AvisoGiro* a, unsigned int visto)
+{
+    if (leer_aviso_giro(a) != visto)
+        return;
+    contar(&a->est.esperas, 1);
+    EsperaAviso e = { a, visto };
+    if (girar(&a->ventana, &a->est, aviso_cambiado, &e))
+        return;
+
+    __atomic_add_fetch(&a->durmientes, 1, __ATOMIC_SEQ_CST);
+    while (leer_aviso_giro(a) == visto)
+        futex_esperar(&a->secuencia, a->privado, (int)visto);
+    __atomic_sub_fetch(&a->durmientes, 1, __ATOMIC_RELAXED);
+    contar(&a->est.aparcadas, 1);
+}
+
+void avisar_giro(AvisoGiro* a, int todos)
+{
+    __atomic_add_fetch(&a->secuencia, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&a->durmientes, __ATOMIC_SEQ_CST) > 0)
+        futex_despertar(&a->secuencia, a->privado, todos ? INT_MAX : 1);
+}
+
+void sumar_giro(EstadisticaGiro* total, const EstadisticaGiro* e)
+{
+    total->esperas += e->esperas;
+    total->enGiro += e->enGiro;
+    total->aparcadas += e->aparcadas;
+    total->vueltas += e->vueltas;
+}
+
+void mostrar_giro(const char* sitio, const EstadisticaGiro* e)
+{
+    if (e->esperas == 0) {
+        printf("  %s: sin esperas\n", sitio);
+        return;
+    }
+    printf("  %s: %ld esperas, %.1f%% resueltas girando, %ld aparcadas, %.1f vueltas por espera\n",
+           sitio, e->esperas, 100.0 * e->enGiro / e->esperas, e->aparcadas, (double)e->vueltas / e->esperas);
+}
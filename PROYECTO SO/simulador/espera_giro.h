@@ -0,0 +1,66 @@
+// Esperas que giran un poco antes de dormir
+//
+// Con --acelerar un vehículo recorre un subtramo en décimas de milisegundo,
+// así que dormirse en el núcleo en cada sem_wait o pthread_cond_wait cuesta
+// más que la propia espera. Estas primitivas van sobre un futex: quien no
+// puede pasar gira con espera exponencial (pausas de 1, 2, 4... hasta 64
+// instrucciones pause) durante una ventana de vueltas y solo si se le acaba
+// se aparca con FUTEX_WAIT. La ventana se ajusta sola en cada sitio: crece
+// hacia el doble de las vueltas que hicieron falta cuando girar funciona y
+// encoge cuando se acaba aparcando. Quien libera solo llama al núcleo si hay
+// alguien aparcado.
+//
+// Sirven entre procesos (memoria compartida) con compartido = 1. Cada sitio
+// cuenta cuántas esperas resolvió girando y cuántas aparcó.
+#ifndef ESPERA_GIRO_H
+#define ESPERA_GIRO_H
+
+#define GIRO_MAX_VUELTAS 200    // Ventana máxima por defecto
+#define GIRO_MIN_VUELTAS 4      // Siempre se prueba algo, para que la ventana pueda volver a crecer
+#define GIRO_PAUSA_MAX 64
+
+typedef struct {
+    long esperas;       // Veces que no se pudo pasar a la primera
+    long enGiro;        // De ellas, resueltas girando sin dormir
+    long aparcadas;     // Las que acabaron en FUTEX_WAIT
+    long vueltas;       // Vueltas de giro gastadas en total
+} EstadisticaGiro;
+
+// Semáforo contador (sustituye a sem_t)
+typedef struct {
+    int valor;          // Plazas libres; es la palabra del futex
+    int durmientes;
+    int ventana;        // Vueltas que se giran antes de aparcar
+    int privado;        // FUTEX_PRIVATE_FLAG si no se comparte entre procesos
+    EstadisticaGiro est;
+} SemaforoGiro;
+
+// Aviso para esperas con una condición cualquiera (sustituye a una variable
+// de condición): se lee la secuencia, se comprueba la condición y, si no se
+// cumple, se espera a que la secuencia cambie
+typedef struct {
+    unsigned int secuencia;  // Palabra del futex
+    int durmientes;
+    int ventana;
+    int privado;
+    EstadisticaGiro est;
+} AvisoGiro;
+
+// Tope de la ventana para todos los sitios; 0 = no girar nunca (como
+// sem_wait). Antes de crear ninguna primitiva
+void configurar_giro(int maxVueltas);
+
+void iniciar_semaforo_giro(SemaforoGiro* s, int valor, int compartido);
+int intentar_semaforo_giro(SemaforoGiro* s);  // 1 si cogió plaza, sin esperar
+void esperar_semaforo_giro(SemaforoGiro* s);
+void senalar_semaforo_giro(SemaforoGiro* s);
+
+void iniciar_aviso_giro(AvisoGiro* a, int compartido);
+unsigned int leer_aviso_giro(AvisoGiro* a);
+void esperar_aviso_giro(AvisoGiro* a, unsigned int visto);   // Hasta que la secuencia no sea visto
+void avisar_giro(AvisoGiro* a, int todos);                   // Despierta a uno o a todos los aparcados
+
+void sumar_giro(EstadisticaGiro* total, const EstadisticaGiro* e);
+void mostrar_giro(const char* sitio, const EstadisticaGiro* e);
+
+#endif
@@ -0,0 +1,133 @@
+#include <math.h>
+
+#include "estadistica.h"
+
+void iniciar_acumulador(Acumulador* a)
+{
+    a->n = 0;
+    a->media = 0;
+    a->m2 = 0;
+    a->minimo = 0;
+    a->maximo = 0;
+}
+
+void acumular(Acumulador* a, double x)
+{
+    if (a->n == 0 || x < a->minimo)
+        a->minimo = x;
+    if (a->n == 0 || x > a->maximo)
+        a->maximo = x;
+    a->n++;
+    double delta = x - a->media;
+    a->media += delta / a->n;
+    a->m2 += delta * (x - a->media);
+}
+
+// Chan et al.: une dos acumuladores como si se hubieran visto todas las muestras
+void unir_acumuladores(Acumulador* a, const Acumulador* b)
+{
+    if (b->n == 0)
+        return;
+    if (a->n == 0) {
+        *a = *b;
+        return;
+    }
+    long n = a->n + b->n;
+    double delta = b->media - a->media;
+    a->m2 += b->m2 + delta * delta * a->n * b->n / n;
+    a->media += delta * b->n / n;
+    if (b->minimo < a->minimo)
+        a->minimo = b->minimo;
+    if (b->maximo > a->maximo)
+        a->maximo = b->maximo;
+    a->n = n;
+}
+
+double varianza(const Acumulador* a)
+{
+    return (a->n > 1) ? a->m2 / (a->n - 1) : 0;
+}
+
+double desviacion(const Acumulador* a)
+{
+    return sqrt(varianza(a));
+}
+
+double t_student_95(long gl)
+{
+    static const double tabla[] = {
+        0, 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+    if (gl < 1)
+        return 0;
+    if (gl <= 30)
+        return tabla[gl];
+    if (gl <= 60)
+        return 2.042 - (gl - 30) * (2.042 - 2.000) / 30;
+    if (gl <= 120)
+        return 2.000 - (gl - 60) * (2.000 - 1.980) / 60;
+    return 1.960;
+}
+
+// Fracción continua de la beta incompleta regularizada (Lentz), que
+// converge rápido para x < (a + 1) / (a + b + 2)
+static double fraccion_beta(double a, double b, double x)
+{
+    const double diminuto = 1e-300;
+    double c = 1, d = 1 - (a + b) * x / (a + 1);
+    if (fabs(d) < diminuto)
+        d = diminuto;
+    d = 1 / d;
+    double h = d;
+    for (int m = 1; m <= 300; m++) {
+        double aa = m * (b - m) * x / ((a + 2 * m - 1) * (a + 2 * m));
+        d = 1 + aa * d;
+        d = fabs(d) < diminuto ? 1 / diminuto : 1 / d;
+        c = 1 + aa / c;
+        if (fabs(c) < diminuto)
+            c = diminuto;
+        h *= d * c;
+        aa = -(a + m) * (a + b + m) * x / ((a + 2 * m) * (a + 2 * m + 1));
+        d = 1 + aa * d;
+        d = fabs(d) < diminuto ? 1 / diminuto : 1 / d;
+        c = 1 + aa / c;
+        if (fabs(c) < diminuto)
+            c = diminuto;
+        double delta = d * c;
+        h *= delta;
+        if (fabs(delta - 1) < 1e-12)
+            break;
+    }
+    return h;
+}
+
+// I_x(a, b)
+static double beta_incompleta(double a, double b, double x)
+{
+    if (x <= 0)
+        return 0;
+    if (x >= 1)
+        return 1;
+    double factor = exp(lgamma(a + b) - lgamma(a) - lgamma(b) + a * log(x) + b * log(1 - x));
+    if (x < (a + 1) / (a + b + 2))
+        return factor * fraccion_beta(a, b, x) / a;
+    return 1 - factor * fraccion_beta(b, a, 1 - x) / b;
+}
+
+double p_t_student(double t, long gl)
+{
+    if (gl < 1)
+        return 1;
+    if (isinf(t))
+        return 0;
+    return beta_incompleta(gl / 2.0, 0.5, gl / (gl + t * t));
+}
+
+double semiancho_ic95(const Acumulador* a)
+{
+    if (a->n < 2)
+        return 0;
+    return t_student_95(a->n - 1) * desviacion(a) / sqrt((double)a->n);
+}
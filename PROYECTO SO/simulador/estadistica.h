@@ -0,0 +1,29 @@
+// Estadística de varias muestras (réplicas, repeticiones de un benchmark)
+#ifndef ESTADISTICA_H
+#define ESTADISTICA_H
+
+// Media y varianza acumuladas de una en una (Welford), sin guardar las muestras
+typedef struct {
+    long n;
+    double media;
+    double m2;      // Suma de cuadrados de las desviaciones
+    double minimo;
+    double maximo;
+} Acumulador;
+
+void iniciar_acumulador(Acumulador* a);
+void acumular(Acumulador* a, double x);
+void unir_acumuladores(Acumulador* a, const Acumulador* b);
+double varianza(const Acumulador* a);   // Muestral (n - 1)
+double desviacion(const Acumulador* a);
+
+// Valor crítico de la t de Student a dos colas al 95% con gl grados de libertad
+double t_student_95(long gl);
+
+// p a dos colas de un estadístico t con gl grados de libertad
+double p_t_student(double t, long gl);
+
+// Mitad del intervalo de confianza al 95% de la media: media ± semiancho
+double semiancho_ic95(const Acumulador* a);
+
+#endif
@@ -0,0 +1,630 @@
+// Planificador de fibras M:N
+//
+// Cada fibra tiene su pila reservada junto a su descriptor y sus datos, en
+// una sola reserva que libera el planificador al terminar. Las pilas de una
+// página o más son un mmap con una página PROT_NONE debajo: si la fibra se
+// pasa de pila muere con SIGSEGV en vez de pisar memoria ajena. Las más
+// pequeñas (solo para lanzar cientos de miles de fibras a la vez, donde dos
+// proyecciones por fibra agotarían vm.max_map_count) van en un malloc sin
+// página de guarda. En x86-64 el cambio de contexto es propio y solo guarda
+// los registros que la ABI obliga a preservar (7 palabras en la pila de la
+// fibra); en otras arquitecturas se usa ucontext.
+//
+// Para evitar que otro hilo reanude una fibra que todavía está saliendo de
+// su pila, una fibra que se bloquea no suelta el mutex que protege su cola
+// de espera: lo suelta el planificador cuando ya recuperó el control.
+//
+// Cada hilo tiene su propia cola de fibras listas (ColaRobo) y su propio
+// montículo de fibras dormidas. Una fibra que se despierta desde otra (p.ej.
+// sem_fibra_publicar) va a la cola del hilo que la despertó; un hilo sin
+// trabajo roba de los demás. El mutex global solo se toma para dormir o
+// despertar hilos ociosos y para las fibras creadas fuera de los hilos del
+// planificador.
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+#include "fibras.h"
+#include "cola_eventos.h"
+#include "cola_robo.h"
+#include "metricas.h"
+
+#if defined(__x86_64__)
+#define CAMBIO_PROPIO 1
+#else
+#define CAMBIO_PROPIO 0
+#include <ucontext.h>
+#endif
+
+typedef enum { FIBRA_CEDIDA, FIBRA_DORMIDA, FIBRA_BLOQUEADA, FIBRA_TERMINADA } AccionFibra;
+
+struct Fibra {
+#if CAMBIO_PROPIO
+    void* sp;
+#else
+    ucontext_t contexto;
+#endif
+    void (*funcion)(void*);
+    void* datos;
+    AccionFibra accion;         // Lo que debe hacer el planificador al recuperar el control
+    pthread_mutex_t* liberar;   // Mutex a soltar una vez fuera de la pila de la fibra
+    tiempo_us despertar;
+    Fibra* sig;
+    void* proyeccion;           // Inicio del mmap (con la guarda), NULL si es de malloc
+    size_t tamProyeccion;
+    // Con malloc, los datos y la pila van a continuación del descriptor;
+    // con mmap, la pila va debajo y los datos a continuación
+};
+
+// Estado de cada hilo del planificador
+typedef struct {
+#if CAMBIO_PROPIO
+    void* sp;
+#else
+    ucontext_t contexto;
+#endif
+    Fibra* actual;
+    ColaRobo* cola;         // NULL si el hilo no es del planificador
+    ListaEventos dormidas;  // Fibras que se durmieron en este hilo
+    unsigned int semillaRobo;
+} Planificador;
+
+static __thread Planificador planificadorHilo;
+
+#define LOTE_INYECCION 64   // Fibras que un hilo pasa de la cola global a la suya de una vez
+#define ESPERA_MINIMA_US 50  // Esperas reales más cortas se resuelven cediendo el núcleo
+
+static struct {
+    ColaRobo* colas;        // Una por hilo
+    int numHilos;
+    ColaFibras inyectadas;  // Creadas desde fuera del planificador (con mutex)
+    long pendientes;        // Tamaño de inyectadas, legible sin el mutex
+    int ociosos;            // Hilos durmiendo en cond
+    int buscando;           // Hilos sin trabajo que todavía miran las colas
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    long vivas;
+    long creadas;
+    size_t tamPila;
+    size_t tamPagina;
+    const RelojReal* reloj;
+    void (*prepararHilo)();
+} plan;
+
+#if CAMBIO_PROPIO
+// Guarda los registros preservados en la pila actual, apunta *guardar a
+// ella y continúa en la pila cargar
+void cambiar_contexto_fibra(void** guardar, void* cargar);
+__asm__(
+    ".text\n"
+    ".globl cambiar_contexto_fibra\n"
+    ".hidden cambiar_contexto_fibra\n"
+    ".type cambiar_contexto_fibra, @function\n"
+    "cambiar_contexto_fibra:\n"
+    "    pushq %rbp\n"
+    "    pushq %rbx\n"
+    "    pushq %r12\n"
+    "    pushq %r13\n"
+    "    pushq %r14\n"
+    "    pushq %r15\n"
+    "    movq %rsp, (%rdi)\n"
+    "    movq %rsi, %rsp\n"
+    "    popq %r15\n"
+    "    popq %r14\n"
+    "    popq %r13\n"
+    "    popq %r12\n"
+    "    popq %rbx\n"
+    "    popq %rbp\n"
+    "    ret\n"
+    ".size cambiar_contexto_fibra, .-cambiar_contexto_fibra\n");
+#endif
+
+// Una fibra puede reanudarse en otro hilo: no se debe reutilizar la
+// dirección de la variable __thread calculada antes de un cambio. Con
+// noinline no basta: GCC la marca como const y reutiliza el resultado
+// dentro del llamador; el asm volatile se lo impide
+static __attribute__((noinline)) Planificador* planificador_actual()
+{
+    Planificador* p = &planificadorHilo;
+    __asm__ volatile("" : "+r"(p));
+    return p;
+}
+
+static void encolar_fibra(ColaFibras* c, Fibra* f)
+{
+    f->sig = NULL;
+    if (c->ultimo)
+        c->ultimo->sig = f;
+    else
+        c->primero = f;
+    c->ultimo = f;
+}
+
+static Fibra* desencolar_fibra(ColaFibras* c)
+{
+    Fibra* f = c->primero;
+    if (f) {
+        c->primero = f->sig;
+        if (c->primero == NULL)
+            c->ultimo = NULL;
+    }
+    return f;
+}
+
+// Si hay hilos ociosos y ninguno buscando trabajo, despierta uno para que
+// robe. La barrera empareja con la de dormir_hilo(): o el que se va a
+// dormir ve la fibra nueva o aquí se le ve a él. Si alguien está buscando
+// no hace falta despertar a nadie: mirará las colas otra vez antes de dormir
+static void avisar_ociosos()
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&plan.buscando, __ATOMIC_RELAXED) == 0
+        && __atomic_load_n(&plan.ociosos, __ATOMIC_RELAXED) > 0) {
+        pthread_mutex_lock(&plan.mutex);
+        pthread_cond_signal(&plan.cond);
+        pthread_mutex_unlock(&plan.mutex);
+    }
+}
+
+static void fibra_despertar(Fibra* f)
+{
+    Planificador* p = planificador_actual();
+    if (p->cola) {
+        cola_robo_meter(p->cola, f);
+        avisar_ociosos();
+        return;
+    }
+    pthread_mutex_lock(&plan.mutex);
+    encolar_fibra(&plan.inyectadas, f);
+    __atomic_add_fetch(&plan.pendientes, 1, __ATOMIC_SEQ_CST);
+    pthread_cond_signal(&plan.cond);
+    pthread_mutex_unlock(&plan.mutex);
+}
+
+static void volver_al_planificador(Fibra* f)
+{
+    Planificador* p = planificador_actual();
+#if CAMBIO_PROPIO
+    cambiar_contexto_fibra(&f->sp, p->sp);
+#else
+    swapcontext(&f->contexto, &p->contexto);
+#endif
+}
+
+static void inicio_fibra()
+{
+    Fibra* f = planificador_actual()->actual;
+    f->funcion(f->datos);
+    f->accion = FIBRA_TERMINADA;
+    volver_al_planificador(f);
+}
+
+static Fibra* fibra_actual()
+{
+    return planificador_actual()->actual;
+}
+
+static size_t alinear16(size_t n)
+{
+    return (n + 15) & ~(size_t)15;
+}
+
+void iniciar_fibras(size_t tamPila, const RelojReal* reloj)
+{
+    plan.tamPila = alinear16(tamPila);
+    plan.tamPagina = (size_t)sysconf(_SC_PAGESIZE);
+    plan.reloj = reloj;
+    plan.inyectadas.primero = plan.inyectadas.ultimo = NULL;
+    plan.pendientes = 0;
+    plan.ociosos = 0;
+    plan.buscando = 0;
+    plan.vivas = 0;
+    plan.creadas = 0;
+    plan.prepararHilo = NULL;
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&plan.cond, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_mutex_init(&plan.mutex, NULL);
+}
+
+static size_t redondear_pagina(size_t n)
+{
+    return (n + plan.tamPagina - 1) / plan.tamPagina * plan.tamPagina;
+}
+
+static int lleva_guarda(size_t tamPila)
+{
+    return tamPila >= plan.tamPagina;
+}
+
+size_t memoria_por_fibra(size_t tamDatos)
+{
+    size_t n = alinear16(sizeof(Fibra)) + alinear16(tamDatos) + plan.tamPila;
+    return lleva_guarda(plan.tamPila) ? redondear_pagina(n) + plan.tamPagina : n;
+}
+
+long fibras_creadas()
+{
+    return __atomic_load_n(&plan.creadas, __ATOMIC_RELAXED);
+}
+
+static void sin_pila(const char* que)
+{
+    perror(que);
+    fprintf(stderr, "Cada fibra con página de guarda son dos proyecciones (ver vm.max_map_count);\n"
+                    "para tantas fibras a la vez usa pilas de menos de %zu bytes, que no la llevan\n",
+            plan.tamPagina);
+    exit(1);
+}
+
+void crear_fibra(void (*funcion)(void*), const void* datos, size_t tamDatos, size_t tamPila)
+{
+    tamPila = tamPila ? alinear16(tamPila) : plan.tamPila;
+    size_t cabecera = alinear16(sizeof(Fibra)) + alinear16(tamDatos);
+    Fibra* f;
+    char* pila;
+    if (lleva_guarda(tamPila)) {
+        // [guarda][pila ... ][descriptor][datos]: la pila crece hacia la
+        // guarda y se queda también con lo que sobre al redondear
+        size_t tam = redondear_pagina(tamPila + cabecera) + plan.tamPagina;
+        char* base = mmap(NULL, tam, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+        if (base == MAP_FAILED)
+            sin_pila("mmap (pila de fibra)");
+        if (mprotect(base, plan.tamPagina, PROT_NONE) < 0)
+            sin_pila("mprotect (guarda de la pila)");
+        f = (Fibra*)(base + tam - cabecera);
+        f->proyeccion = base;
+        f->tamProyeccion = tam;
+        pila = base + plan.tamPagina;
+        tamPila = (char*)f - pila;
+    } else {
+        f = malloc(cabecera + tamPila);
+        if (f == NULL) {
+            perror("malloc");
+            exit(1);
+        }
+        f->proyeccion = NULL;
+        pila = (char*)f + cabecera;
+    }
+    f->funcion = funcion;
+    f->datos = (char*)f + alinear16(sizeof(Fibra));
+    memcpy(f->datos, datos, tamDatos);
+    f->liberar = NULL;
+
+#if CAMBIO_PROPIO
+    // Preparar la pila para que el primer cambio "retorne" a inicio_fibra
+    // con la alineación de una llamada normal
+    void** sp = (void**)(((uintptr_t)pila + tamPila) & ~(uintptr_t)15);
+    *--sp = NULL;                  // Dirección de retorno de inicio_fibra (nunca se usa)
+    *--sp = (void*)inicio_fibra;
+    for (int i = 0; i < 6; i++)
+        *--sp = NULL;              // rbp, rbx, r12-r15
+    f->sp = sp;
+#else
+    getcontext(&f->contexto);
+    f->contexto.uc_stack.ss_sp = pila;
+    f->contexto.uc_stack.ss_size = tamPila;
+    f->contexto.uc_link = NULL;
+    makecontext(&f->contexto, inicio_fibra, 0);
+#endif
+
+    __atomic_add_fetch(&plan.vivas, 1, __ATOMIC_SEQ_CST);
+    __atomic_add_fetch(&plan.creadas, 1, __ATOMIC_RELAXED);
+    fibra_despertar(f);
+}
+
+static void liberar_fibra(Fibra* f)
+{
+    if (f->proyeccion)
+        munmap(f->proyeccion, f->tamProyeccion);
+    else
+        free(f);
+}
+
+static void ejecutar_fibra(Fibra* f)
+{
+    Planificador* p = planificador_actual();
+    p->actual = f;
+#if CAMBIO_PROPIO
+    cambiar_contexto_fibra(&p->sp, f->sp);
+#else
+    swapcontext(&p->contexto, &f->contexto);
+#endif
+    p->actual = NULL;
+
+    switch (f->accion) {
+    case FIBRA_CEDIDA:
+        fibra_despertar(f);
+        break;
+    case FIBRA_DORMIDA:
+        programar_evento(&p->dormidas, f->despertar, 0, f);
+        break;
+    case FIBRA_BLOQUEADA:
+        if (f->liberar)
+            pthread_mutex_unlock(f->liberar);
+        break;
+    case FIBRA_TERMINADA:
+        liberar_fibra(f);
+        if (__atomic_sub_fetch(&plan.vivas, 1, __ATOMIC_SEQ_CST) == 0) {
+            pthread_mutex_lock(&plan.mutex);
+            pthread_cond_broadcast(&plan.cond);
+            pthread_mutex_unlock(&plan.mutex);
+        }
+        break;
+    }
+}
+
+// Pasa a la cola propia las fibras dormidas cuyo plazo ya venció
+static void despertar_vencidas(Planificador* p)
+{
+    if (p->dormidas.cantidad == 0)
+        return;
+    tiempo_us ahora = tiempo_modelo(plan.reloj);
+    int despertadas = 0;
+    while (p->dormidas.cantidad > 0 && p->dormidas.eventos[0].tiempo <= ahora) {
+        cola_robo_meter(p->cola, extraer_evento(&p->dormidas).dato);
+        despertadas++;
+    }
+    if (despertadas > 1)
+        avisar_ociosos();
+}
+
+// Toma un lote de la cola global; devuelve una fibra y deja el resto en la propia
+static Fibra* tomar_inyectadas(Planificador* p)
+{
+    if (__atomic_load_n(&plan.pendientes, __ATOMIC_RELAXED) == 0)
+        return NULL;
+    pthread_mutex_lock(&plan.mutex);
+    Fibra* primera = desencolar_fibra(&plan.inyectadas);
+    int tomadas = primera ? 1 : 0;
+    Fibra* f;
+    while (tomadas < LOTE_INYECCION && (f = desencolar_fibra(&plan.inyectadas)) != NULL) {
+        cola_robo_meter(p->cola, f);
+        tomadas++;
+    }
+    __atomic_sub_fetch(&plan.pendientes, tomadas, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&plan.mutex);
+    if (tomadas > 1)
+        avisar_ociosos();
+    return primera;
+}
+
+static Fibra* robar_fibra(Planificador* p)
+{
+    int n = plan.numHilos;
+    if (n < 2)
+        return NULL;
+    int reintentar;
+    do {
+        reintentar = 0;
+        int inicio = (int)(rand_r(&p->semillaRobo) % (unsigned int)n);
+        for (int k = 0; k < n; k++) {
+            ColaRobo* victima = &plan.colas[(inicio + k) % n];
+            if (victima == p->cola)
+                continue;
+            void* f = cola_robo_robar(victima);
+            if (f == ROBO_REINTENTAR)
+                reintentar = 1;
+            else if (f != ROBO_VACIA)
+                return f;
+        }
+    } while (reintentar);
+    return NULL;
+}
+
+static Fibra* buscar_fibra(Planificador* p)
+{
+    Fibra* f = cola_robo_sacar(p->cola);
+    if (f)
+        return f;
+    __atomic_add_fetch(&plan.buscando, 1, __ATOMIC_SEQ_CST);
+    f = tomar_inyectadas(p);
+    if (f == NULL)
+        f = robar_fibra(p);
+    if (f)
+        __atomic_sub_fetch(&plan.buscando, 1, __ATOMIC_SEQ_CST);
+    return f;
+}
+
+static int hay_trabajo_visible()
+{
+    if (__atomic_load_n(&plan.pendientes, __ATOMIC_SEQ_CST) > 0)
+        return 1;
+    for (int i = 0; i < plan.numHilos; i++)
+        if (cola_robo_tamano(&plan.colas[i]) > 0)
+            return 1;
+    return 0;
+}
+
+// Duerme el hilo hasta que haya trabajo o venza su primera fibra dormida.
+// Se llama después de un buscar_fibra() sin éxito, que dejó buscando contado
+static void dormir_hilo(Planificador* p)
+{
+    pthread_mutex_lock(&plan.mutex);
+    __atomic_add_fetch(&plan.ociosos, 1, __ATOMIC_SEQ_CST);
+    __atomic_sub_fetch(&plan.buscando, 1, __ATOMIC_SEQ_CST);
+    if (!hay_trabajo_visible() && __atomic_load_n(&plan.vivas, __ATOMIC_SEQ_CST) > 0) {
+        if (p->dormidas.cantidad > 0) {
+            tiempo_us falta = (p->dormidas.eventos[0].tiempo - tiempo_modelo(plan.reloj)) / plan.reloj->aceleracion;
+            if (falta < ESPERA_MINIMA_US) {
+                // Más corto que la holgura de los temporizadores del núcleo
+                pthread_mutex_unlock(&plan.mutex);
+                sched_yield();
+                pthread_mutex_lock(&plan.mutex);
+            } else {
+                struct timespec ts = instante_real(plan.reloj, p->dormidas.eventos[0].tiempo);
+                pthread_cond_timedwait(&plan.cond, &plan.mutex, &ts);
+            }
+        } else {
+            pthread_cond_wait(&plan.cond, &plan.mutex);
+        }
+    }
+    __atomic_sub_fetch(&plan.ociosos, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&plan.mutex);
+}
+
+static void* trabajador_fibras(void* arg)
+{
+    int indice = (int)(intptr_t)arg;
+    Planificador* p = planificador_actual();
+    p->cola = &plan.colas[indice];
+    p->semillaRobo = (unsigned int)indice * 2654435761u + 1;
+    if (plan.prepararHilo)
+        plan.prepararHilo();
+
+    for (;;) {
+        despertar_vencidas(p);
+        Fibra* f = buscar_fibra(p);
+        if (f) {
+            ejecutar_fibra(f);
+            continue;
+        }
+        if (__atomic_load_n(&plan.vivas, __ATOMIC_SEQ_CST) == 0) {
+            __atomic_sub_fetch(&plan.buscando, 1, __ATOMIC_SEQ_CST);
+            break;
+        }
+        dormir_hilo(p);
+    }
+
+    liberar_lista_eventos(&p->dormidas);
+    p->cola = NULL;
+    return NULL;
+}
+
+void preparar_hilos_fibras(void (*preparar)())
+{
+    plan.prepararHilo = preparar;
+}
+
+void ejecutar_fibras(int numHilos)
+{
+    if (numHilos <= 0)
+        numHilos = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (numHilos <= 0)
+        numHilos = 1;
+
+    plan.numHilos = numHilos;
+    plan.colas = malloc(numHilos * sizeof(ColaRobo));
+    for (int i = 0; i < numHilos; i++)
+        cola_robo_iniciar(&plan.colas[i], 64);
+
+    // El hilo que llama es el trabajador 0
+    pthread_t* hilos = malloc(numHilos * sizeof(pthread_t));
+    for (int i = 1; i < numHilos; i++)
+        crear_hilo(&hilos[i], trabajador_fibras, (void*)(intptr_t)i);
+    trabajador_fibras((void*)(intptr_t)0);
+    for (int i = 1; i < numHilos; i++)
+        pthread_join(hilos[i], NULL);
+    free(hilos);
+
+    for (int i = 0; i < numHilos; i++)
+        cola_robo_destruir(&plan.colas[i]);
+    free(plan.colas);
+    plan.colas = NULL;
+    plan.numHilos = 0;
+    pthread_mutex_destroy(&plan.mutex);
+    pthread_cond_destroy(&plan.cond);
+}
+
+void fibra_ceder()
+{
+    Fibra* f = fibra_actual();
+    f->accion = FIBRA_CEDIDA;
+    volver_al_planificador(f);
+}
+
+void fibra_dormir(tiempo_us duracion)
+{
+    Fibra* f = fibra_actual();
+    f->despertar = tiempo_modelo(plan.reloj) + duracion;
+    f->accion = FIBRA_DORMIDA;
+    volver_al_planificador(f);
+}
+
+// Saca la fibra actual de ejecución; el planificador soltará liberar
+static void fibra_bloquear(pthread_mutex_t* liberar)
+{
+    Fibra* f = fibra_actual();
+    f->accion = FIBRA_BLOQUEADA;
+    f->liberar = liberar;
+    volver_al_planificador(f);
+}
+
+void sem_fibra_iniciar(SemaforoFibra* s, int valor)
+{
+    pthread_mutex_init(&s->mutex, NULL);
+    s->valor = valor;
+    s->espera.primero = s->espera.ultimo = NULL;
+}
+
+void sem_fibra_destruir(SemaforoFibra* s)
+{
+    pthread_mutex_destroy(&s->mutex);
+}
+
+void sem_fibra_esperar(SemaforoFibra* s)
+{
+    pthread_mutex_lock(&s->mutex);
+    if (s->valor > 0) {
+        s->valor--;
+        pthread_mutex_unlock(&s->mutex);
+        return;
+    }
+    // sem_fibra_publicar() nos entrega la unidad directamente al despertarnos
+    encolar_fibra(&s->espera, fibra_actual());
+    fibra_bloquear(&s->mutex);
+}
+
+int sem_fibra_intentar(SemaforoFibra* s)
+{
+    pthread_mutex_lock(&s->mutex);
+    int tomado = (s->valor > 0);
+    if (tomado)
+        s->valor--;
+    pthread_mutex_unlock(&s->mutex);
+    return tomado;
+}
+
+void sem_fibra_publicar(SemaforoFibra* s)
+{
+    pthread_mutex_lock(&s->mutex);
+    Fibra* f = desencolar_fibra(&s->espera);
+    if (f == NULL)
+        s->valor++;
+    pthread_mutex_unlock(&s->mutex);
+    if (f)
+        fibra_despertar(f);
+}
+
+void cond_fibra_iniciar(CondFibra* c)
+{
+    c->espera.primero = c->espera.ultimo = NULL;
+}
+
+void cond_fibra_esperar(CondFibra* c, pthread_mutex_t* mutex)
+{
+    encolar_fibra(&c->espera, fibra_actual());
+    fibra_bloquear(mutex);
+    pthread_mutex_lock(mutex);
+}
+
+void cond_fibra_senal(CondFibra* c)
+{
+    Fibra* f = desencolar_fibra(&c->espera);
+    if (f)
+        fibra_despertar(f);
+}
+
+void cond_fibra_difundir(CondFibra* c)
+{
+    Fibra* f;
+    while ((f = desencolar_fibra(&c->espera)) != NULL)
+        fibra_despertar(f);
+}
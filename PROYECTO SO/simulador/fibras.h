@@ -0,0 +1,66 @@
+// Fibras (corrutinas con pila propia) repartidas entre unos pocos hilos
+//
+// Una fibra que espera un SemaforoFibra, una CondFibra o que duerme no
+// bloquea su hilo: cede el control al planificador, que ejecuta otra fibra.
+#ifndef FIBRAS_H
+#define FIBRAS_H
+
+#include <pthread.h>
+#include <stddef.h>
+
+#include "trafico.h"
+#include "reloj.h"
+
+typedef struct Fibra Fibra;
+
+typedef struct {
+    Fibra* primero;
+    Fibra* ultimo;
+} ColaFibras;
+
+// Equivalente a sem_t para fibras
+typedef struct {
+    pthread_mutex_t mutex;
+    int valor;
+    ColaFibras espera;
+} SemaforoFibra;
+
+// Equivalente a pthread_cond_t para fibras; se usa con un pthread_mutex_t
+// normal, que protege también la cola de espera
+typedef struct {
+    ColaFibras espera;
+} CondFibra;
+
+// Planificador
+//
+// crear_fibra copia tamDatos bytes de datos junto a la pila de la fibra (se
+// liberan con ella) y funcion recibe esa copia. tamPila = 0 usa la pila por
+// defecto. Las pilas de una página o más llevan debajo una página de
+// guarda; las más pequeñas no, y con 1-2 KB la fibra no debe llamar a
+// malloc/free/printf: solo free() ya gasta unos 3 KB de pila.
+void iniciar_fibras(size_t tamPila, const RelojReal* reloj);
+void crear_fibra(void (*funcion)(void*), const void* datos, size_t tamDatos, size_t tamPila);
+void ejecutar_fibras(int numHilos);  // Vuelve cuando ya no quedan fibras
+// Si se fija, cada hilo del planificador la llama al arrancar, antes de
+// ejecutar ninguna fibra (p.ej. para reservar lo que sea por hilo fuera de
+// las pilas pequeñas)
+void preparar_hilos_fibras(void (*preparar)());
+long fibras_creadas();
+size_t memoria_por_fibra(size_t tamDatos);  // Descriptor + datos + pila por defecto
+
+// Desde dentro de una fibra
+void fibra_ceder();
+void fibra_dormir(tiempo_us duracion);  // En tiempo del modelo
+
+void sem_fibra_iniciar(SemaforoFibra* s, int valor);
+void sem_fibra_destruir(SemaforoFibra* s);
+void sem_fibra_esperar(SemaforoFibra* s);
+int sem_fibra_intentar(SemaforoFibra* s);  // Como sem_trywait: 1 si lo tomó
+void sem_fibra_publicar(SemaforoFibra* s);
+
+void cond_fibra_iniciar(CondFibra* c);
+void cond_fibra_esperar(CondFibra* c, pthread_mutex_t* mutex);
+void cond_fibra_senal(CondFibra* c);      // Con el mutex tomado
+void cond_fibra_difundir(CondFibra* c);   // Con el mutex tomado
+
+#endif
@@ -0,0 +1,76 @@
+#define _DEFAULT_SOURCE  // timeradd
+#include <stdio.h>
+#include <sys/time.h>
+
+#include "metricas.h"
+
+static long contadorHilos = 0;
+
+int crear_hilo(pthread_t* hilo, void* (*funcion)(void*), void* arg)
+{
+    __atomic_add_fetch(&contadorHilos, 1, __ATOMIC_RELAXED);
+    return pthread_create(hilo, NULL, funcion, arg);
+}
+
+long hilos_creados()
+{
+    return __atomic_load_n(&contadorHilos, __ATOMIC_RELAXED);
+}
+
+void sumar_hilos_creados(long n)
+{
+    __atomic_add_fetch(&contadorHilos, n, __ATOMIC_RELAXED);
+}
+
+static double segundos_timeval(struct timeval tv)
+{
+    return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+// Uso del proceso más el de sus hijos ya recogidos con wait()
+static void uso_total(struct rusage* uso)
+{
+    struct rusage hijos;
+    getrusage(RUSAGE_SELF, uso);
+    getrusage(RUSAGE_CHILDREN, &hijos);
+    timeradd(&uso->ru_utime, &hijos.ru_utime, &uso->ru_utime);
+    timeradd(&uso->ru_stime, &hijos.ru_stime, &uso->ru_stime);
+    uso->ru_nvcsw += hijos.ru_nvcsw;
+    uso->ru_nivcsw += hijos.ru_nivcsw;
+    if (hijos.ru_maxrss > uso->ru_maxrss)
+        uso->ru_maxrss = hijos.ru_maxrss;
+}
+
+void iniciar_metricas(MetricasEjecucion* m)
+{
+    clock_gettime(CLOCK_MONOTONIC, &m->inicio);
+    uso_total(&m->usoInicio);
+    m->hilosCreados = hilos_creados();
+}
+
+void terminar_metricas(MetricasEjecucion* m)
+{
+    struct timespec fin;
+    struct rusage uso;
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    uso_total(&uso);
+
+    m->segundos = (fin.tv_sec - m->inicio.tv_sec) + (fin.tv_nsec - m->inicio.tv_nsec) / 1e9;
+    m->segundosCPU = segundos_timeval(uso.ru_utime) + segundos_timeval(uso.ru_stime)
+                   - segundos_timeval(m->usoInicio.ru_utime) - segundos_timeval(m->usoInicio.ru_stime);
+    m->maxRssKB = uso.ru_maxrss;  // Máximo del proceso (o del mayor hijo), no solo de este tramo
+    m->cambiosVoluntarios = uso.ru_nvcsw - m->usoInicio.ru_nvcsw;
+    m->cambiosInvoluntarios = uso.ru_nivcsw - m->usoInicio.ru_nivcsw;
+    m->hilosCreados = hilos_creados() - m->hilosCreados;
+}
+
+void mostrar_metricas(const MetricasEjecucion* m)
+{
+    printf("\n⚙️  MÉTRICAS DE EJECUCIÓN:\n");
+    printf("  Tiempo real: %.3f segundos\n", m->segundos);
+    printf("  Tiempo de CPU: %.3f segundos\n", m->segundosCPU);
+    printf("  Hilos creados: %ld\n", m->hilosCreados);
+    printf("  Memoria residente máxima: %ld KB\n", m->maxRssKB);
+    printf("  Cambios de contexto: %ld voluntarios, %ld involuntarios\n",
+           m->cambiosVoluntarios, m->cambiosInvoluntarios);
+}
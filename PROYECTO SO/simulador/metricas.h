@@ -0,0 +1,31 @@
+// Métricas de ejecución del proceso (no del modelo): hilos creados,
+// memoria residente máxima y cambios de contexto. Incluyen a los procesos
+// hijos que ya terminaron
+#ifndef METRICAS_H
+#define METRICAS_H
+
+#include <pthread.h>
+#include <sys/resource.h>
+#include <time.h>
+
+typedef struct {
+    struct timespec inicio;
+    struct rusage usoInicio;
+    double segundos;
+    double segundosCPU;
+    long maxRssKB;
+    long cambiosVoluntarios;
+    long cambiosInvoluntarios;
+    long hilosCreados;
+} MetricasEjecucion;
+
+// Envoltura de pthread_create que lleva la cuenta de hilos creados
+int crear_hilo(pthread_t* hilo, void* (*funcion)(void*), void* arg);
+long hilos_creados();
+void sumar_hilos_creados(long n);  // Hilos que crearon los procesos hijos
+
+void iniciar_metricas(MetricasEjecucion* m);
+void terminar_metricas(MetricasEjecucion* m);
+void mostrar_metricas(const MetricasEjecucion* m);
+
+#endif
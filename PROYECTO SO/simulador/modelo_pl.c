@@ -0,0 +1,252 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "modelo_pl.h"
+#include "politica.h"
+
+int comparar_eventos_pl(const EventoPL* a, const EventoPL* b)
+{
+    if (a->tiempo != b->tiempo)
+        return (a->tiempo < b->tiempo) ? -1 : 1;
+    if (a->profundidad != b->profundidad)
+        return (a->profundidad < b->profundidad) ? -1 : 1;
+    if (a->id != b->id)
+        return (a->id < b->id) ? -1 : 1;
+    if (a->contador != b->contador)
+        return (a->contador < b->contador) ? -1 : 1;
+    return 0;
+}
+
+static void intercambiar(EventoPL* a, EventoPL* b)
+{
+    EventoPL t = *a;
+    *a = *b;
+    *b = t;
+}
+
+void meter_evento_pl(MonticuloPL* m, const EventoPL* ev)
+{
+    if (m->cantidad == m->capacidad) {
+        m->capacidad = m->capacidad ? m->capacidad * 2 : 256;
+        m->eventos = realloc(m->eventos, m->capacidad * sizeof(EventoPL));
+        if (m->eventos == NULL) {
+            perror("realloc");
+            exit(1);
+        }
+    }
+    int i = m->cantidad++;
+    m->eventos[i] = *ev;
+    while (i > 0) {
+        int padre = (i - 1) / 2;
+        if (comparar_eventos_pl(&m->eventos[i], &m->eventos[padre]) >= 0)
+            break;
+        intercambiar(&m->eventos[i], &m->eventos[padre]);
+        i = padre;
+    }
+}
+
+EventoPL sacar_evento_pl(MonticuloPL* m)
+{
+    EventoPL primero = m->eventos[0];
+    m->eventos[0] = m->eventos[--m->cantidad];
+    int i = 0;
+    for (;;) {
+        int menor = i;
+        int izq = 2 * i + 1, der = 2 * i + 2;
+        if (izq < m->cantidad && comparar_eventos_pl(&m->eventos[izq], &m->eventos[menor]) < 0)
+            menor = izq;
+        if (der < m->cantidad && comparar_eventos_pl(&m->eventos[der], &m->eventos[menor]) < 0)
+            menor = der;
+        if (menor == i)
+            break;
+        intercambiar(&m->eventos[i], &m->eventos[menor]);
+        i = menor;
+    }
+    return primero;
+}
+
+void liberar_monticulo_pl(MonticuloPL* m)
+{
+    free(m->eventos);
+    m->eventos = NULL;
+    m->cantidad = m->capacidad = 0;
+}
+
+void iniciar_estado_pl(EstadoPL* e, int indice)
+{
+    memset(e, 0, sizeof(EstadoPL));
+    if (indice < NUM_SUBTRAMOS) {
+        EstadoSubtramo subtramos[MAX_SUBTRAMOS];
+        inicializar_subtramos(subtramos);
+        e->subtramo = subtramos[indice];
+    }
+}
+
+void copiar_estado_pl(EstadoPL* dst, const EstadoPL* src)
+{
+    *dst = *src;
+    dst->capEspera = src->numEspera;
+    dst->espera = NULL;
+    if (src->numEspera > 0) {
+        dst->espera = malloc(src->numEspera * sizeof(VehiculoPL));
+        if (dst->espera == NULL) {
+            perror("malloc");
+            exit(1);
+        }
+        memcpy(dst->espera, src->espera, src->numEspera * sizeof(VehiculoPL));
+    }
+}
+
+void liberar_estado_pl(EstadoPL* e)
+{
+    free(e->espera);
+    e->espera = NULL;
+    e->numEspera = e->capEspera = 0;
+}
+
+static void encolar_espera(EstadoPL* e, const VehiculoPL* veh)
+{
+    if (e->numEspera == e->capEspera) {
+        e->capEspera = e->capEspera ? e->capEspera * 2 : 4;
+        e->espera = realloc(e->espera, e->capEspera * sizeof(VehiculoPL));
+        if (e->espera == NULL) {
+            perror("realloc");
+            exit(1);
+        }
+    }
+    e->espera[e->numEspera++] = *veh;
+    e->esperandoPorTipo[veh->v.tipo]++;
+}
+
+static void nuevo_evento(EventoPL* ev, const EventoPL* causa, int destino, int tipo,
+                         tiempo_us tiempo, VehiculoPL* veh, long long valor)
+{
+    ev->tiempo = tiempo;
+    ev->profundidad = (tiempo == causa->tiempo) ? causa->profundidad + 1 : 0;
+    ev->id = veh->v.id;
+    ev->contador = ++veh->contador;
+    ev->tipo = tipo;
+    ev->destino = destino;
+    ev->valor = valor;
+    ev->veh = *veh;
+}
+
+void llegada_tras_salida(const EventoPL* sale, EventoPL* llegada)
+{
+    VehiculoPL veh = sale->veh;
+    int i = veh.actual;
+    veh.hombrillo = autopista.hombrillo[veh.v.dir][i];
+    veh.actual = autopista.siguiente[veh.v.dir][i];
+    nuevo_evento(llegada, sale, veh.actual, EV_LLEGA, sale->tiempo, &veh, 0);
+}
+
+static void admitir(EstadoPL* e, int indice, const EventoPL* causa, VehiculoPL* veh,
+                    EnviarEventoPL enviar, void* ctx)
+{
+    EventoPL ev;
+    ocupar_subtramo(&e->subtramo, veh->v.tipo);
+    e->porDireccion[veh->v.dir]++;
+    if (veh->esperando) {
+        veh->esperando = 0;
+        nuevo_evento(&ev, causa, PL_HOMBRILLO(veh->hombrillo), EV_SALE_HOMBRILLO, causa->tiempo, veh,
+                     causa->tiempo - veh->inicioEspera);
+        enviar(ctx, &ev);
+    }
+    tiempo_us salida = causa->tiempo + sortear_tiempo_subtramo(&veh->v);
+    nuevo_evento(&ev, causa, indice, EV_SALE, salida, veh, 0);
+    enviar(ctx, &ev);
+}
+
+// Al liberarse espacio se admite, por orden de llegada, a todo el que
+// quepa y deje pasar la política (con la de por defecto un auto puede
+// adelantar a un camión que todavía no cabe en un subtramo con pesos, como
+// con los cond de Gamma2-1 en el subtramo 2)
+static void despertar_cola(EstadoPL* e, int indice, const EventoPL* causa, EnviarEventoPL enviar, void* ctx)
+{
+    int quedan = 0;
+    RecorridoCola r;
+    empezar_recorrido(&r, e->esperandoPorTipo);
+    for (int k = 0; k < e->numEspera; k++) {
+        VehiculoPL w = e->espera[k];
+        if (pasa_en_recorrido(&r, &e->subtramo, w.v.tipo))
+            admitir(e, indice, causa, &w, enviar, ctx);
+        else
+            e->espera[quedan++] = w;
+    }
+    e->numEspera = quedan;
+}
+
+void manejar_evento_pl(EstadoPL* e, int indice, const EventoPL* ev, EnviarEventoPL enviar, void* ctx)
+{
+    VehiculoPL veh = ev->veh;
+    EventoPL nuevo;
+
+    switch (ev->tipo) {
+    case EV_LLEGA:
+        veh.actual = indice;
+        if (admite_llegada(&e->subtramo, veh.v.tipo, e->esperandoPorTipo)) {
+            admitir(e, indice, ev, &veh, enviar, ctx);
+        } else {
+            if (veh.hombrillo >= 0) {
+                veh.esperando = 1;
+                veh.inicioEspera = ev->tiempo;
+                nuevo_evento(&nuevo, ev, PL_HOMBRILLO(veh.hombrillo), EV_ENTRA_HOMBRILLO, ev->tiempo, &veh, 0);
+                enviar(ctx, &nuevo);
+            }
+            encolar_espera(e, &veh);
+        }
+        break;
+
+    case EV_SALE:
+        liberar_subtramo(&e->subtramo, veh.v.tipo);
+        if (autopista.siguiente[veh.v.dir][indice] < 0) {
+            e->completados++;
+        } else {
+            llegada_tras_salida(ev, &nuevo);
+            enviar(ctx, &nuevo);
+        }
+        despertar_cola(e, indice, ev, enviar, ctx);
+        break;
+
+    case EV_ENTRA_HOMBRILLO:
+        registrar_entrada_hombrillo(&e->hombrillo);
+        break;
+
+    case EV_SALE_HOMBRILLO:
+        registrar_salida_hombrillo(&e->hombrillo, ev->valor);
+        break;
+    }
+}
+
+int generar_llegadas_pl(unsigned int semilla, Estadisticas* est,
+                        void (*agregar)(void* ctx, const EventoPL* ev), void* ctx)
+{
+    FlujoAleatorio llegadas;
+    iniciar_flujo(&llegadas, semilla, FLUJO_LLEGADAS);
+    tiempo_us t = 0;
+    int generados = 0;
+    while (generados < TOTAL_VEHICULOS) {
+        EventoPL ev;
+        memset(&ev, 0, sizeof(ev));
+        VehiculoPL* veh = &ev.veh;
+        generar_vehiculo(&veh->v, generados + 1, t, semilla);
+        veh->actual = autopista.entrada[veh->v.dir];
+        veh->hombrillo = -1;
+        if (est)
+            registrar_llegada(est, &veh->v);
+        generados++;
+
+        ev.tiempo = t;
+        ev.id = veh->v.id;
+        ev.tipo = EV_LLEGA;
+        ev.destino = veh->actual;
+        agregar(ctx, &ev);
+
+        tiempo_us proxima = t + sortear_tiempo_llegada(&llegadas);
+        if (proxima >= USEG_TOTAL_SIMULACION)
+            break;
+        t = proxima;
+    }
+    return generados;
+}
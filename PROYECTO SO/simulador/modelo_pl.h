@@ -0,0 +1,89 @@
+// Modelo de la autopista repartido en procesos lógicos (PL)
+//
+// Lo usan el motor de eventos discretos (des), que lo ejecuta en un solo
+// hilo, y los paralelos (timewarp, cmb), que reparten los PL. Cada subtramo
+// y cada hombrillo es un PL con su propio estado; todo lo que pasa entre
+// ellos son eventos. Para que el resultado no dependa de cómo se repartan
+// los PL:
+//   - El estado del vehículo viaja dentro del evento y sus tiempos de
+//     recorrido salen de su propio flujo aleatorio, no de uno compartido.
+//   - Los eventos tienen un orden total (tiempo, profundidad, id del
+//     vehículo, contador del vehículo). La profundidad crece en cada evento
+//     generado en el mismo instante que su causa, así que un evento siempre
+//     va detrás del que lo generó.
+#ifndef MODELO_PL_H
+#define MODELO_PL_H
+
+#include "trafico.h"
+
+#define NUM_PROCESOS_LOGICOS (NUM_SUBTRAMOS + NUM_HOMBRILLOS)
+#define MAX_PROCESOS_LOGICOS (MAX_SUBTRAMOS + MAX_HOMBRILLOS)
+#define PL_HOMBRILLO(h) (NUM_SUBTRAMOS + (h))
+
+typedef enum { EV_LLEGA, EV_SALE, EV_ENTRA_HOMBRILLO, EV_SALE_HOMBRILLO } TipoEventoPL;
+
+typedef struct {
+    Vehiculo v;
+    int actual;
+    int hombrillo;            // Donde espera si no cabe; -1 en la entrada
+    int esperando;
+    tiempo_us inicioEspera;
+    int contador;             // Eventos generados para este vehículo
+} VehiculoPL;
+
+typedef struct {
+    tiempo_us tiempo;
+    int profundidad;
+    int id;
+    int contador;
+    int tipo;
+    int destino;              // PL que lo procesa
+    long long valor;          // Espera en EV_SALE_HOMBRILLO
+    VehiculoPL veh;
+} EventoPL;
+
+// Estado de un PL
+typedef struct {
+    EstadoSubtramo subtramo;
+    int porDireccion[2];
+    int completados;
+    EstadisticaHombrillo hombrillo;
+    VehiculoPL* espera;       // Cola de espera del subtramo, por orden de llegada
+    int numEspera;
+    int capEspera;
+    int esperandoPorTipo[2];  // Los de la cola, para la política de admisión
+} EstadoPL;
+
+// Recibe cada evento que genera manejar_evento_pl()
+typedef void (*EnviarEventoPL)(void* ctx, const EventoPL* ev);
+
+int comparar_eventos_pl(const EventoPL* a, const EventoPL* b);
+
+// Montículo de eventos en ese orden total
+typedef struct {
+    EventoPL* eventos;
+    int cantidad;
+    int capacidad;
+} MonticuloPL;
+
+void meter_evento_pl(MonticuloPL* m, const EventoPL* ev);
+EventoPL sacar_evento_pl(MonticuloPL* m);
+void liberar_monticulo_pl(MonticuloPL* m);
+
+void iniciar_estado_pl(EstadoPL* e, int indice);
+void copiar_estado_pl(EstadoPL* dst, const EstadoPL* src);
+void liberar_estado_pl(EstadoPL* e);
+
+// Las reglas del modelo, con la política de admisión elegida
+void manejar_evento_pl(EstadoPL* e, int indice, const EventoPL* ev, EnviarEventoPL enviar, void* ctx);
+
+// La llegada al subtramo vecino que generará el EV_SALE sale (que no debe
+// ser el último subtramo del recorrido). Permite enviarla por adelantado
+void llegada_tras_salida(const EventoPL* sale, EventoPL* llegada);
+
+// Las llegadas no dependen del resto del modelo: se generan en orden y se
+// registran en est. Devuelve cuántas hubo
+int generar_llegadas_pl(unsigned int semilla, Estadisticas* est,
+                        void (*agregar)(void* ctx, const EventoPL* ev), void* ctx);
+
+#endif
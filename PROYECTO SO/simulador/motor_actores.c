@@ -0,0 +1,347 @@
+// Motor de actores
+//
+// Cada subtramo y cada hombrillo es un actor con su propio hilo y es el
+// único que toca sus contadores, así que no hay mutex en el camino de los
+// vehículos: un vehículo es un mensaje que pasa de un buzón a otro.
+//
+//   Subtramo i  <- SOLICITUD(v)      el vehículo quiere entrar (desde la
+//                                    entrada o desde el subtramo vecino, en
+//                                    cualquiera de las dos direcciones)
+//   Hombrillo h <- ENTRA_HOMBRILLO   el subtramo siguiente no lo admitió
+//              <- SALE_HOMBRILLO(t)  por fin entró, tras esperar t
+//
+// El subtramo decide localmente con puede_entrar_subtramo() (incluidos los
+// pesos de autos y camiones) y la política de admisión (politica.h). Los
+// que no pasan esperan en su cola, por orden de llegada, hasta que una
+// salida les deje espacio. Los vehículos que circulan están en el
+// montículo de temporizadores del actor.
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <semaphore.h>
+
+#include "motor_actores.h"
+#include "buzon.h"
+#include "cola_eventos.h"
+#include "reloj.h"
+#include "metricas.h"
+#include "registro.h"
+#include "vivo.h"
+#include "politica.h"
+
+#define CAPACIDAD_BUZON 1024  // Mensajes en vuelo; cada vehículo vivo ocupa a lo sumo dos
+
+typedef enum { MSG_SOLICITUD, MSG_ENTRA_HOMBRILLO, MSG_SALE_HOMBRILLO, MSG_FIN } TipoMensaje;
+
+typedef struct VehiculoActor {
+    Vehiculo v;
+    int actual;
+    int hombrillo;                    // Donde espera si no cabe; -1 en la entrada
+    int esperando;
+    tiempo_us inicioEspera;
+    struct VehiculoActor* sigEspera;
+} VehiculoActor;
+
+typedef struct {
+    VehiculoActor* primero;
+    VehiculoActor* ultimo;
+    int esperando[2];                 // [vehicleType], para la política de admisión
+} ColaEspera;
+
+// Cada actor en sus propias líneas de caché
+typedef struct {
+    Buzon buzon;
+    int indice;
+    EstadoSubtramo estado;
+    ColaEspera espera;
+    ListaEventos circulando;
+    int vehiculosPorDireccion[2];
+    int completados;
+    pthread_t hilo;
+} __attribute__((aligned(64))) ActorSubtramo;
+
+typedef struct {
+    Buzon buzon;
+    EstadisticaHombrillo estadistica;
+    pthread_t hilo;
+} __attribute__((aligned(64))) ActorHombrillo;
+
+typedef struct {
+    ActorSubtramo subtramos[MAX_SUBTRAMOS];
+    ActorHombrillo hombrillos[MAX_HOMBRILLOS];
+    RelojReal reloj;
+    long enCurso;  // Vehículos sin terminar + 1 mientras el generador siga
+    sem_t fin;
+} SimulacionActores;
+
+static SimulacionActores sim;
+
+static void encolar_espera(ColaEspera* c, VehiculoActor* veh)
+{
+    veh->sigEspera = NULL;
+    if (c->ultimo)
+        c->ultimo->sigEspera = veh;
+    else
+        c->primero = veh;
+    c->ultimo = veh;
+    c->esperando[veh->v.tipo]++;
+}
+
+static void terminar_uno()
+{
+    if (__atomic_sub_fetch(&sim.enCurso, 1, __ATOMIC_ACQ_REL) == 0)
+        sem_post(&sim.fin);
+}
+
+static void admitir(ActorSubtramo* a, VehiculoActor* veh, tiempo_us ahora)
+{
+    ocupar_subtramo(&a->estado, veh->v.tipo);
+    a->vehiculosPorDireccion[veh->v.dir]++;
+    if (veh->esperando) {
+        veh->esperando = 0;
+        REGISTRAR(REG_ESPERO, &veh->v, ahora, veh->hombrillo, ahora - veh->inicioEspera);
+        buzon_enviar(&sim.hombrillos[veh->hombrillo].buzon, MSG_SALE_HOMBRILLO, NULL,
+                     ahora - veh->inicioEspera);
+    }
+    tiempo_us recorrido = sortear_tiempo_subtramo(&veh->v);
+    REGISTRAR(REG_ENTRA, &veh->v, ahora, a->indice, 0);
+    REGISTRAR(REG_CIRCULA, &veh->v, ahora, a->indice, recorrido);
+    programar_evento(&a->circulando, ahora + recorrido, 0, veh);
+}
+
+static void solicitud(ActorSubtramo* a, VehiculoActor* veh, tiempo_us ahora)
+{
+    if (admite_llegada(&a->estado, veh->v.tipo, a->espera.esperando)) {
+        admitir(a, veh, ahora);
+        return;
+    }
+    if (veh->hombrillo >= 0) {
+        veh->esperando = 1;
+        veh->inicioEspera = ahora;
+        REGISTRAR(REG_LLENO, &veh->v, ahora, a->indice, veh->hombrillo);
+        buzon_enviar(&sim.hombrillos[veh->hombrillo].buzon, MSG_ENTRA_HOMBRILLO, NULL, 0);
+    }
+    encolar_espera(&a->espera, veh);
+}
+
+// Igual que despertar_cola() de modelo_pl.c: se admite, por orden de
+// llegada, a todo el que quepa y deje pasar la política
+static void despertar_cola(ActorSubtramo* a, tiempo_us ahora)
+{
+    ColaEspera* c = &a->espera;
+    VehiculoActor* anterior = NULL;
+    VehiculoActor* w = c->primero;
+    RecorridoCola r;
+    empezar_recorrido(&r, c->esperando);
+
+    while (w) {
+        VehiculoActor* sig = w->sigEspera;
+        if (pasa_en_recorrido(&r, &a->estado, w->v.tipo)) {
+            if (anterior)
+                anterior->sigEspera = sig;
+            else
+                c->primero = sig;
+            if (c->ultimo == w)
+                c->ultimo = anterior;
+            admitir(a, w, ahora);
+        } else {
+            anterior = w;
+        }
+        w = sig;
+    }
+}
+
+static void salida(ActorSubtramo* a, VehiculoActor* veh, tiempo_us ahora)
+{
+    liberar_subtramo(&a->estado, veh->v.tipo);
+    REGISTRAR(REG_SALE, &veh->v, ahora, a->indice, 0);
+
+    int siguiente = autopista.siguiente[veh->v.dir][a->indice];
+    if (siguiente < 0) {
+        REGISTRAR(REG_TERMINA, &veh->v, ahora, 0, 0);
+        a->completados++;
+        free(veh);
+        terminar_uno();
+    } else {
+        // Al vecino: si no lo admite, esperará en el hombrillo entre ambos
+        veh->hombrillo = autopista.hombrillo[veh->v.dir][a->indice];
+        veh->actual = siguiente;
+        buzon_enviar(&sim.subtramos[veh->actual].buzon, MSG_SOLICITUD, veh, 0);
+    }
+
+    despertar_cola(a, ahora);
+}
+
+static void* actorSubtramo(void* arg)
+{
+    ActorSubtramo* a = (ActorSubtramo*)arg;
+    for (;;) {
+        Mensaje m;
+        while (buzon_recibir(&a->buzon, &m)) {
+            if (m.tipo == MSG_FIN)
+                return NULL;
+            solicitud(a, m.dato, tiempo_modelo(&sim.reloj));
+        }
+
+        tiempo_us ahora = tiempo_modelo(&sim.reloj);
+        while (a->circulando.cantidad > 0 && a->circulando.eventos[0].tiempo <= ahora)
+            salida(a, extraer_evento(&a->circulando).dato, ahora);
+
+        if (a->circulando.cantidad > 0) {
+            struct timespec ts = instante_real(&sim.reloj, a->circulando.eventos[0].tiempo);
+            buzon_esperar(&a->buzon, &ts);
+        } else {
+            buzon_esperar(&a->buzon, NULL);
+        }
+    }
+}
+
+static void* actorHombrillo(void* arg)
+{
+    ActorHombrillo* a = (ActorHombrillo*)arg;
+    for (;;) {
+        Mensaje m;
+        while (buzon_recibir(&a->buzon, &m)) {
+            switch (m.tipo) {
+            case MSG_ENTRA_HOMBRILLO:
+                registrar_entrada_hombrillo(&a->estadistica);
+                break;
+            case MSG_SALE_HOMBRILLO:
+                registrar_salida_hombrillo(&a->estadistica, m.valor);
+                break;
+            case MSG_FIN:
+                return NULL;
+            }
+        }
+        buzon_esperar(&a->buzon, NULL);
+    }
+}
+
+static void inicializar_actores()
+{
+    EstadoSubtramo estados[MAX_SUBTRAMOS];
+    inicializar_subtramos(estados);
+    for (int i = 0; i < NUM_SUBTRAMOS; i++) {
+        ActorSubtramo* a = &sim.subtramos[i];
+        buzon_iniciar(&a->buzon, CAPACIDAD_BUZON);
+        a->indice = i;
+        a->estado = estados[i];
+        a->espera.primero = a->espera.ultimo = NULL;
+        a->espera.esperando[AUTO] = a->espera.esperando[CAMION] = 0;
+        a->circulando = (ListaEventos){0};
+        a->vehiculosPorDireccion[0] = a->vehiculosPorDireccion[1] = 0;
+        a->completados = 0;
+    }
+    for (int h = 0; h < NUM_HOMBRILLOS; h++) {
+        buzon_iniciar(&sim.hombrillos[h].buzon, CAPACIDAD_BUZON);
+        sim.hombrillos[h].estadistica = (EstadisticaHombrillo){0};
+    }
+    sim.enCurso = 1;
+    sem_init(&sim.fin, 0, 0);
+}
+
+// Al final cada actor entrega lo que contó
+static void recoger_estadisticas(Estadisticas* est)
+{
+    for (int i = 0; i < NUM_SUBTRAMOS; i++) {
+        ActorSubtramo* a = &sim.subtramos[i];
+        est->estadisticasSubtramos[i][DIR_1A4] = a->vehiculosPorDireccion[DIR_1A4];
+        est->estadisticasSubtramos[i][DIR_4A1] = a->vehiculosPorDireccion[DIR_4A1];
+        est->vehiculosCompletados += a->completados;
+        liberar_lista_eventos(&a->circulando);
+        buzon_destruir(&a->buzon);
+    }
+    for (int h = 0; h < NUM_HOMBRILLOS; h++) {
+        est->hombrillos[h] = sim.hombrillos[h].estadistica;
+        buzon_destruir(&sim.hombrillos[h].buzon);
+    }
+    sem_destroy(&sim.fin);
+}
+
+// Cada actor es el único que escribe sus contadores; aquí solo se leen,
+// sin cerrojos, para vivo.h
+#define LEER(x) __atomic_load_n(&(x), __ATOMIC_RELAXED)
+
+static void foto_vivo(void* arg, FotoVivo* foto)
+{
+    const Estadisticas* llegadas = arg;
+    Estadisticas* est = &foto->est;
+    for (int hora = 0; hora < 24; hora++)
+        for (int d = 0; d < 2; d++)
+            est->estadisticasHorarias[hora][d] = LEER(llegadas->estadisticasHorarias[hora][d]);
+    est->totalVehiculosDia = LEER(llegadas->totalVehiculosDia);
+
+    foto->numSubtramos = NUM_SUBTRAMOS;
+    for (int i = 0; i < NUM_SUBTRAMOS; i++) {
+        ActorSubtramo* a = &sim.subtramos[i];
+        foto->capacidad[i] = autopista.capacidad[i];
+        foto->ocupacion[i] = LEER(a->estado.vehiculosPresentes);
+        est->estadisticasSubtramos[i][DIR_1A4] = LEER(a->vehiculosPorDireccion[DIR_1A4]);
+        est->estadisticasSubtramos[i][DIR_4A1] = LEER(a->vehiculosPorDireccion[DIR_4A1]);
+        est->vehiculosCompletados += LEER(a->completados);
+    }
+    for (int h = 0; h < NUM_HOMBRILLOS; h++) {
+        const EstadisticaHombrillo* eh = &sim.hombrillos[h].estadistica;
+        est->hombrillos[h].vehiculosEsperando = LEER(eh->vehiculosEsperando);
+        est->hombrillos[h].maxEspera = LEER(eh->maxEspera);
+        est->hombrillos[h].tiempoMaxEspera = LEER(eh->tiempoMaxEspera);
+        est->hombrillos[h].tiempoTotalEspera = LEER(eh->tiempoTotalEspera);
+        est->hombrillos[h].totalVehiculosEsperado = LEER(eh->totalVehiculosEsperado);
+    }
+    foto->enCurso = est->totalVehiculosDia - est->vehiculosCompletados;
+    foto->tiempoModelo = tiempo_modelo(&sim.reloj);
+    foto->duracion = USEG_TOTAL_SIMULACION;
+    foto->usegPorHora = USEG_POR_HORA;
+}
+
+void ejecutar_motor_actores(unsigned int semilla, int aceleracion, Estadisticas* est)
+{
+    iniciar_estadisticas(est);
+    inicializar_actores();
+    iniciar_reloj(&sim.reloj, aceleracion);
+
+    for (int i = 0; i < NUM_SUBTRAMOS; i++)
+        crear_hilo(&sim.subtramos[i].hilo, actorSubtramo, &sim.subtramos[i]);
+    for (int h = 0; h < NUM_HOMBRILLOS; h++)
+        crear_hilo(&sim.hombrillos[h].hilo, actorHombrillo, &sim.hombrillos[h]);
+    iniciar_vivo(foto_vivo, est);
+
+    // El generador es el único que escribe las estadísticas de llegadas
+    FlujoAleatorio llegadas;
+    iniciar_flujo(&llegadas, semilla, FLUJO_LLEGADAS);
+    int vehiculosGenerados = 0;
+    while (vehiculosGenerados < TOTAL_VEHICULOS && tiempo_modelo(&sim.reloj) < USEG_TOTAL_SIMULACION) {
+        VehiculoActor* veh = malloc(sizeof(VehiculoActor));
+        if (veh == NULL) {
+            perror("malloc");
+            exit(1);
+        }
+        generar_vehiculo(&veh->v, vehiculosGenerados + 1, tiempo_modelo(&sim.reloj), semilla);
+        veh->hombrillo = -1;
+        veh->esperando = 0;
+        veh->actual = autopista.entrada[veh->v.dir];
+        registrar_llegada(est, &veh->v);
+        REGISTRAR(REG_INICIA, &veh->v, veh->v.horaEntrada, veh->actual, 0);
+
+        __atomic_add_fetch(&sim.enCurso, 1, __ATOMIC_RELAXED);
+        buzon_enviar(&sim.subtramos[veh->actual].buzon, MSG_SOLICITUD, veh, 0);
+
+        vehiculosGenerados++;
+        dormir_modelo(&sim.reloj, sortear_tiempo_llegada(&llegadas));
+    }
+
+    // Esperar a que salga el último vehículo y parar a los actores
+    terminar_uno();
+    sem_wait(&sim.fin);
+    for (int i = 0; i < NUM_SUBTRAMOS; i++)
+        buzon_enviar(&sim.subtramos[i].buzon, MSG_FIN, NULL, 0);
+    for (int h = 0; h < NUM_HOMBRILLOS; h++)
+        buzon_enviar(&sim.hombrillos[h].buzon, MSG_FIN, NULL, 0);
+    for (int i = 0; i < NUM_SUBTRAMOS; i++)
+        pthread_join(sim.subtramos[i].hilo, NULL);
+    for (int h = 0; h < NUM_HOMBRILLOS; h++)
+        pthread_join(sim.hombrillos[h].hilo, NULL);
+
+    terminar_vivo();
+    recoger_estadisticas(est);
+}
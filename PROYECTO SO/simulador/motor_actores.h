@@ -0,0 +1,10 @@
+// Motor de actores: cada subtramo y cada hombrillo es un hilo dueño de sus
+// contadores y los vehículos viajan como mensajes entre buzones
+#ifndef MOTOR_ACTORES_H
+#define MOTOR_ACTORES_H
+
+#include "trafico.h"
+
+void ejecutar_motor_actores(unsigned int semilla, int aceleracion, Estadisticas* est);
+
+#endif
@@ -0,0 +1,445 @@
+// Motor conservador CMB
+//
+// La autopista se parte en grupos contiguos de subtramos y cada grupo es un
+// proceso (fork) que simula sus subtramos en orden estricto con el modelo
+// de modelo_pl.h, sin retrocesos. Los vecinos se hablan por un socketpair
+// de Unix; cambiando el socketpair por un socket TCP podrían estar en otra
+// máquina.
+//
+// Anticipación (lookahead): un vehículo que entra en un subtramo en t sale
+// en t + recorrido >= t + USEG_POR_UNIDAD_SUBTRAMO. Si el siguiente
+// subtramo es de otro proceso, la llegada se le envía ya al admitirlo, con
+// su instante de salida. Por eso todo mensaje enviado mientras se procesa
+// el instante t trae un tiempo >= t + L y cada mensaje lleva esa promesa.
+//
+// Un proceso solo procesa eventos anteriores a la menor promesa de sus
+// vecinos. Si no puede avanzar, envía un mensaje nulo con su propia
+// promesa, min(siguiente evento, promesa de los vecinos) + L, que siempre
+// crece al menos L por vuelta, así que no hay bloqueo mutuo.
+//
+// Los hombrillos se comparten entre dos grupos: cada proceso anota sus
+// eventos de hombrillo y el padre los mezcla en el orden total del modelo.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+#include "motor_cmb.h"
+#include "modelo_pl.h"
+
+#define ANTICIPACION USEG_POR_UNIDAD_SUBTRAMO  // Recorrido mínimo de un subtramo
+#define TIEMPO_INFINITO LLONG_MAX
+
+enum { CANAL_IZQUIERDA, CANAL_DERECHA };
+enum { CMB_VEHICULO, CMB_NULO };
+
+typedef struct {
+    int tipo;
+    tiempo_us promesa;      // No llegará nada más anterior a esto
+    EventoPL ev;
+} MensajeCMB;
+
+typedef struct {
+    int fd;                 // -1 si no hay vecino por ese lado
+    tiempo_us cota;         // Mayor promesa recibida
+    tiempo_us prometido;    // Mayor promesa enviada
+} Canal;
+
+// Lo que cada proceso le devuelve al padre
+typedef struct {
+    int porDireccion[MAX_SUBTRAMOS][2];
+    int completados;
+    long eventos;
+    long mensajesVehiculo;
+    long mensajesNulos;
+    int numRegistros;       // Eventos de hombrillo que vienen detrás
+} ResultadoCMB;
+
+typedef struct {
+    int primero, ultimo;    // Subtramos del grupo
+    EstadoPL estados[MAX_SUBTRAMOS];
+    MonticuloPL pendientes;
+    EventoPL* llegadas;
+    int numLlegadas;
+    int capLlegadas;
+    int siguienteLlegada;
+    int totalVehiculos;
+    int salidas;            // Vehículos que ya dejaron el grupo
+    tiempo_us ahora;
+    Canal canales[2];
+    EventoPL* registro;     // Eventos de hombrillo
+    int numRegistro;
+    int capRegistro;
+    ResultadoCMB res;
+} ProcesoCMB;
+
+static void* crecer(void* p, int* capacidad, size_t tamano)
+{
+    *capacidad = *capacidad ? *capacidad * 2 : 256;
+    p = realloc(p, *capacidad * tamano);
+    if (p == NULL) {
+        perror("realloc");
+        exit(1);
+    }
+    return p;
+}
+
+// ---------------------------------------------------------------------
+// Canales
+
+static void escribir_todo(int fd, const void* datos, size_t n)
+{
+    const char* p = datos;
+    while (n > 0) {
+        ssize_t r = write(fd, p, n);
+        if (r < 0) {
+            if (errno == EINTR)
+                continue;
+            perror("write");
+            _exit(1);
+        }
+        p += r;
+        n -= r;
+    }
+}
+
+static int leer_todo(int fd, void* datos, size_t n)
+{
+    char* p = datos;
+    while (n > 0) {
+        ssize_t r = read(fd, p, n);
+        if (r < 0 && errno == EINTR)
+            continue;
+        if (r <= 0)
+            return 0;
+        p += r;
+        n -= r;
+    }
+    return 1;
+}
+
+static void enviar_canal(ProcesoCMB* p, int lado, int tipo, const EventoPL* ev, tiempo_us promesa)
+{
+    MensajeCMB m;
+    memset(&m, 0, sizeof(m));
+    m.tipo = tipo;
+    m.promesa = promesa;
+    if (ev)
+        m.ev = *ev;
+    escribir_todo(p->canales[lado].fd, &m, sizeof(m));
+    if (promesa > p->canales[lado].prometido)
+        p->canales[lado].prometido = promesa;
+    if (tipo == CMB_NULO)
+        p->res.mensajesNulos++;
+    else
+        p->res.mensajesVehiculo++;
+}
+
+// Lee todo lo que haya; con bloquear espera a que llegue al menos un mensaje
+static void recibir(ProcesoCMB* p, int bloquear)
+{
+    for (;;) {
+        struct pollfd fds[2];
+        int lados[2];
+        int n = 0;
+        for (int lado = 0; lado < 2; lado++) {
+            if (p->canales[lado].fd >= 0 && p->canales[lado].cota != TIEMPO_INFINITO) {
+                fds[n].fd = p->canales[lado].fd;
+                fds[n].events = POLLIN;
+                lados[n++] = lado;
+            }
+        }
+        if (n == 0) {
+            if (bloquear) {
+                fprintf(stderr, "CMB: subtramos %d-%d esperan sin vecinos activos\n", p->primero + 1, p->ultimo + 1);
+                _exit(1);
+            }
+            return;
+        }
+        int r = poll(fds, n, bloquear ? -1 : 0);
+        if (r < 0 && errno == EINTR)
+            continue;
+        if (r <= 0)
+            return;
+
+        for (int k = 0; k < n; k++) {
+            if (!(fds[k].revents & (POLLIN | POLLHUP)))
+                continue;
+            Canal* c = &p->canales[lados[k]];
+            MensajeCMB m;
+            if (!leer_todo(c->fd, &m, sizeof(m))) {
+                fprintf(stderr, "CMB: se cerró el canal de los subtramos %d-%d\n", p->primero + 1, p->ultimo + 1);
+                _exit(1);
+            }
+            if (m.tipo == CMB_VEHICULO)
+                meter_evento_pl(&p->pendientes, &m.ev);
+            if (m.promesa > c->cota)
+                c->cota = m.promesa;
+        }
+        bloquear = 0;  // Ya llegó algo; seguir leyendo sin esperar
+    }
+}
+
+static tiempo_us cota_entrada(ProcesoCMB* p)
+{
+    tiempo_us cota = TIEMPO_INFINITO;
+    for (int lado = 0; lado < 2; lado++)
+        if (p->canales[lado].fd >= 0 && p->canales[lado].cota < cota)
+            cota = p->canales[lado].cota;
+    return cota;
+}
+
+static void enviar_nulos(ProcesoCMB* p, tiempo_us promesa)
+{
+    for (int lado = 0; lado < 2; lado++)
+        if (p->canales[lado].fd >= 0 && promesa > p->canales[lado].prometido)
+            enviar_canal(p, lado, CMB_NULO, NULL, promesa);
+}
+
+// ---------------------------------------------------------------------
+// Simulación de un grupo
+
+static int es_propio(ProcesoCMB* p, int subtramo)
+{
+    return subtramo >= p->primero && subtramo <= p->ultimo;
+}
+
+// Recibe los eventos que genera el modelo
+static void enviar(void* ctx, const EventoPL* ev)
+{
+    ProcesoCMB* p = (ProcesoCMB*)ctx;
+
+    if (ev->destino >= NUM_SUBTRAMOS) {
+        if (p->numRegistro == p->capRegistro)
+            p->registro = crecer(p->registro, &p->capRegistro, sizeof(EventoPL));
+        p->registro[p->numRegistro++] = *ev;
+        return;
+    }
+    if (!es_propio(p, ev->destino))
+        return;  // La llegada al vecino ya se envió al admitir el vehículo
+
+    meter_evento_pl(&p->pendientes, ev);
+
+    // Si al salir pasará a otro grupo, enviarle ya la llegada: es la anticipación
+    if (ev->tipo == EV_SALE && autopista.siguiente[ev->veh.v.dir][ev->destino] >= 0) {
+        EventoPL llegada;
+        llegada_tras_salida(ev, &llegada);
+        if (!es_propio(p, llegada.destino)) {
+            int lado = (llegada.destino < p->primero) ? CANAL_IZQUIERDA : CANAL_DERECHA;
+            enviar_canal(p, lado, CMB_VEHICULO, &llegada, p->ahora + ANTICIPACION);
+        }
+    }
+}
+
+static void agregar_llegada(void* ctx, const EventoPL* ev)
+{
+    ProcesoCMB* p = (ProcesoCMB*)ctx;
+    if (!es_propio(p, ev->destino))
+        return;
+    if (p->numLlegadas == p->capLlegadas)
+        p->llegadas = crecer(p->llegadas, &p->capLlegadas, sizeof(EventoPL));
+    p->llegadas[p->numLlegadas++] = *ev;
+}
+
+// Siguiente evento local (pendientes o llegadas), sin sacarlo
+static const EventoPL* siguiente_evento(ProcesoCMB* p, int* esLlegada)
+{
+    const EventoPL* e = p->pendientes.cantidad > 0 ? &p->pendientes.eventos[0] : NULL;
+    const EventoPL* l = (p->siguienteLlegada < p->numLlegadas) ? &p->llegadas[p->siguienteLlegada] : NULL;
+    *esLlegada = (l && (e == NULL || comparar_eventos_pl(l, e) < 0));
+    return *esLlegada ? l : e;
+}
+
+static void procesar(ProcesoCMB* p)
+{
+    int esLlegada;
+    siguiente_evento(p, &esLlegada);
+    EventoPL ev = esLlegada ? p->llegadas[p->siguienteLlegada++] : sacar_evento_pl(&p->pendientes);
+
+    p->ahora = ev.tiempo;
+    if (ev.tipo == EV_SALE) {
+        int siguiente = autopista.siguiente[ev.veh.v.dir][ev.veh.actual];
+        if (siguiente < 0 || !es_propio(p, siguiente))
+            p->salidas++;
+    }
+    manejar_evento_pl(&p->estados[ev.destino], ev.destino, &ev, enviar, p);
+    p->res.eventos++;
+}
+
+static void simular_grupo(ProcesoCMB* p)
+{
+    for (;;) {
+        recibir(p, 0);
+        tiempo_us cota = cota_entrada(p);
+        int esLlegada;
+        const EventoPL* sig = siguiente_evento(p, &esLlegada);
+
+        if (sig && sig->tiempo < cota) {
+            procesar(p);
+            continue;
+        }
+        if (sig == NULL && p->salidas == p->totalVehiculos)
+            break;
+
+        // Bloqueado: prometer lo que se pueda y esperar a los vecinos
+        tiempo_us promesa = sig ? sig->tiempo : TIEMPO_INFINITO;
+        if (cota < promesa)
+            promesa = cota;
+        if (promesa != TIEMPO_INFINITO)
+            promesa += ANTICIPACION;
+        enviar_nulos(p, promesa);
+        recibir(p, 1);
+    }
+
+    // Ya no saldrá nada de aquí; esperar a que los vecinos digan lo mismo
+    enviar_nulos(p, TIEMPO_INFINITO);
+    while (cota_entrada(p) != TIEMPO_INFINITO)
+        recibir(p, 1);
+}
+
+static void proceso_grupo(unsigned int semilla, int primero, int ultimo, int fdIzq, int fdDer, int fdResultado)
+{
+    static ProcesoCMB p;
+    memset(&p, 0, sizeof(p));
+    p.primero = primero;
+    p.ultimo = ultimo;
+    for (int i = primero; i <= ultimo; i++)
+        iniciar_estado_pl(&p.estados[i], i);
+    p.canales[CANAL_IZQUIERDA].fd = fdIzq;
+    p.canales[CANAL_DERECHA].fd = fdDer;
+    p.totalVehiculos = generar_llegadas_pl(semilla, NULL, agregar_llegada, &p);
+
+    simular_grupo(&p);
+
+    for (int i = primero; i <= ultimo; i++) {
+        p.res.porDireccion[i][DIR_1A4] = p.estados[i].porDireccion[DIR_1A4];
+        p.res.porDireccion[i][DIR_4A1] = p.estados[i].porDireccion[DIR_4A1];
+        p.res.completados += p.estados[i].completados;
+    }
+    p.res.numRegistros = p.numRegistro;
+    escribir_todo(fdResultado, &p.res, sizeof(p.res));
+    escribir_todo(fdResultado, p.registro, p.numRegistro * sizeof(EventoPL));
+    _exit(0);
+}
+
+// ---------------------------------------------------------------------
+
+static void ignorar_llegada(void* ctx, const EventoPL* ev)
+{
+    (void)ctx;
+    (void)ev;
+}
+
+static int comparar_registros(const void* a, const void* b)
+{
+    return comparar_eventos_pl(a, b);
+}
+
+void ejecutar_motor_cmb(unsigned int semilla, int numProcesos, Estadisticas* est, EstadisticasCMB* ecmb)
+{
+    if (numProcesos <= 0)
+        numProcesos = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (numProcesos < 1)
+        numProcesos = 1;
+    if (numProcesos > NUM_SUBTRAMOS)
+        numProcesos = NUM_SUBTRAMOS;
+
+    // Las llegadas por hora las cuenta el padre; cada hijo genera las suyas
+    iniciar_estadisticas(est);
+    generar_llegadas_pl(semilla, est, ignorar_llegada, NULL);
+
+    int enlaces[MAX_SUBTRAMOS][2];     // Entre el grupo g y el g+1
+    int resultados[MAX_SUBTRAMOS][2];  // Tubería de cada hijo al padre
+    pid_t hijos[MAX_SUBTRAMOS];
+    for (int g = 0; g + 1 < numProcesos; g++) {
+        if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, enlaces[g]) < 0) {
+            perror("socketpair");
+            exit(1);
+        }
+    }
+
+    fflush(stdout);
+    for (int g = 0; g < numProcesos; g++) {
+        if (pipe(resultados[g]) < 0) {
+            perror("pipe");
+            exit(1);
+        }
+        hijos[g] = fork();
+        if (hijos[g] < 0) {
+            perror("fork");
+            exit(1);
+        }
+        if (hijos[g] == 0) {
+            int fdIzq = (g > 0) ? enlaces[g - 1][1] : -1;
+            int fdDer = (g + 1 < numProcesos) ? enlaces[g][0] : -1;
+            for (int k = 0; k + 1 < numProcesos; k++) {
+                if (enlaces[k][0] != fdDer)
+                    close(enlaces[k][0]);
+                if (enlaces[k][1] != fdIzq)
+                    close(enlaces[k][1]);
+            }
+            for (int k = 0; k < g; k++)
+                close(resultados[k][0]);
+            close(resultados[g][0]);
+            int primero = g * NUM_SUBTRAMOS / numProcesos;
+            int ultimo = (g + 1) * NUM_SUBTRAMOS / numProcesos - 1;
+            proceso_grupo(semilla, primero, ultimo, fdIzq, fdDer, resultados[g][1]);
+        }
+        close(resultados[g][1]);
+    }
+    for (int g = 0; g + 1 < numProcesos; g++) {
+        close(enlaces[g][0]);
+        close(enlaces[g][1]);
+    }
+
+    // Recoger resultados y mezclar los eventos de hombrillo en orden
+    memset(ecmb, 0, sizeof(*ecmb));
+    ecmb->procesos = numProcesos;
+    EventoPL* registro = NULL;
+    int numRegistro = 0;
+    for (int g = 0; g < numProcesos; g++) {
+        ResultadoCMB res;
+        if (!leer_todo(resultados[g][0], &res, sizeof(res))) {
+            fprintf(stderr, "CMB: el proceso %d no devolvió resultados\n", g);
+            exit(1);
+        }
+        registro = realloc(registro, (numRegistro + res.numRegistros + 1) * sizeof(EventoPL));
+        if (registro == NULL) {
+            perror("realloc");
+            exit(1);
+        }
+        if (!leer_todo(resultados[g][0], registro + numRegistro, res.numRegistros * sizeof(EventoPL))) {
+            fprintf(stderr, "CMB: resultados incompletos del proceso %d\n", g);
+            exit(1);
+        }
+        numRegistro += res.numRegistros;
+        close(resultados[g][0]);
+
+        for (int i = 0; i < NUM_SUBTRAMOS; i++) {
+            est->estadisticasSubtramos[i][DIR_1A4] += res.porDireccion[i][DIR_1A4];
+            est->estadisticasSubtramos[i][DIR_4A1] += res.porDireccion[i][DIR_4A1];
+        }
+        est->vehiculosCompletados += res.completados;
+        ecmb->eventos += res.eventos;
+        ecmb->mensajesVehiculo += res.mensajesVehiculo;
+        ecmb->mensajesNulos += res.mensajesNulos;
+    }
+    for (int g = 0; g < numProcesos; g++)
+        waitpid(hijos[g], NULL, 0);
+
+    qsort(registro, numRegistro, sizeof(EventoPL), comparar_registros);
+    for (int k = 0; k < numRegistro; k++) {
+        EstadisticaHombrillo* h = &est->hombrillos[registro[k].destino - NUM_SUBTRAMOS];
+        if (registro[k].tipo == EV_ENTRA_HOMBRILLO)
+            registrar_entrada_hombrillo(h);
+        else
+            registrar_salida_hombrillo(h, registro[k].valor);
+    }
+    ecmb->eventos += numRegistro;
+    free(registro);
+}
@@ -0,0 +1,19 @@
+// Motor conservador en varios procesos (Chandy-Misra-Bryant con mensajes nulos)
+#ifndef MOTOR_CMB_H
+#define MOTOR_CMB_H
+
+#include "trafico.h"
+
+typedef struct {
+    int procesos;
+    long eventos;
+    long mensajesVehiculo;  // Vehículos pasados de un proceso a otro
+    long mensajesNulos;
+} EstadisticasCMB;
+
+// numProcesos grupos contiguos de subtramos, cada uno en su propio proceso
+// (<= 0: uno por núcleo, como mucho uno por subtramo). El resultado es el
+// mismo que el de --motor=des y --motor=timewarp para la misma semilla
+void ejecutar_motor_cmb(unsigned int semilla, int numProcesos, Estadisticas* est, EstadisticasCMB* ecmb);
+
+#endif
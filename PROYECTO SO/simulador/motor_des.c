@@ -0,0 +1,118 @@
+// Motor de eventos discretos (DES)
+//
+// En vez de dormir el hilo de cada vehículo, cada cambio de estado es un
+// evento con su instante en el reloj virtual. Ejecuta en un solo hilo el
+// modelo de procesos lógicos (modelo_pl.h) que reparten timewarp y cmb,
+// sacando los eventos en su mismo orden total, así que con la misma
+// semilla los tres dan exactamente las mismas estadísticas (lo comprueba
+// programas/comprobar_motores.c).
+//
+// Eventos (modelo_pl.h):
+//   EV_LLEGA           -> el vehículo llega a un subtramo (a la autopista
+//                         si viene de la entrada) y entra o espera
+//   EV_SALE            -> termina de circular, libera el subtramo y pasa
+//                         al siguiente; se admite a los que esperaban
+//   EV_ENTRA_HOMBRILLO -> el vehículo se para en el hombrillo
+//   EV_SALE_HOMBRILLO  -> se le concedió el siguiente subtramo tras esperar
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "motor_des.h"
+#include "modelo_pl.h"
+#include "registro.h"
+
+typedef struct {
+    tiempo_us reloj;
+    MonticuloPL futuros;
+    EstadoPL estados[MAX_PROCESOS_LOGICOS];
+    EventoPL* llegadas;             // Ya ordenadas: se mezclan con futuros
+    int numLlegadas;
+    int capLlegadas;
+    int siguienteLlegada;
+} SimulacionDES;
+
+static void agregar_llegada(void* ctx, const EventoPL* ev)
+{
+    SimulacionDES* sim = (SimulacionDES*)ctx;
+    if (sim->numLlegadas == sim->capLlegadas) {
+        sim->capLlegadas = sim->capLlegadas ? sim->capLlegadas * 2 : 256;
+        sim->llegadas = realloc(sim->llegadas, sim->capLlegadas * sizeof(EventoPL));
+        if (sim->llegadas == NULL) {
+            perror("realloc");
+            exit(1);
+        }
+    }
+    sim->llegadas[sim->numLlegadas++] = *ev;
+}
+
+// Los eventos nuevos se registran al generarse, que es cuando se decide
+// lo que pasa (entrar y cuánto tardar, parar en el hombrillo, salir de él)
+static void enviar(void* ctx, const EventoPL* ev)
+{
+    SimulacionDES* sim = (SimulacionDES*)ctx;
+    switch (ev->tipo) {
+    case EV_SALE:
+        REGISTRAR(REG_ENTRA, &ev->veh.v, sim->reloj, ev->destino, 0);
+        REGISTRAR(REG_CIRCULA, &ev->veh.v, sim->reloj, ev->destino, ev->tiempo - sim->reloj);
+        break;
+    case EV_ENTRA_HOMBRILLO:
+        REGISTRAR(REG_LLENO, &ev->veh.v, sim->reloj, ev->veh.actual, ev->veh.hombrillo);
+        break;
+    case EV_SALE_HOMBRILLO:
+        REGISTRAR(REG_ESPERO, &ev->veh.v, sim->reloj, ev->veh.hombrillo, ev->valor);
+        break;
+    }
+    meter_evento_pl(&sim->futuros, ev);
+}
+
+// Saca el siguiente evento en el orden de comparar_eventos_pl(), sea una
+// llegada a la autopista o uno de los programados
+static EventoPL siguiente_evento(SimulacionDES* sim)
+{
+    if (sim->siguienteLlegada < sim->numLlegadas
+        && (sim->futuros.cantidad == 0
+            || comparar_eventos_pl(&sim->llegadas[sim->siguienteLlegada], &sim->futuros.eventos[0]) < 0))
+        return sim->llegadas[sim->siguienteLlegada++];
+    return sacar_evento_pl(&sim->futuros);
+}
+
+void ejecutar_motor_des(unsigned int semilla, Estadisticas* est)
+{
+    SimulacionDES* sim = calloc(1, sizeof(SimulacionDES));
+    if (sim == NULL) {
+        perror("calloc");
+        exit(1);
+    }
+    iniciar_estadisticas(est);
+    for (int i = 0; i < NUM_PROCESOS_LOGICOS; i++)
+        iniciar_estado_pl(&sim->estados[i], i);
+    generar_llegadas_pl(semilla, est, agregar_llegada, sim);
+
+    while (sim->siguienteLlegada < sim->numLlegadas || sim->futuros.cantidad > 0) {
+        EventoPL ev = siguiente_evento(sim);
+        sim->reloj = ev.tiempo;
+
+        if (ev.tipo == EV_LLEGA && ev.veh.hombrillo < 0) {
+            REGISTRAR(REG_INICIA, &ev.veh.v, sim->reloj, ev.destino, 0);
+        } else if (ev.tipo == EV_SALE) {
+            REGISTRAR(REG_SALE, &ev.veh.v, sim->reloj, ev.destino, 0);
+            if (autopista.siguiente[ev.veh.v.dir][ev.destino] < 0)
+                REGISTRAR(REG_TERMINA, &ev.veh.v, sim->reloj, 0, 0);
+        }
+        manejar_evento_pl(&sim->estados[ev.destino], ev.destino, &ev, enviar, sim);
+    }
+
+    for (int i = 0; i < NUM_SUBTRAMOS; i++) {
+        est->estadisticasSubtramos[i][DIR_1A4] = sim->estados[i].porDireccion[DIR_1A4];
+        est->estadisticasSubtramos[i][DIR_4A1] = sim->estados[i].porDireccion[DIR_4A1];
+        est->vehiculosCompletados += sim->estados[i].completados;
+    }
+    for (int h = 0; h < NUM_HOMBRILLOS; h++)
+        est->hombrillos[h] = sim->estados[PL_HOMBRILLO(h)].hombrillo;
+
+    for (int i = 0; i < NUM_PROCESOS_LOGICOS; i++)
+        liberar_estado_pl(&sim->estados[i]);
+    liberar_monticulo_pl(&sim->futuros);
+    free(sim->llegadas);
+    free(sim);
+}
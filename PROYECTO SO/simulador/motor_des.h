@@ -0,0 +1,14 @@
+// Motor de eventos discretos: reloj virtual en lugar de usleep()
+#ifndef MOTOR_DES_H
+#define MOTOR_DES_H
+
+#include "trafico.h"
+
+// Súbela cuando un cambio en el motor o en el modelo haga que la misma
+// semilla dé otro día: así la caché de días (cache_dias.h) no los confunde
+#define VERSION_MOTOR_DES 2
+
+// Simula un día completo en un solo hilo y deja el resultado en est
+void ejecutar_motor_des(unsigned int semilla, Estadisticas* est);
+
+#endif
@@ -0,0 +1,278 @@
+// Motor de fibras
+//
+// El vehículo conserva el estilo lineal de vehiculoThread (Gamma2-1): espera
+// el semáforo del subtramo, circula, pasa por el hombrillo... pero cada
+// espera es un cambio de fibra y no un bloqueo del hilo en el núcleo.
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "motor_fibras.h"
+#include "fibras.h"
+#include "reloj.h"
+#include "contadores.h"
+#include "registro.h"
+#include "vivo.h"
+
+// Estructura adicional para controlar el acceso a un subtramo con pesos
+typedef struct {
+    CondFibra condAuto;
+    CondFibra condCamion;
+    pthread_mutex_t mutex;
+    int waitingAutos;
+    int waitingCamiones;
+} ControlPeso;
+
+typedef struct {
+    EstadoSubtramo estado[MAX_SUBTRAMOS];
+    SemaforoFibra semaforo[MAX_SUBTRAMOS];   // Subtramos sin pesos
+    ControlPeso control[MAX_SUBTRAMOS];      // Subtramos con pesos
+    pthread_mutex_t mutex[MAX_SUBTRAMOS];
+    ContadoresRepartidos contadores;
+    RelojReal reloj;
+    unsigned int semilla;
+    FlujoAleatorio llegadas;
+} SimulacionFibras;
+
+static SimulacionFibras sim;
+
+static void inicializar_recursos()
+{
+    inicializar_subtramos(sim.estado);
+    for (int i = 0; i < NUM_SUBTRAMOS; i++) {
+        sem_fibra_iniciar(&sim.semaforo[i], sim.estado[i].capacidad);
+        pthread_mutex_init(&sim.mutex[i], NULL);
+
+        ControlPeso* c = &sim.control[i];
+        cond_fibra_iniciar(&c->condAuto);
+        cond_fibra_iniciar(&c->condCamion);
+        pthread_mutex_init(&c->mutex, NULL);
+        c->waitingAutos = 0;
+        c->waitingCamiones = 0;
+    }
+    iniciar_contadores(&sim.contadores);
+}
+
+static void limpiar_recursos()
+{
+    for (int i = 0; i < NUM_SUBTRAMOS; i++) {
+        sem_fibra_destruir(&sim.semaforo[i]);
+        pthread_mutex_destroy(&sim.mutex[i]);
+        pthread_mutex_destroy(&sim.control[i].mutex);
+    }
+}
+
+// Verifica e intenta entrar atomicamente
+static int entrar_con_peso(int i, Vehiculo* v)
+{
+    pthread_mutex_lock(&sim.mutex[i]);
+    int puede_entrar = puede_entrar_subtramo(&sim.estado[i], v->tipo);
+    if (puede_entrar)
+        ocupar_subtramo(&sim.estado[i], v->tipo);
+    pthread_mutex_unlock(&sim.mutex[i]);
+    return puede_entrar;
+}
+
+static void esperar_entrada_con_peso(int i, Vehiculo* v)
+{
+    ControlPeso* c = &sim.control[i];
+    pthread_mutex_lock(&c->mutex);
+
+    if (v->tipo == AUTO)
+        c->waitingAutos++;
+    else
+        c->waitingCamiones++;
+
+    while (!entrar_con_peso(i, v)) {
+        if (v->tipo == AUTO)
+            cond_fibra_esperar(&c->condAuto, &c->mutex);
+        else
+            cond_fibra_esperar(&c->condCamion, &c->mutex);
+    }
+
+    if (v->tipo == AUTO)
+        c->waitingAutos--;
+    else
+        c->waitingCamiones--;
+
+    pthread_mutex_unlock(&c->mutex);
+}
+
+// Gamma2-1 hace broadcast a todos los autos; aquí se despiertan solo los que
+// caben (los demás volverían a dormirse), para que el coste no crezca con
+// el número de vehículos esperando
+static void notificar_espera_con_peso(int i)
+{
+    ControlPeso* c = &sim.control[i];
+    pthread_mutex_lock(&c->mutex);
+    if (c->waitingCamiones > 0) {
+        cond_fibra_senal(&c->condCamion);  // Los camiones tienen prioridad
+    } else if (c->waitingAutos > 0) {
+        pthread_mutex_lock(&sim.mutex[i]);
+        EstadoSubtramo* s = &sim.estado[i];
+        int cupo = (s->capacidad - s->carga) / s->peso[AUTO];
+        pthread_mutex_unlock(&sim.mutex[i]);
+        for (int k = 0; k < cupo; k++)
+            cond_fibra_senal(&c->condAuto);
+    }
+    pthread_mutex_unlock(&c->mutex);
+}
+
+static void entrar_subtramo(int i, Vehiculo* v)
+{
+    pthread_mutex_lock(&sim.mutex[i]);
+    ocupar_subtramo(&sim.estado[i], v->tipo);
+    pthread_mutex_unlock(&sim.mutex[i]);
+}
+
+// Ocupa el subtramo i si cabe, sin esperar
+static int intentar_entrar(int i, Vehiculo* v)
+{
+    if (autopista.conPeso[i])
+        return entrar_con_peso(i, v);
+    if (!sem_fibra_intentar(&sim.semaforo[i]))
+        return 0;
+    entrar_subtramo(i, v);
+    return 1;
+}
+
+static void esperar_entrar(int i, Vehiculo* v)
+{
+    if (autopista.conPeso[i]) {
+        esperar_entrada_con_peso(i, v);
+    } else {
+        sem_fibra_esperar(&sim.semaforo[i]);
+        entrar_subtramo(i, v);
+    }
+}
+
+static void salir_subtramo(int i, Vehiculo* v)
+{
+    pthread_mutex_lock(&sim.mutex[i]);
+    liberar_subtramo(&sim.estado[i], v->tipo);
+    pthread_mutex_unlock(&sim.mutex[i]);
+
+    if (autopista.conPeso[i])
+        notificar_espera_con_peso(i);
+    else
+        sem_fibra_publicar(&sim.semaforo[i]);
+}
+
+// Una fibra puede despertar en otro hilo: el fragmento se busca cada vez
+static FragmentoContadores* fragmento()
+{
+    return fragmento_del_hilo(&sim.contadores);
+}
+
+static void vehiculoFibra(void* arg)
+{
+    Vehiculo* v = (Vehiculo*)arg;
+    int inicio = autopista.entrada[v->dir];
+
+    // El primer subtramo se espera en la entrada
+    REGISTRAR(REG_INICIA, v, tiempo_modelo(&sim.reloj), inicio, 0);
+    esperar_entrar(inicio, v);
+    contar_subtramo(fragmento(), inicio, v->dir);
+
+    for (int i = inicio; ; ) {
+        REGISTRAR(REG_ENTRA, v, tiempo_modelo(&sim.reloj), i, 0);
+        tiempo_us recorrido = sortear_tiempo_subtramo(v);
+        REGISTRAR(REG_CIRCULA, v, tiempo_modelo(&sim.reloj), i, recorrido);
+        fibra_dormir(recorrido);
+        salir_subtramo(i, v);
+        contar_salida_subtramo(fragmento(), i);
+        REGISTRAR(REG_SALE, v, tiempo_modelo(&sim.reloj), i, 0);
+
+        int siguiente = autopista.siguiente[v->dir][i];
+        if (siguiente < 0)
+            break;
+
+        int h = autopista.hombrillo[v->dir][i];
+        tiempo_us inicio_espera = tiempo_modelo(&sim.reloj);
+        int en_hombrillo = 0;
+
+        if (!intentar_entrar(siguiente, v)) {
+            en_hombrillo = 1;
+            REGISTRAR(REG_LLENO, v, inicio_espera, siguiente, h);
+            contar_entrada_hombrillo(&sim.contadores, h);
+            esperar_entrar(siguiente, v);
+        }
+
+        if (en_hombrillo) {
+            tiempo_us espera = tiempo_modelo(&sim.reloj) - inicio_espera;
+            REGISTRAR(REG_ESPERO, v, inicio_espera + espera, h, espera);
+            contar_salida_hombrillo(&sim.contadores, fragmento(), h, espera);
+        }
+        contar_subtramo(fragmento(), siguiente, v->dir);
+        i = siguiente;
+    }
+
+    REGISTRAR(REG_TERMINA, v, tiempo_modelo(&sim.reloj), 0, 0);
+    contar_completado(fragmento());
+}
+
+static void lanzar_vehiculo(int id)
+{
+    Vehiculo v;
+    generar_vehiculo(&v, id, tiempo_modelo(&sim.reloj), sim.semilla);
+
+    contar_llegada(fragmento(), &v);
+
+    // Los datos del vehículo viajan dentro de la fibra: no hay free() en su pila
+    crear_fibra(vehiculoFibra, &v, sizeof(v), 0);
+}
+
+// El generador también es una fibra: duerme entre llegadas sin ocupar un
+// hilo. Llama a malloc (crear_fibra), así que lleva una pila holgada
+static void generadorFibra(void* arg)
+{
+    (void)arg;
+    int vehiculosGenerados = 0;
+    while (vehiculosGenerados < TOTAL_VEHICULOS && tiempo_modelo(&sim.reloj) < USEG_TOTAL_SIMULACION) {
+        lanzar_vehiculo(vehiculosGenerados + 1);
+        vehiculosGenerados++;
+        fibra_dormir(sortear_tiempo_llegada(&sim.llegadas));
+    }
+}
+
+// registrar_evento() reservaría el anillo dentro de la primera fibra que
+// registre en cada hilo, y con --pila=2048 no hay sitio para malloc
+static void preparar_hilo()
+{
+    preparar_registro_hilo();
+}
+
+static void foto_vivo(void* arg, FotoVivo* foto)
+{
+    (void)arg;
+    foto_de_contadores(foto, &sim.contadores);
+    foto->tiempoModelo = tiempo_modelo(&sim.reloj);
+}
+
+void ejecutar_motor_fibras(unsigned int semilla, int aceleracion, const OpcionesFibras* op, Estadisticas* est)
+{
+    sim.semilla = semilla;
+    iniciar_flujo(&sim.llegadas, semilla, FLUJO_LLEGADAS);
+    inicializar_recursos();
+    iniciar_reloj(&sim.reloj, aceleracion);
+    iniciar_fibras(op->tamPila ? op->tamPila : PILA_FIBRA_POR_DEFECTO, &sim.reloj);
+    preparar_hilos_fibras(preparar_hilo);
+
+    if (op->rafaga > 0) {
+        for (int id = 1; id <= op->rafaga; id++)
+            lanzar_vehiculo(id);
+    } else {
+        crear_fibra(generadorFibra, NULL, 0, PILA_GENERADOR);
+    }
+
+    iniciar_vivo(foto_vivo, NULL);
+    ejecutar_fibras(op->numHilos);
+    terminar_vivo();
+    juntar_contadores(&sim.contadores, est);
+    limpiar_recursos();
+}
+
+size_t memoria_por_vehiculo_fibra()
+{
+    return memoria_por_fibra(sizeof(Vehiculo));
+}
@@ -0,0 +1,26 @@
+// Motor con una fibra por vehículo sobre unos pocos hilos del sistema
+#ifndef MOTOR_FIBRAS_H
+#define MOTOR_FIBRAS_H
+
+#include <stddef.h>
+
+#include "trafico.h"
+
+typedef struct {
+    int numHilos;     // <= 0: un hilo por núcleo
+    size_t tamPila;   // Bytes de pila por vehículo
+    int rafaga;       // > 0: lanza ese número de vehículos a la vez en t=0
+} OpcionesFibras;
+
+// Con página de guarda (fibras.h). El código del vehículo cabe en 2 KB,
+// pero lo que llama de libc (el registro, printf) puede pedir varios KB.
+// PILA_FIBRA_RAFAGA es para lanzar cientos de miles a la vez: sin guarda,
+// porque dos proyecciones por fibra agotarían vm.max_map_count
+#define PILA_FIBRA_POR_DEFECTO (16 * 1024)
+#define PILA_FIBRA_RAFAGA 2048
+#define PILA_GENERADOR (64 * 1024)
+
+void ejecutar_motor_fibras(unsigned int semilla, int aceleracion, const OpcionesFibras* op, Estadisticas* est);
+size_t memoria_por_vehiculo_fibra();  // Descriptor + datos + pila de un vehículo
+
+#endif
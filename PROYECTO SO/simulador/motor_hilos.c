@@ -0,0 +1,371 @@
+// Motor de referencia con un hilo por vehículo
+//
+// Reproduce la lógica de Problema2Gamma2-1.c (semaforos para los subtramos
+// en los que todo pesa 1, variables de condición para los que tienen pesos,
+// como el subtramo 2) pero sobre el modelo común, para poder comparar sus
+// estadísticas con las de los otros motores. Los tiempos son los del
+// escenario: con --escenario=escenarios/gamma2-1.txt, los de Gamma2-1. El
+// tiempo del modelo es el tiempo real transcurrido por la aceleración. Los
+// semáforos y las condiciones son los de espera_giro.h, que giran un poco
+// antes de dormir en el núcleo.
+//
+// En el modo con procesos el estado compartido vive en un segmento
+// shm_open + mmap y varios procesos hijos (fork) se reparten los vehículos;
+// cada uno crea los hilos de los suyos. Sirve para medir lo que cuesta
+// sincronizar entre procesos frente a hacerlo entre hilos.
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#include "motor_hilos.h"
+#include "reloj.h"
+#include "metricas.h"
+#include "contadores.h"
+#include "registro.h"
+#include "vivo.h"
+#include "espera_giro.h"
+
+// Estructura adicional para controlar el acceso a un subtramo con pesos
+typedef struct {
+    AvisoGiro avisoAuto;
+    AvisoGiro avisoCamion;
+    int waitingAutos;
+    int waitingCamiones;
+} ControlPeso;
+
+// Todo lo que comparten los vehículos. En el modo con procesos vive en un
+// segmento de memoria compartida y sus semáforos y mutex son pshared
+typedef struct {
+    EstadoSubtramo estado[MAX_SUBTRAMOS];
+    SemaforoGiro semaforo[MAX_SUBTRAMOS];    // Subtramos sin pesos
+    ControlPeso control[MAX_SUBTRAMOS];      // Subtramos con pesos
+    pthread_mutex_t mutex[MAX_SUBTRAMOS];
+    ContadoresRepartidos contadores;
+    RelojReal reloj;
+    long hilosCreados;  // De todos los procesos
+} RecursosHilos;
+
+typedef struct {
+    RecursosHilos* r;
+
+    // Vehículos en circulación de este proceso, para saber cuándo termina
+    int vehiculosEnCurso;
+    pthread_mutex_t mutexEnCurso;
+    pthread_cond_t condFin;
+} SimulacionHilos;
+
+static SimulacionHilos sim;
+
+static void inicializar_recursos(int pshared)
+{
+    RecursosHilos* r = sim.r;
+    pthread_mutexattr_t am;
+    pthread_mutexattr_init(&am);
+    if (pshared)
+        pthread_mutexattr_setpshared(&am, PTHREAD_PROCESS_SHARED);
+
+    inicializar_subtramos(r->estado);
+    for (int i = 0; i < NUM_SUBTRAMOS; i++) {
+        iniciar_semaforo_giro(&r->semaforo[i], r->estado[i].capacidad, pshared);
+        pthread_mutex_init(&r->mutex[i], &am);
+
+        ControlPeso* c = &r->control[i];
+        iniciar_aviso_giro(&c->avisoAuto, pshared);
+        iniciar_aviso_giro(&c->avisoCamion, pshared);
+        c->waitingAutos = 0;
+        c->waitingCamiones = 0;
+    }
+    iniciar_contadores(&r->contadores);
+    r->hilosCreados = 0;
+
+    pthread_mutexattr_destroy(&am);
+}
+
+static void recoger_esperas(EsperasHilos* esperas)
+{
+    for (int i = 0; i < NUM_SUBTRAMOS; i++) {
+        esperas->semaforo[i] = sim.r->semaforo[i].est;
+        esperas->autos[i] = sim.r->control[i].avisoAuto.est;
+        esperas->camiones[i] = sim.r->control[i].avisoCamion.est;
+    }
+}
+
+static void limpiar_recursos()
+{
+    RecursosHilos* r = sim.r;
+    for (int i = 0; i < NUM_SUBTRAMOS; i++)
+        pthread_mutex_destroy(&r->mutex[i]);
+}
+
+// Verifica e intenta entrar atomicamente
+static int entrar_con_peso(int i, Vehiculo* v)
+{
+    pthread_mutex_lock(&sim.r->mutex[i]);
+    int puede_entrar = puede_entrar_subtramo(&sim.r->estado[i], v->tipo);
+    if (puede_entrar)
+        ocupar_subtramo(&sim.r->estado[i], v->tipo);
+    pthread_mutex_unlock(&sim.r->mutex[i]);
+    return puede_entrar;
+}
+
+// Se apunta como esperando antes de mirar el aviso y de intentar entrar:
+// quien libera sitio lo hace antes de mirar quién espera, así que o aquí se
+// ve el sitio o allí se ve al que espera y la secuencia cambia
+static void esperar_entrada_con_peso(int i, Vehiculo* v)
+{
+    ControlPeso* c = &sim.r->control[i];
+    int* esperando = (v->tipo == AUTO) ? &c->waitingAutos : &c->waitingCamiones;
+    AvisoGiro* aviso = (v->tipo == AUTO) ? &c->avisoAuto : &c->avisoCamion;
+
+    __atomic_add_fetch(esperando, 1, __ATOMIC_SEQ_CST);
+    for (;;) {
+        unsigned int visto = leer_aviso_giro(aviso);
+        if (entrar_con_peso(i, v))
+            break;
+        esperar_aviso_giro(aviso, visto);
+    }
+    __atomic_sub_fetch(esperando, 1, __ATOMIC_SEQ_CST);
+}
+
+static void notificar_espera_con_peso(int i)
+{
+    ControlPeso* c = &sim.r->control[i];
+    if (__atomic_load_n(&c->waitingCamiones, __ATOMIC_SEQ_CST) > 0)
+        avisar_giro(&c->avisoCamion, 0);  // Los camiones tienen prioridad
+    else if (__atomic_load_n(&c->waitingAutos, __ATOMIC_SEQ_CST) > 0)
+        avisar_giro(&c->avisoAuto, 1);
+}
+
+static void entrar_subtramo(int i, Vehiculo* v)
+{
+    pthread_mutex_lock(&sim.r->mutex[i]);
+    ocupar_subtramo(&sim.r->estado[i], v->tipo);
+    pthread_mutex_unlock(&sim.r->mutex[i]);
+}
+
+// Ocupa el subtramo i si cabe, sin esperar
+static int intentar_entrar(int i, Vehiculo* v)
+{
+    if (autopista.conPeso[i])
+        return entrar_con_peso(i, v);
+    if (!intentar_semaforo_giro(&sim.r->semaforo[i]))
+        return 0;
+    entrar_subtramo(i, v);
+    return 1;
+}
+
+static void esperar_entrar(int i, Vehiculo* v)
+{
+    if (autopista.conPeso[i]) {
+        esperar_entrada_con_peso(i, v);
+    } else {
+        esperar_semaforo_giro(&sim.r->semaforo[i]);
+        entrar_subtramo(i, v);
+    }
+}
+
+static void salir_subtramo(int i, Vehiculo* v)
+{
+    pthread_mutex_lock(&sim.r->mutex[i]);
+    liberar_subtramo(&sim.r->estado[i], v->tipo);
+    pthread_mutex_unlock(&sim.r->mutex[i]);
+
+    if (autopista.conPeso[i])
+        notificar_espera_con_peso(i);
+    else
+        senalar_semaforo_giro(&sim.r->semaforo[i]);
+}
+
+static void* vehiculoThread(void* arg)
+{
+    Vehiculo* v = (Vehiculo*)arg;
+    ContadoresRepartidos* c = &sim.r->contadores;
+    FragmentoContadores* f = fragmento_del_hilo(c);
+    int inicio = autopista.entrada[v->dir];
+
+    // El primer subtramo se espera en la entrada
+    REGISTRAR(REG_INICIA, v, tiempo_modelo(&sim.r->reloj), inicio, 0);
+    esperar_entrar(inicio, v);
+    contar_subtramo(f, inicio, v->dir);
+
+    for (int i = inicio; ; ) {
+        REGISTRAR(REG_ENTRA, v, tiempo_modelo(&sim.r->reloj), i, 0);
+        tiempo_us recorrido = sortear_tiempo_subtramo(v);
+        REGISTRAR(REG_CIRCULA, v, tiempo_modelo(&sim.r->reloj), i, recorrido);
+        dormir_modelo(&sim.r->reloj, recorrido);
+        salir_subtramo(i, v);
+        contar_salida_subtramo(f, i);
+        REGISTRAR(REG_SALE, v, tiempo_modelo(&sim.r->reloj), i, 0);
+
+        int siguiente = autopista.siguiente[v->dir][i];
+        if (siguiente < 0)
+            break;
+
+        int h = autopista.hombrillo[v->dir][i];
+        tiempo_us inicio_espera = tiempo_modelo(&sim.r->reloj);
+        int en_hombrillo = 0;
+
+        if (!intentar_entrar(siguiente, v)) {
+            en_hombrillo = 1;
+            REGISTRAR(REG_LLENO, v, inicio_espera, siguiente, h);
+            contar_entrada_hombrillo(c, h);
+            esperar_entrar(siguiente, v);
+        }
+
+        if (en_hombrillo) {
+            tiempo_us espera = tiempo_modelo(&sim.r->reloj) - inicio_espera;
+            REGISTRAR(REG_ESPERO, v, inicio_espera + espera, h, espera);
+            contar_salida_hombrillo(c, f, h, espera);
+        }
+        contar_subtramo(f, siguiente, v->dir);
+        i = siguiente;
+    }
+
+    REGISTRAR(REG_TERMINA, v, tiempo_modelo(&sim.r->reloj), 0, 0);
+    free(v);
+    contar_completado(f);
+
+    pthread_mutex_lock(&sim.mutexEnCurso);
+    if (--sim.vehiculosEnCurso == 0)
+        pthread_cond_signal(&sim.condFin);
+    pthread_mutex_unlock(&sim.mutexEnCurso);
+    return NULL;
+}
+
+// Sigue todas las llegadas pero solo genera y lanza los vehículos con
+// (id - 1) % numProcesos == proceso, y espera a que salgan. Los sorteos de
+// cada vehículo solo dependen de la semilla y de su id, así que no hace
+// falta generar los de los demás procesos
+static void generar_vehiculos(unsigned int semilla, int proceso, int numProcesos)
+{
+    pthread_mutex_init(&sim.mutexEnCurso, NULL);
+    pthread_cond_init(&sim.condFin, NULL);
+    sim.vehiculosEnCurso = 0;
+
+    FlujoAleatorio llegadas;
+    iniciar_flujo(&llegadas, semilla, FLUJO_LLEGADAS);
+    int vehiculosGenerados = 0;
+    while (vehiculosGenerados < TOTAL_VEHICULOS && tiempo_modelo(&sim.r->reloj) < USEG_TOTAL_SIMULACION) {
+        vehiculosGenerados++;
+
+        if ((vehiculosGenerados - 1) % numProcesos == proceso) {
+            Vehiculo* v = malloc(sizeof(Vehiculo));
+            generar_vehiculo(v, vehiculosGenerados, tiempo_modelo(&sim.r->reloj), semilla);
+
+            contar_llegada(fragmento_del_hilo(&sim.r->contadores), v);
+            __atomic_add_fetch(&sim.r->hilosCreados, 1, __ATOMIC_RELAXED);
+
+            pthread_mutex_lock(&sim.mutexEnCurso);
+            sim.vehiculosEnCurso++;
+            pthread_mutex_unlock(&sim.mutexEnCurso);
+
+            pthread_t hilo;
+            crear_hilo(&hilo, vehiculoThread, v);
+            pthread_detach(hilo);
+        }
+
+        dormir_modelo(&sim.r->reloj, sortear_tiempo_llegada(&llegadas));
+    }
+
+    // Esperar a que salga el último vehículo
+    pthread_mutex_lock(&sim.mutexEnCurso);
+    while (sim.vehiculosEnCurso > 0)
+        pthread_cond_wait(&sim.condFin, &sim.mutexEnCurso);
+    pthread_mutex_unlock(&sim.mutexEnCurso);
+
+    pthread_mutex_destroy(&sim.mutexEnCurso);
+    pthread_cond_destroy(&sim.condFin);
+}
+
+// En el modo con procesos publica el padre, que ve los contadores de todos
+// en el segmento compartido
+static void foto_vivo(void* arg, FotoVivo* foto)
+{
+    (void)arg;
+    foto_de_contadores(foto, &sim.r->contadores);
+    foto->tiempoModelo = tiempo_modelo(&sim.r->reloj);
+}
+
+void ejecutar_motor_hilos(unsigned int semilla, int aceleracion, Estadisticas* est, EsperasHilos* esperas)
+{
+    static RecursosHilos recursos;
+    sim.r = &recursos;
+    inicializar_recursos(0);
+    iniciar_reloj(&sim.r->reloj, aceleracion);
+
+    iniciar_vivo(foto_vivo, NULL);
+    generar_vehiculos(semilla, 0, 1);
+    terminar_vivo();
+
+    juntar_contadores(&sim.r->contadores, est);
+    recoger_esperas(esperas);
+    limpiar_recursos();
+}
+
+void ejecutar_motor_procesos(unsigned int semilla, int aceleracion, int numProcesos, Estadisticas* est,
+                             EsperasHilos* esperas)
+{
+    if (numProcesos <= 0)
+        numProcesos = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (numProcesos < 1)
+        numProcesos = 1;
+
+    // El nombre solo hace falta para abrirlo: se borra en cuanto está mapeado
+    char nombre[64];
+    snprintf(nombre, sizeof(nombre), "/simulador_trafico_%d", (int)getpid());
+    int fd = shm_open(nombre, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        perror("shm_open");
+        exit(1);
+    }
+    if (ftruncate(fd, sizeof(RecursosHilos)) < 0) {
+        perror("ftruncate");
+        shm_unlink(nombre);
+        exit(1);
+    }
+    sim.r = mmap(NULL, sizeof(RecursosHilos), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (sim.r == MAP_FAILED) {
+        perror("mmap");
+        shm_unlink(nombre);
+        exit(1);
+    }
+    close(fd);
+    shm_unlink(nombre);
+
+    inicializar_recursos(1);
+    iniciar_reloj(&sim.r->reloj, aceleracion);  // CLOCK_MONOTONIC vale en todos los procesos
+
+    fflush(stdout);
+    pid_t* hijos = malloc(numProcesos * sizeof(pid_t));
+    for (int p = 0; p < numProcesos; p++) {
+        hijos[p] = fork();
+        if (hijos[p] < 0) {
+            perror("fork");
+            exit(1);
+        }
+        if (hijos[p] == 0) {
+            generar_vehiculos(semilla, p, numProcesos);
+            terminar_registro();
+            _exit(0);
+        }
+    }
+    iniciar_vivo(foto_vivo, NULL);
+    for (int p = 0; p < numProcesos; p++) {
+        int estado;
+        waitpid(hijos[p], &estado, 0);
+        if (!WIFEXITED(estado) || WEXITSTATUS(estado) != 0)
+            fprintf(stderr, "El proceso %d terminó mal; las estadísticas pueden estar incompletas\n", p);
+    }
+    free(hijos);
+    terminar_vivo();
+
+    juntar_contadores(&sim.r->contadores, est);
+    recoger_esperas(esperas);
+    sumar_hilos_creados(sim.r->hilosCreados);
+    limpiar_recursos();
+    munmap(sim.r, sizeof(RecursosHilos));
+}
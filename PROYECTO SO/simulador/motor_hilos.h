@@ -0,0 +1,25 @@
+// Motor de referencia: un pthread por vehículo, como Problema2Gamma2-1.c
+#ifndef MOTOR_HILOS_H
+#define MOTOR_HILOS_H
+
+#include "trafico.h"
+#include "espera_giro.h"
+
+// Cómo fueron las esperas en cada sitio (espera_giro.h): el semáforo de los
+// subtramos sin pesos y los avisos a autos y a camiones de los que tienen
+typedef struct {
+    EstadisticaGiro semaforo[MAX_SUBTRAMOS];
+    EstadisticaGiro autos[MAX_SUBTRAMOS];
+    EstadisticaGiro camiones[MAX_SUBTRAMOS];
+} EsperasHilos;
+
+// aceleracion divide todos los usleep() (1 = el ritmo real del escenario)
+void ejecutar_motor_hilos(unsigned int semilla, int aceleracion, Estadisticas* est, EsperasHilos* esperas);
+
+// Lo mismo con los vehículos repartidos en numProcesos procesos (<= 0: uno
+// por núcleo) que comparten subtramos, hombrillos y estadísticas por
+// memoria compartida con semáforos y mutex entre procesos
+void ejecutar_motor_procesos(unsigned int semilla, int aceleracion, int numProcesos, Estadisticas* est,
+                             EsperasHilos* esperas);
+
+#endif
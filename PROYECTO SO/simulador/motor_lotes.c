@@ -0,0 +1,606 @@
+// Motor por lotes
+//
+// Avanza CARRILES réplicas del motor DES a la vez: en cada paso cada
+// réplica (carril) procesa su siguiente evento del modelo de procesos
+// lógicos (modelo_pl.h), con las mismas reglas, sorteos y orden total
+// (tiempo, profundidad, id, contador) que motor_des.c. Todo el estado está
+// en forma de estructura de arreglos: cada campo es un vector con el valor
+// de cada réplica (VLote), y los eventos pendientes y los vehículos en cola
+// ocupan huecos numerados, un vector por campo y hueco. Con las extensiones
+// vectoriales de GCC eso se compila a SSE2/AVX2/AVX-512 según -march.
+//
+// Un paso no tiene saltos que dependan de cada carril: se calculan todos
+// los casos con máscaras (las comparaciones dan 0 o -1 por carril) y los
+// carriles a los que no les toca no cambian. Eso incluye elegir el
+// siguiente evento, la regla de admisión, las colas de espera, los sorteos
+// (aleatorio() en vectores) y las estadísticas de cada PL.
+//
+// Lo que más cuesta es leer y escribir el hueco de cada carril, que es
+// distinto en cada uno. Por eso el vehículo de un hueco cabe en una sola
+// palabra (datos) y cada hueco tiene solo cinco campos.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "motor_lotes.h"
+#include "modelo_pl.h"
+
+typedef long long VLote __attribute__((vector_size(CARRILES * sizeof(long long))));
+
+// Todas las funciones con vectores se expanden en línea: así no hay
+// llamadas con vectores de argumento, cuyo ABI depende de -march
+#define VECTORIAL static inline __attribute__((always_inline))
+
+#define INFINITO LLONG_MAX
+#define HUECOS_INICIALES 16
+
+// Lugar en una cola de espera: (subtramo, orden de llegada a la cola)
+#define BITS_ORDEN 40
+
+// x % d sin división, exacto para todo x < 2^31 (lo que da aleatorio()):
+// con l = ceil(log2(d)), s = 31 + l y m = ceil(2^s / d), x / d es
+// (x * m) >> s. m tiene hasta 33 bits, así que se multiplica sin signo
+typedef unsigned long long VLoteSinSigno __attribute__((vector_size(CARRILES * sizeof(long long))));
+
+typedef struct {
+    long long d;
+    unsigned long long m;
+    int s;
+} Divisor;
+
+static Divisor rangoLlegada, denCamiones, denSentido;
+
+// El vehículo de un hueco en una palabra; 0 es un hueco libre. Subtramo y
+// hombrillo llevan 7 bits, suficientes para MAX_SUBTRAMOS. Los sorteos (2
+// más uno por subtramo) llevan 7 y el contador de eventos (a lo sumo 4 por
+// subtramo: llega, entra y sale del hombrillo, sale) 9. En los huecos con
+// evento, el tipo de evento va también aquí
+#if MAX_SUBTRAMOS > 64
+#error "Ampliar los campos de datos"
+#endif
+#define CAMPO(d, pos, bits)         (((d) >> (pos)) & ((1LL << (bits)) - 1))
+#define CON_CAMPO(d, pos, bits, x)  (((d) & ~(((1LL << (bits)) - 1) << (pos))) | ((x) << (pos)))
+
+#define D_USADO           1LL
+#define D_EVENTO(d)       CAMPO(d, 1, 2)
+#define D_ACTUAL(d)       CAMPO(d, 3, 7)
+#define D_HOMBRILLO(d)    (CAMPO(d, 10, 7) - 1)
+#define D_TIPO(d)         CAMPO(d, 17, 1)
+#define D_DIR(d)          CAMPO(d, 18, 1)
+#define D_SORTEOS(d)      CAMPO(d, 19, 7)
+#define D_CONTADOR(d)     CAMPO(d, 26, BITS_CONTADOR)
+#define D_ID(d)           CAMPO(d, 35, BITS_ID)
+#define D_CON_EVENTO(d, e)     CON_CAMPO(d, 1, 2, e)
+#define D_CON_ACTUAL(d, x)     CON_CAMPO(d, 3, 7, x)
+#define D_CON_HOMBRILLO(d, h)  CON_CAMPO(d, 10, 7, (h) + 1)
+#define D_CON_SORTEOS(d, n)    CON_CAMPO(d, 19, 7, n)
+#define D_CON_CONTADOR(d, n)   CON_CAMPO(d, 26, BITS_CONTADOR, n)
+#define BITS_CONTADOR 9
+#define BITS_ID 28
+#define MAX_VEHICULOS_LOTE (1LL << BITS_ID)
+
+// (profundidad, id, contador) en una palabra, que ordena igual que
+// comparar_eventos_pl() a igual tiempo. La profundidad no pasa de 2: una
+// salida lleva a una llegada y esta al hombrillo, todo en el mismo instante
+#define ORDEN(profundidad, d) \
+    (((profundidad) << (BITS_ID + BITS_CONTADOR)) | (D_ID(d) << BITS_CONTADOR) | D_CONTADOR(d))
+#define PROFUNDIDAD(orden) ((orden) >> (BITS_ID + BITS_CONTADOR))
+
+typedef struct {
+    // Por hueco: un evento pendiente o un vehículo en una cola
+    VLote* tiempo;        // Del evento; INFINITO si no tiene
+    VLote* orden;
+    VLote* datos;
+    VLote* valor;         // La espera en EV_SALE_HOMBRILLO; en cola, desde cuándo espera
+    VLote* lugar;         // Lugar en una cola; INFINITO si no espera
+    int huecos;
+    int alto;             // Ningún carril usa huecos desde aquí
+
+    // Por réplica
+    VLote carga[MAX_SUBTRAMOS];
+    VLote enCola[MAX_SUBTRAMOS];
+    VLote tiempoLlegada;  // De la próxima llegada a la autopista; INFINITO si no hay más
+    VLote siguienteOrden;
+    VLote generados;
+    VLote semilla;
+    VLote claveLlegadas;  // Del flujo FLUJO_LLEGADAS
+
+    VLote porSubtramo[MAX_SUBTRAMOS][2];
+    VLote completados;
+    VLote esperando[MAX_HOMBRILLOS];
+    VLote maxEspera[MAX_HOMBRILLOS];
+    VLote tiempoMaxEspera[MAX_HOMBRILLOS];
+    VLote tiempoTotalEspera[MAX_HOMBRILLOS];
+    VLote totalEsperado[MAX_HOMBRILLOS];
+    Estadisticas* est[CARRILES];  // Los carriles sin réplica apuntan a sobrante
+    Estadisticas sobrante;
+} Lote;
+
+VECTORIAL VLote repetir(long long x)
+{
+    return (VLote){0} + x;
+}
+
+// Máscara ? a : b, carril a carril
+VECTORIAL VLote elegir(VLote mascara, VLote a, VLote b)
+{
+    return (a & mascara) | (b & ~mascara);
+}
+
+VECTORIAL int alguno(VLote mascara)
+{
+    long long o = 0;
+    for (int c = 0; c < CARRILES; c++)
+        o |= mascara[c];
+    return o != 0;
+}
+
+// campo[k[c]][c] en los carriles de la máscara, 0 en el resto. Como los
+// huecos en uso son pocos, se recorren enteros con vectores en vez de leer
+// carril a carril (mezclar escrituras de un carril con lecturas del vector
+// entero frena mucho más). Con un solo carril se indexa directamente
+VECTORIAL VLote recoger(const Lote* l, const VLote* campo, VLote k, VLote mascara)
+{
+#if CARRILES == 1
+    (void)l;
+    return mascara[0] ? campo[k[0]] : (VLote){0};
+#else
+    VLote r = {0};
+    for (int j = 0; j < l->alto; j++)
+        r |= campo[j] & (k == j);
+    return r & mascara;
+#endif
+}
+
+// campo[k[c]][c] = valor[c] en los carriles de la máscara
+VECTORIAL void repartir(const Lote* l, VLote* campo, VLote k, VLote valor, VLote mascara)
+{
+#if CARRILES == 1
+    (void)l;
+    if (mascara[0])
+        campo[k[0]] = valor;
+#else
+    for (int j = 0; j < l->alto; j++)
+        campo[j] = elegir(mascara & (k == j), valor, campo[j]);
+#endif
+}
+
+// ---------------------------------------------------------------------
+// Huecos
+
+static void crecer_huecos(Lote* l)
+{
+    VLote** campos[] = { &l->tiempo, &l->orden, &l->datos, &l->valor, &l->lugar };
+    int antes = l->huecos;
+    l->huecos = antes ? antes * 2 : HUECOS_INICIALES;
+    for (size_t f = 0; f < sizeof(campos) / sizeof(campos[0]); f++) {
+        VLote* nuevo = aligned_alloc(sizeof(VLote), l->huecos * sizeof(VLote));
+        if (nuevo == NULL) {
+            perror("aligned_alloc");
+            exit(1);
+        }
+        if (antes > 0)
+            memcpy(nuevo, *campos[f], antes * sizeof(VLote));
+        memset(nuevo + antes, 0, (l->huecos - antes) * sizeof(VLote));
+        free(*campos[f]);
+        *campos[f] = nuevo;
+    }
+    for (int k = antes; k < l->huecos; k++) {
+        l->tiempo[k] = repetir(INFINITO);
+        l->lugar[k] = repetir(INFINITO);
+    }
+}
+
+// El primer hueco libre de cada carril, para que los usados queden al
+// principio y los recorridos se paren en l->alto. Un hueco libre tiene
+// datos 0 y tiempo y lugar INFINITO
+VECTORIAL VLote tomar_huecos(Lote* l, VLote mascara)
+{
+    VLote k = repetir(-1);
+    for (int j = l->alto - 1; j >= 0; j--)
+        k = elegir(mascara & (l->datos[j] == 0), repetir(j), k);
+
+    VLote sinHueco = mascara & (k == -1);
+    if (alguno(sinHueco)) {
+        if (l->alto == l->huecos)
+            crecer_huecos(l);
+        k = elegir(sinHueco, repetir(l->alto), k);
+        l->alto++;
+    }
+    return k;
+}
+
+static void liberar_lote(Lote* l)
+{
+    free(l->tiempo);
+    free(l->orden);
+    free(l->datos);
+    free(l->valor);
+    free(l->lugar);
+}
+
+// nuevo_evento() de modelo_pl.c: el evento d en el hueco k
+VECTORIAL void programar(Lote* l, VLote mascara, VLote k, VLote tiempo, VLote profundidad, VLote d)
+{
+    repartir(l, l->tiempo, k, tiempo, mascara);
+    repartir(l, l->orden, k, ORDEN(profundidad, d), mascara);
+    repartir(l, l->datos, k, d, mascara);
+}
+
+// La profundidad de un evento que genera en reloj uno de profundidad prof
+VECTORIAL VLote profundidad_tras(VLote tiempo, VLote reloj, VLote prof)
+{
+    return elegir(tiempo == reloj, prof + 1, repetir(0));
+}
+
+// Cada evento nuevo lleva el siguiente contador de su vehículo
+VECTORIAL VLote contar(VLote d)
+{
+    return D_CON_CONTADOR(d, D_CONTADOR(d) + 1);
+}
+
+// Las máscaras valen -1: restarlas suma uno
+VECTORIAL void encolar_espera(Lote* l, VLote mascara, VLote k, VLote sub, VLote reloj)
+{
+    repartir(l, l->lugar, k, (sub << BITS_ORDEN) | l->siguienteOrden, mascara);
+    repartir(l, l->valor, k, reloj, mascara);
+    l->siguienteOrden -= mascara;
+    for (int i = 0; i < NUM_SUBTRAMOS; i++)
+        l->enCola[i] -= mascara & (sub == i);
+}
+
+// ---------------------------------------------------------------------
+// Sorteos: los flujos de trafico.c, con la semilla de cada carril. Como
+// cada número es una función pura de (clave, sorteo), no hay estado que
+// avanzar solo en los carriles de la máscara
+
+VECTORIAL VLote mezclar_lote(VLoteSinSigno z)
+{
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return (VLote)(z ^ (z >> 31));
+}
+
+// iniciar_flujo()
+VECTORIAL VLote clave_flujo(VLote semilla, VLote flujo)
+{
+    return mezclar_lote((VLoteSinSigno)((semilla << 32) | flujo));
+}
+
+// aleatorio() cuando el flujo ya lleva sorteos - 1 números
+VECTORIAL VLote aleatorio_lote(VLote clave, VLote sorteos)
+{
+    VLoteSinSigno x = (VLoteSinSigno)clave + (VLoteSinSigno)sorteos * 0x9E3779B97F4A7C15ULL;
+    return (VLote)((VLoteSinSigno)mezclar_lote(x) >> 33);
+}
+
+VECTORIAL VLote sortear_tiempo_subtramo_lote(Lote* l, VLote d)
+{
+    VLote r = aleatorio_lote(clave_flujo(l->semilla, D_ID(d)), D_SORTEOS(d) + 1);
+    return ((r & 1) + 1) * USEG_POR_UNIDAD_SUBTRAMO;
+}
+
+VECTORIAL VLote resto(VLote x, const Divisor* div)
+{
+    VLote cociente = (VLote)(((VLoteSinSigno)x * div->m) >> div->s);
+    return x - cociente * div->d;
+}
+
+// El sorteo n de las llegadas va tras generar el vehículo n
+VECTORIAL VLote sortear_tiempo_llegada_lote(Lote* l)
+{
+    return USEG_LLEGADA_MIN + resto(aleatorio_lote(l->claveLlegadas, l->generados), &rangoLlegada);
+}
+
+// ---------------------------------------------------------------------
+// Subtramos y hombrillos
+
+// Peso del vehículo en el subtramo i
+VECTORIAL VLote peso(int i, VLote tipo)
+{
+    return elegir(tipo == AUTO, repetir(autopista.peso[i][AUTO]), repetir(autopista.peso[i][CAMION]));
+}
+
+// Siguiente subtramo y hombrillo intermedio, de las tablas de la autopista
+VECTORIAL void recorrido(VLote dir, VLote actual, VLote* siguiente, VLote* h)
+{
+    VLote ida = (dir == DIR_1A4);
+    *siguiente = (VLote){0};
+    *h = (VLote){0};
+    for (int i = 0; i < NUM_SUBTRAMOS; i++) {
+        VLote m = (actual == i);
+        *siguiente |= m & elegir(ida, repetir(autopista.siguiente[DIR_1A4][i]), repetir(autopista.siguiente[DIR_4A1][i]));
+        *h |= m & elegir(ida, repetir(autopista.hombrillo[DIR_1A4][i]), repetir(autopista.hombrillo[DIR_4A1][i]));
+    }
+}
+
+// Misma regla que puede_entrar_subtramo(); con la política cabe es también
+// la de admite_llegada() y pasa_en_recorrido()
+VECTORIAL VLote puede_entrar(const Lote* l, VLote sub, VLote tipo)
+{
+    VLote r = {0};
+    for (int i = 0; i < NUM_SUBTRAMOS; i++)
+        r |= (sub == i) & (l->carga[i] + peso(i, tipo) <= autopista.capacidad[i]);
+    return r;
+}
+
+VECTORIAL void ocupar(Lote* l, VLote mascara, VLote sub, VLote tipo)
+{
+    for (int i = 0; i < NUM_SUBTRAMOS; i++)
+        l->carga[i] += peso(i, tipo) & mascara & (sub == i);
+}
+
+VECTORIAL void liberar(Lote* l, VLote mascara, VLote sub, VLote tipo)
+{
+    for (int i = 0; i < NUM_SUBTRAMOS; i++)
+        l->carga[i] -= peso(i, tipo) & mascara & (sub == i);
+}
+
+// registrar_entrada_hombrillo()
+VECTORIAL void entrar_hombrillo(Lote* l, VLote mascara, VLote h)
+{
+    for (int i = 0; i < NUM_HOMBRILLOS; i++) {
+        l->esperando[i] -= mascara & (h == i);
+        l->maxEspera[i] = elegir(l->esperando[i] > l->maxEspera[i], l->esperando[i], l->maxEspera[i]);
+    }
+}
+
+// registrar_salida_hombrillo()
+VECTORIAL void salir_hombrillo(Lote* l, VLote mascara, VLote h, VLote espera)
+{
+    for (int i = 0; i < NUM_HOMBRILLOS; i++) {
+        VLote m = mascara & (h == i);
+        l->esperando[i] += m;
+        l->tiempoMaxEspera[i] = elegir(m & (espera > l->tiempoMaxEspera[i]), espera, l->tiempoMaxEspera[i]);
+        l->tiempoTotalEspera[i] += espera & m;
+        l->totalEsperado[i] -= m;
+    }
+}
+
+// admitir() de modelo_pl.c, con el vehículo d del hueco k y la causa en
+// (reloj, prof). El hueco pasa a llevar su EV_SALE; el EV_SALE_HOMBRILLO de
+// los que esperaban en un hombrillo va en otro
+VECTORIAL void admitir(Lote* l, VLote mascara, VLote k, VLote d, VLote reloj, VLote prof, VLote esperaba)
+{
+    VLote sub = D_ACTUAL(d);
+    VLote dir = D_DIR(d);
+    ocupar(l, mascara, sub, D_TIPO(d));
+    for (int i = 0; i < NUM_SUBTRAMOS; i++)
+        for (int j = 0; j < 2; j++)
+            l->porSubtramo[i][j] -= mascara & (sub == i) & (dir == j);
+
+    esperaba &= mascara;
+    if (alguno(esperaba)) {
+        VLote espera = reloj - recoger(l, l->valor, k, esperaba);
+        VLote kh = tomar_huecos(l, esperaba);
+        d = elegir(esperaba, contar(d), d);
+        programar(l, esperaba, kh, reloj, prof + 1, D_CON_EVENTO(d, EV_SALE_HOMBRILLO));
+        repartir(l, l->valor, kh, espera, esperaba);
+    }
+
+    VLote salida = reloj + sortear_tiempo_subtramo_lote(l, d);
+    d = contar(D_CON_SORTEOS(d, D_SORTEOS(d) + 1));
+    programar(l, mascara, k, salida, profundidad_tras(salida, reloj, prof), D_CON_EVENTO(d, EV_SALE));
+}
+
+// Como despertar_cola() de modelo_pl.c: recorre la cola de sub por orden
+// de llegada y admite a todo el que quepa. Cada vuelta avanza un puesto de
+// la cola en todos los carriles a la vez
+VECTORIAL void despertar_colas(Lote* l, VLote mascara, VLote sub, VLote reloj, VLote prof)
+{
+    VLote hayCola = {0};
+    for (int i = 0; i < NUM_SUBTRAMOS; i++)
+        hayCola |= (sub == i) & (l->enCola[i] > 0);
+    mascara &= hayCola;
+
+    // Los lugares de la cola de sub que quedan están entre desde y hasta
+    VLote desde = (sub << BITS_ORDEN) - 1;
+    VLote hasta = (sub + 1) << BITS_ORDEN;
+    while (alguno(mascara)) {
+        VLote mejor = hasta;
+        VLote mejorK = repetir(-1);
+        for (int k = 0; k < l->alto; k++) {
+            VLote lugar = l->lugar[k];
+            VLote candidato = (lugar > desde) & (lugar < mejor);
+            mejor = elegir(candidato, lugar, mejor);
+            mejorK = elegir(candidato, repetir(k), mejorK);
+        }
+        mascara &= (mejorK != -1);
+
+        VLote d = recoger(l, l->datos, mejorK, mascara);
+        VLote entra = mascara & puede_entrar(l, sub, D_TIPO(d));
+        repartir(l, l->lugar, mejorK, repetir(INFINITO), entra);
+        for (int i = 0; i < NUM_SUBTRAMOS; i++)
+            l->enCola[i] += entra & (sub == i);
+        admitir(l, entra, mejorK, d, reloj, prof, D_HOMBRILLO(d) >= 0);
+        desde = elegir(mascara, mejor, desde);
+    }
+}
+
+// ---------------------------------------------------------------------
+// Eventos
+
+// Igual que generar_llegadas_pl(), una llegada cada vez: el vehículo nuevo
+// toma un hueco y su EV_LLEGA se procesa en este mismo paso. AUTO y
+// DIR_1A4 valen 0
+VECTORIAL void generar_llegadas(Lote* l, VLote mascara, VLote reloj, VLote* k, VLote* d)
+{
+    l->generados -= mascara;
+    VLote id = l->generados;
+    VLote claveVehiculo = clave_flujo(l->semilla, id);
+    VLote tipo = (resto(aleatorio_lote(claveVehiculo, repetir(1)), &denCamiones) < escenario.camiones.numerador) & CAMION;
+    VLote dir = (resto(aleatorio_lote(claveVehiculo, repetir(2)), &denSentido) < escenario.sentido4a1.numerador) & DIR_4A1;
+    VLote inicio = elegir(dir == DIR_1A4, repetir(autopista.entrada[DIR_1A4]), repetir(autopista.entrada[DIR_4A1]));
+
+    // registrar_llegada(); el total del día sale de generados al final
+    for (int c = 0; c < CARRILES; c++)
+        if (mascara[c])
+            l->est[c]->estadisticasHorarias[obtener_hora_simulacion(reloj[c])][dir[c]]++;
+
+    // Sin hombrillo: el primer subtramo se espera en la entrada
+    *k = tomar_huecos(l, mascara);
+    *d = D_USADO | (inicio << 3) | (tipo << 17) | (dir << 18) | (2LL << 19) | (id << 35);
+    *d = D_CON_EVENTO(D_CON_HOMBRILLO(*d, -1), EV_LLEGA);
+    repartir(l, l->datos, *k, *d, mascara);
+
+    VLote proxima = reloj + sortear_tiempo_llegada_lote(l);
+    VLote otra = mascara & (l->generados < TOTAL_VEHICULOS) & (proxima < USEG_TOTAL_SIMULACION);
+    l->tiempoLlegada = elegir(otra, proxima, elegir(mascara, repetir(INFINITO), l->tiempoLlegada));
+}
+
+VECTORIAL void procesar_llegadas(Lote* l, VLote mascara, VLote k, VLote d, VLote reloj, VLote prof)
+{
+    VLote sub = D_ACTUAL(d);
+    VLote entra = mascara & puede_entrar(l, sub, D_TIPO(d));
+    admitir(l, entra, k, d, reloj, prof, repetir(0));
+
+    // No cabe: a la cola, y al hombrillo si no viene de la entrada
+    VLote espera = mascara & ~entra;
+    VLote conHombrillo = espera & (D_HOMBRILLO(d) >= 0);
+    if (alguno(conHombrillo)) {
+        VLote kh = tomar_huecos(l, conHombrillo);
+        d = elegir(conHombrillo, contar(d), d);
+        programar(l, conHombrillo, kh, reloj, prof + 1, D_CON_EVENTO(d, EV_ENTRA_HOMBRILLO));
+    }
+    repartir(l, l->datos, k, d, espera);
+    encolar_espera(l, espera, k, sub, reloj);
+}
+
+VECTORIAL void procesar_salidas(Lote* l, VLote mascara, VLote k, VLote d, VLote reloj, VLote prof)
+{
+    VLote actual = D_ACTUAL(d);
+    VLote siguiente, h;
+    recorrido(D_DIR(d), actual, &siguiente, &h);
+    liberar(l, mascara, actual, D_TIPO(d));
+
+    VLote termina = mascara & (siguiente < 0);
+    l->completados -= termina;
+    repartir(l, l->datos, k, repetir(0), termina);
+
+    // llegada_tras_salida()
+    VLote sigue = mascara & ~termina;
+    VLote llegada = contar(D_CON_HOMBRILLO(D_CON_ACTUAL(d, siguiente), h));
+    programar(l, sigue, k, reloj, prof + 1, D_CON_EVENTO(llegada, EV_LLEGA));
+
+    despertar_colas(l, mascara, actual, reloj, prof);
+}
+
+// ---------------------------------------------------------------------
+
+static void simular_lote(Lote* l)
+{
+    for (;;) {
+        // Siguiente evento de cada réplica: la llegada a la autopista (de
+        // profundidad y contador 0) o el menor hueco
+        VLote mejorTiempo = l->tiempoLlegada;
+        VLote mejorOrden = (l->generados + 1) << BITS_CONTADOR;
+        VLote mejorK = repetir(-1);
+        for (int k = 0; k < l->alto; k++) {
+            VLote t = l->tiempo[k];
+            VLote menor = (t < mejorTiempo) | ((t == mejorTiempo) & (l->orden[k] < mejorOrden));
+            mejorTiempo = elegir(menor, t, mejorTiempo);
+            mejorOrden = elegir(menor, l->orden[k], mejorOrden);
+            mejorK = elegir(menor, repetir(k), mejorK);
+        }
+
+        VLote activo = (mejorTiempo != INFINITO);
+        if (!alguno(activo))
+            break;
+        // Los carriles que ya terminaron no cambian; con reloj 0 sus
+        // cuentas no desbordan
+        VLote reloj = mejorTiempo & activo;
+        VLote prof = PROFUNDIDAD(mejorOrden);
+        VLote esLlegada = activo & (mejorK == -1);
+        VLote esHueco = activo & ~esLlegada;
+        VLote d = recoger(l, l->datos, mejorK, esHueco);
+        repartir(l, l->tiempo, mejorK, repetir(INFINITO), esHueco);
+        if (alguno(esLlegada)) {
+            VLote k, nuevo;
+            generar_llegadas(l, esLlegada, reloj, &k, &nuevo);
+            mejorK = elegir(esLlegada, k, mejorK);
+            d = elegir(esLlegada, nuevo, d);
+        }
+
+        // Cada carril procesa un solo evento: los grupos son disjuntos
+        VLote evento = D_EVENTO(d);
+        VLote llega = activo & (evento == EV_LLEGA);
+        VLote sale = activo & (evento == EV_SALE);
+        VLote entraHombrillo = activo & (evento == EV_ENTRA_HOMBRILLO);
+        VLote saleHombrillo = activo & (evento == EV_SALE_HOMBRILLO);
+        if (alguno(llega))
+            procesar_llegadas(l, llega, mejorK, d, reloj, prof);
+        if (alguno(sale))
+            procesar_salidas(l, sale, mejorK, d, reloj, prof);
+        if (alguno(entraHombrillo | saleHombrillo)) {
+            entrar_hombrillo(l, entraHombrillo, D_HOMBRILLO(d));
+            salir_hombrillo(l, saleHombrillo, D_HOMBRILLO(d), recoger(l, l->valor, mejorK, saleHombrillo));
+            repartir(l, l->datos, mejorK, repetir(0), entraHombrillo | saleHombrillo);
+        }
+    }
+}
+
+static Divisor preparar_divisor(long long d)
+{
+    Divisor div = { d, 0, 31 };
+    while ((1LL << (div.s - 31)) < d)
+        div.s++;
+    div.m = ((1ULL << div.s) + d - 1) / d;
+    return div;
+}
+
+static void preparar_escenario()
+{
+    if (TOTAL_VEHICULOS >= MAX_VEHICULOS_LOTE) {
+        fprintf(stderr, "motor_lotes: no caben %d vehículos en los %d bits del id\n", TOTAL_VEHICULOS, BITS_ID);
+        exit(1);
+    }
+    rangoLlegada = preparar_divisor(USEG_LLEGADA_RANGO);
+    denCamiones = preparar_divisor(escenario.camiones.denominador);
+    denSentido = preparar_divisor(escenario.sentido4a1.denominador);
+}
+
+void ejecutar_motor_lotes(const unsigned int* semillas, int numReplicas, Estadisticas* resultados)
+{
+    preparar_escenario();
+    for (int primera = 0; primera < numReplicas; primera += CARRILES) {
+        static Lote lote;
+        Lote* l = &lote;
+        memset(l, 0, sizeof(*l));
+        crecer_huecos(l);
+
+        // La primera llegada va en t=0
+        l->tiempoLlegada = repetir(INFINITO);
+        for (int c = 0; c < CARRILES; c++) {
+            l->est[c] = &l->sobrante;
+            if (primera + c < numReplicas) {
+                l->est[c] = &resultados[primera + c];
+                iniciar_estadisticas(l->est[c]);
+                l->semilla[c] = semillas[primera + c];
+                if (TOTAL_VEHICULOS > 0)
+                    l->tiempoLlegada[c] = 0;
+            }
+        }
+        l->claveLlegadas = clave_flujo(l->semilla, repetir(FLUJO_LLEGADAS));
+
+        simular_lote(l);
+
+        for (int c = 0; c < CARRILES && primera + c < numReplicas; c++) {
+            Estadisticas* est = l->est[c];
+            for (int i = 0; i < NUM_SUBTRAMOS; i++)
+                for (int j = 0; j < 2; j++)
+                    est->estadisticasSubtramos[i][j] = (int)l->porSubtramo[i][j][c];
+            for (int i = 0; i < NUM_HOMBRILLOS; i++) {
+                EstadisticaHombrillo* h = &est->hombrillos[i];
+                h->vehiculosEsperando = (int)l->esperando[i][c];
+                h->maxEspera = (int)l->maxEspera[i][c];
+                h->tiempoMaxEspera = l->tiempoMaxEspera[i][c];
+                h->tiempoTotalEspera = l->tiempoTotalEspera[i][c];
+                h->totalVehiculosEsperado = (int)l->totalEsperado[i][c];
+            }
+            est->totalVehiculosDia = (int)l->generados[c];
+            est->vehiculosCompletados = (int)l->completados[c];
+        }
+        liberar_lote(l);
+    }
+}
@@ -0,0 +1,25 @@
+// Motor por lotes: varias réplicas del motor DES a la vez, en carriles SIMD
+#ifndef MOTOR_LOTES_H
+#define MOTOR_LOTES_H
+
+#include "trafico.h"
+
+// Réplicas que avanzan juntas: un registro entero de carriles de 64 bits
+// según lo que permita -march. Con -DCARRILES=1 el mismo código queda
+// escalar (la versión de respaldo)
+#ifndef CARRILES
+#if defined(__AVX512F__)
+#define CARRILES 8
+#elif defined(__AVX2__)
+#define CARRILES 4
+#else
+#define CARRILES 2
+#endif
+#endif
+
+// Simula un día por semilla; resultados[r] es igual a lo que deja
+// ejecutar_motor_des(semillas[r], ...). Solo con la política cabe: la
+// regla de admisión va en vectores y no consulta politicaAdmision
+void ejecutar_motor_lotes(const unsigned int* semillas, int numReplicas, Estadisticas* resultados);
+
+#endif
@@ -0,0 +1,347 @@
+// Motor con pool fijo de hilos
+//
+// El cuerpo de vehiculoThread se reescribe como una máquina de estados que
+// se puede reanudar:
+//
+//   ENTRANDO      -> espera (sin hilo) a que el primer subtramo tenga espacio
+//   CIRCULANDO    -> está en la lista de temporizadores hasta que acabe su subtramo
+//   EN_HOMBRILLO  -> espera (sin hilo) en la cola del siguiente subtramo
+//   SALIENDO      -> terminó el recorrido
+//
+// Un vehículo solo vuelve a la cola de listos cuando vence su temporizador o
+// cuando otro vehículo, al liberar un subtramo, le reserva el espacio. Así
+// ningún hilo del pool se bloquea nunca en un semáforo de subtramo.
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "motor_pool.h"
+#include "cola_eventos.h"
+#include "reloj.h"
+#include "metricas.h"
+#include "contadores.h"
+#include "registro.h"
+#include "vivo.h"
+#include "politica.h"
+
+typedef enum { ENTRANDO, CIRCULANDO, EN_HOMBRILLO, SALIENDO } EstadoVehiculo;
+
+typedef struct VehiculoPool {
+    Vehiculo v;
+    EstadoVehiculo estado;
+    int actual;
+    int hombrillo;
+    int admitido;                // Otro vehículo ya le reservó el subtramo actual
+    tiempo_us inicioEspera;
+    struct VehiculoPool* sig;    // Enlace en la cola de listos o de espera
+} VehiculoPool;
+
+typedef struct {
+    VehiculoPool* primero;
+    VehiculoPool* ultimo;
+} ColaVehiculos;
+
+typedef struct {
+    EstadoSubtramo estado[MAX_SUBTRAMOS];
+    ColaVehiculos espera[MAX_SUBTRAMOS];
+    int esperando[MAX_SUBTRAMOS][2];             // Los de espera[i] por tipo, para la política
+    pthread_mutex_t mutexTramo[MAX_SUBTRAMOS];   // Protege estado[i], espera[i] y esperando[i]
+
+    // Planificador: vehículos listos y vehículos circulando (por instante de salida)
+    ColaVehiculos listos;
+    ListaEventos circulando;
+    pthread_mutex_t mutexPlan;
+    pthread_cond_t condPlan;
+    int vehiculosEnCurso;
+    int generacionTerminada;
+
+    ContadoresRepartidos contadores;
+    RelojReal reloj;
+} SimulacionPool;
+
+static SimulacionPool sim;
+
+static void encolar(ColaVehiculos* c, VehiculoPool* veh)
+{
+    veh->sig = NULL;
+    if (c->ultimo)
+        c->ultimo->sig = veh;
+    else
+        c->primero = veh;
+    c->ultimo = veh;
+}
+
+static VehiculoPool* desencolar(ColaVehiculos* c)
+{
+    VehiculoPool* veh = c->primero;
+    c->primero = veh->sig;
+    if (c->primero == NULL)
+        c->ultimo = NULL;
+    return veh;
+}
+
+static void poner_listo(VehiculoPool* veh)
+{
+    pthread_mutex_lock(&sim.mutexPlan);
+    encolar(&sim.listos, veh);
+    pthread_cond_signal(&sim.condPlan);
+    pthread_mutex_unlock(&sim.mutexPlan);
+}
+
+// Intenta ocupar el subtramo idx. Si no cabe, el vehículo queda en la cola
+// de espera del subtramo (en el hombrillo h, o en la entrada si h < 0) y el
+// hilo que lo ejecutaba queda libre para otro vehículo
+static int intentar_entrar(VehiculoPool* veh, int idx, int h)
+{
+    pthread_mutex_lock(&sim.mutexTramo[idx]);
+    if (admite_llegada(&sim.estado[idx], veh->v.tipo, sim.esperando[idx])) {
+        ocupar_subtramo(&sim.estado[idx], veh->v.tipo);
+        pthread_mutex_unlock(&sim.mutexTramo[idx]);
+        return 1;
+    }
+
+    // Registrar la espera antes de encolarlo: desde que está en la cola
+    // cualquier hilo puede reanudarlo
+    if (h >= 0) {
+        veh->estado = EN_HOMBRILLO;
+        veh->hombrillo = h;
+        veh->inicioEspera = tiempo_modelo(&sim.reloj);
+        REGISTRAR(REG_LLENO, &veh->v, veh->inicioEspera, idx, h);
+        contar_entrada_hombrillo(&sim.contadores, h);
+    }
+    encolar(&sim.espera[idx], veh);
+    sim.esperando[idx][veh->v.tipo]++;
+    pthread_mutex_unlock(&sim.mutexTramo[idx]);
+    return 0;
+}
+
+// Libera el subtramo y reserva el espacio a los que esperan, ahora caben y
+// deja pasar la política
+static void salir_del_subtramo(VehiculoPool* veh)
+{
+    int idx = veh->actual;
+    pthread_mutex_lock(&sim.mutexTramo[idx]);
+    liberar_subtramo(&sim.estado[idx], veh->v.tipo);
+
+    ColaVehiculos* c = &sim.espera[idx];
+    VehiculoPool* anterior = NULL;
+    VehiculoPool* w = c->primero;
+    RecorridoCola r;
+    empezar_recorrido(&r, sim.esperando[idx]);
+    while (w) {
+        VehiculoPool* sig = w->sig;
+        if (pasa_en_recorrido(&r, &sim.estado[idx], w->v.tipo)) {
+            if (anterior)
+                anterior->sig = sig;
+            else
+                c->primero = sig;
+            if (c->ultimo == w)
+                c->ultimo = anterior;
+
+            ocupar_subtramo(&sim.estado[idx], w->v.tipo);
+            w->admitido = 1;
+            poner_listo(w);
+        } else {
+            anterior = w;
+        }
+        w = sig;
+    }
+    pthread_mutex_unlock(&sim.mutexTramo[idx]);
+}
+
+static void empezar_a_circular(VehiculoPool* veh)
+{
+    contar_subtramo(fragmento_del_hilo(&sim.contadores), veh->actual, veh->v.dir);
+
+    veh->estado = CIRCULANDO;
+    veh->admitido = 0;
+    tiempo_us ahora = tiempo_modelo(&sim.reloj);
+    tiempo_us recorrido = sortear_tiempo_subtramo(&veh->v);
+    tiempo_us salida = ahora + recorrido;
+    REGISTRAR(REG_ENTRA, &veh->v, ahora, veh->actual, 0);
+    REGISTRAR(REG_CIRCULA, &veh->v, ahora, veh->actual, recorrido);
+
+    pthread_mutex_lock(&sim.mutexPlan);
+    programar_evento(&sim.circulando, salida, 0, veh);
+    pthread_cond_signal(&sim.condPlan);
+    pthread_mutex_unlock(&sim.mutexPlan);
+}
+
+static void terminar_vehiculo(VehiculoPool* veh)
+{
+    veh->estado = SALIENDO;
+    REGISTRAR(REG_TERMINA, &veh->v, tiempo_modelo(&sim.reloj), 0, 0);
+    contar_completado(fragmento_del_hilo(&sim.contadores));
+    free(veh);
+
+    pthread_mutex_lock(&sim.mutexPlan);
+    if (--sim.vehiculosEnCurso == 0 && sim.generacionTerminada)
+        pthread_cond_broadcast(&sim.condPlan);
+    pthread_mutex_unlock(&sim.mutexPlan);
+}
+
+// Ejecuta un paso de la máquina de estados del vehículo
+static void avanzar_vehiculo(VehiculoPool* veh)
+{
+    switch (veh->estado) {
+    case ENTRANDO:
+        if (!veh->admitido && !intentar_entrar(veh, veh->actual, -1))
+            return;
+        empezar_a_circular(veh);
+        break;
+
+    case CIRCULANDO: {
+        int i = veh->actual;
+        int siguiente = autopista.siguiente[veh->v.dir][i];
+        salir_del_subtramo(veh);
+        contar_salida_subtramo(fragmento_del_hilo(&sim.contadores), i);
+        REGISTRAR(REG_SALE, &veh->v, tiempo_modelo(&sim.reloj), i, 0);
+        if (siguiente < 0) {
+            terminar_vehiculo(veh);
+            return;
+        }
+        veh->actual = siguiente;
+        if (!intentar_entrar(veh, siguiente, autopista.hombrillo[veh->v.dir][i]))
+            return;
+        empezar_a_circular(veh);
+        break;
+    }
+
+    case EN_HOMBRILLO: {
+        // Solo se reanuda cuando ya tiene el subtramo reservado
+        int h = veh->hombrillo;
+        tiempo_us espera = tiempo_modelo(&sim.reloj) - veh->inicioEspera;
+        REGISTRAR(REG_ESPERO, &veh->v, veh->inicioEspera + espera, h, espera);
+        contar_salida_hombrillo(&sim.contadores, fragmento_del_hilo(&sim.contadores), h, espera);
+        empezar_a_circular(veh);
+        break;
+    }
+
+    case SALIENDO:
+        break;
+    }
+}
+
+static void* trabajador(void* arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&sim.mutexPlan);
+    for (;;) {
+        // Pasar a listos los vehículos que ya terminaron de circular
+        tiempo_us ahora = tiempo_modelo(&sim.reloj);
+        while (sim.circulando.cantidad > 0 && sim.circulando.eventos[0].tiempo <= ahora)
+            encolar(&sim.listos, extraer_evento(&sim.circulando).dato);
+
+        if (sim.listos.primero) {
+            VehiculoPool* veh = desencolar(&sim.listos);
+            pthread_mutex_unlock(&sim.mutexPlan);
+            avanzar_vehiculo(veh);
+            pthread_mutex_lock(&sim.mutexPlan);
+            continue;
+        }
+
+        if (sim.generacionTerminada && sim.vehiculosEnCurso == 0)
+            break;
+
+        if (sim.circulando.cantidad > 0) {
+            struct timespec ts = instante_real(&sim.reloj, sim.circulando.eventos[0].tiempo);
+            pthread_cond_timedwait(&sim.condPlan, &sim.mutexPlan, &ts);
+        } else {
+            pthread_cond_wait(&sim.condPlan, &sim.mutexPlan);
+        }
+    }
+    pthread_mutex_unlock(&sim.mutexPlan);
+    return NULL;
+}
+
+static void inicializar_recursos()
+{
+    inicializar_subtramos(sim.estado);
+    for (int i = 0; i < NUM_SUBTRAMOS; i++) {
+        pthread_mutex_init(&sim.mutexTramo[i], NULL);
+        sim.espera[i].primero = sim.espera[i].ultimo = NULL;
+        sim.esperando[i][AUTO] = sim.esperando[i][CAMION] = 0;
+    }
+    iniciar_contadores(&sim.contadores);
+
+    // Los plazos de pthread_cond_timedwait van en CLOCK_MONOTONIC, como el reloj
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&sim.condPlan, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_mutex_init(&sim.mutexPlan, NULL);
+
+    sim.listos.primero = sim.listos.ultimo = NULL;
+    sim.vehiculosEnCurso = 0;
+    sim.generacionTerminada = 0;
+}
+
+static void limpiar_recursos()
+{
+    for (int i = 0; i < NUM_SUBTRAMOS; i++)
+        pthread_mutex_destroy(&sim.mutexTramo[i]);
+    pthread_mutex_destroy(&sim.mutexPlan);
+    pthread_cond_destroy(&sim.condPlan);
+    liberar_lista_eventos(&sim.circulando);
+}
+
+static void foto_vivo(void* arg, FotoVivo* foto)
+{
+    (void)arg;
+    foto_de_contadores(foto, &sim.contadores);
+    foto->tiempoModelo = tiempo_modelo(&sim.reloj);
+}
+
+void ejecutar_motor_pool(unsigned int semilla, int aceleracion, int numHilos, Estadisticas* est)
+{
+    if (numHilos <= 0)
+        numHilos = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (numHilos <= 0)
+        numHilos = 1;
+
+    inicializar_recursos();
+    iniciar_reloj(&sim.reloj, aceleracion);
+
+    pthread_t* pool = malloc(numHilos * sizeof(pthread_t));
+    for (int i = 0; i < numHilos; i++)
+        crear_hilo(&pool[i], trabajador, NULL);
+    iniciar_vivo(foto_vivo, NULL);
+
+    FlujoAleatorio llegadas;
+    iniciar_flujo(&llegadas, semilla, FLUJO_LLEGADAS);
+    int vehiculosGenerados = 0;
+    while (vehiculosGenerados < TOTAL_VEHICULOS && tiempo_modelo(&sim.reloj) < USEG_TOTAL_SIMULACION) {
+        VehiculoPool* veh = malloc(sizeof(VehiculoPool));
+        generar_vehiculo(&veh->v, vehiculosGenerados + 1, tiempo_modelo(&sim.reloj), semilla);
+        veh->estado = ENTRANDO;
+        veh->admitido = 0;
+        veh->hombrillo = -1;
+        veh->actual = autopista.entrada[veh->v.dir];
+
+        contar_llegada(fragmento_del_hilo(&sim.contadores), &veh->v);
+        REGISTRAR(REG_INICIA, &veh->v, veh->v.horaEntrada, veh->actual, 0);
+
+        pthread_mutex_lock(&sim.mutexPlan);
+        sim.vehiculosEnCurso++;
+        encolar(&sim.listos, veh);
+        pthread_cond_signal(&sim.condPlan);
+        pthread_mutex_unlock(&sim.mutexPlan);
+
+        vehiculosGenerados++;
+        dormir_modelo(&sim.reloj, sortear_tiempo_llegada(&llegadas));
+    }
+
+    pthread_mutex_lock(&sim.mutexPlan);
+    sim.generacionTerminada = 1;
+    pthread_cond_broadcast(&sim.condPlan);
+    pthread_mutex_unlock(&sim.mutexPlan);
+
+    for (int i = 0; i < numHilos; i++)
+        pthread_join(pool[i], NULL);
+    free(pool);
+    terminar_vivo();
+    juntar_contadores(&sim.contadores, est);
+    limpiar_recursos();
+}
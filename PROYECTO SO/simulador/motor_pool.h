@@ -0,0 +1,10 @@
+// Motor con un pool fijo de hilos que mueve los vehículos como máquinas de estado
+#ifndef MOTOR_POOL_H
+#define MOTOR_POOL_H
+
+#include "trafico.h"
+
+// numHilos <= 0 usa un hilo por núcleo
+void ejecutar_motor_pool(unsigned int semilla, int aceleracion, int numHilos, Estadisticas* est);
+
+#endif
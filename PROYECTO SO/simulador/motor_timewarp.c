@@ -0,0 +1,577 @@
+// Motor Time Warp
+//
+// Cada subtramo y cada hombrillo es un proceso lógico (PL) con su propio
+// reloj virtual. Los hilos procesan los eventos de sus PL sin esperar a los
+// demás; si llega un evento del pasado (rezagado) o la anulación de uno ya
+// procesado, el PL restaura el estado que guardó antes de cada evento y
+// envía antimensajes por todo lo que había enviado desde entonces.
+//
+// El modelo (modelo_pl.h) define un orden total de los eventos que no
+// depende del reparto. Con un solo hilo los PL se procesan en ese orden
+// global sin retroceder nunca. Con cualquier número de hilos el día es el
+// mismo que el del motor des, que es la ejecución secuencial de referencia.
+//
+// GVT: cuando un hilo lo pide, todos se detienen en una barrera, vacían los
+// buzones hasta que no queda nada en vuelo y el GVT es el menor tiempo
+// pendiente. Lo anterior al GVT ya no puede deshacerse y se libera. Ningún
+// PL se adelanta más de VENTANA_TW al GVT, para acotar los retrocesos.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "motor_timewarp.h"
+#include "modelo_pl.h"
+#include "buzon.h"
+#include "metricas.h"
+
+#define VENTANA_TW (USEG_POR_SEGUNDO / 2)   // Adelanto máximo sobre el GVT
+#define GVT_PERIODO 4096                     // Eventos por hilo entre rondas de GVT
+#define CAPACIDAD_BUZON_TW (1 << 16)
+#define TIEMPO_INFINITO LLONG_MAX
+
+#define NUM_PROCESOS NUM_PROCESOS_LOGICOS
+
+enum { MSG_EVENTO, MSG_DESPERTAR };
+
+typedef struct EventoTW {
+    EventoPL e;
+    int anti;                 // Antimensaje: anula el evento con el mismo uid
+    unsigned long long uid;
+    struct EventoTW* ant;
+    struct EventoTW* sig;
+} EventoTW;
+
+typedef struct {
+    int destino;
+    unsigned long long uid;
+} Enviado;
+
+typedef struct Procesado {
+    EventoTW* ev;
+    int esLlegada;
+    EstadoPL antes;
+    Enviado* enviados;
+    int numEnviados;
+    int capEnviados;
+    struct Procesado* ant;
+    struct Procesado* sig;
+} Procesado;
+
+typedef struct {
+    int indice;
+    int hilo;
+    EstadoPL estado;
+    EventoTW* primeroPendiente;   // Ordenados por clave
+    EventoTW* ultimoPendiente;
+    EventoTW* llegadas;           // Llegadas desde fuera, fijas y ordenadas
+    int numLlegadas;
+    int siguienteLlegada;
+    Procesado* primeroProc;       // En orden de procesamiento
+    Procesado* ultimoProc;
+    Procesado* actual;            // Evento en curso (para anotar lo enviado)
+    unsigned long long enviados;
+    long procesados;
+    long deshechos;
+    long retrocesos;
+} ProcesoLogico;
+
+typedef struct {
+    int indice;
+    Buzon buzon;
+    EventoTW* bandejaPrimero;     // Mensajes a PL del mismo hilo
+    EventoTW* bandejaUltimo;
+    int desdeGVT;
+    pthread_t hilo;
+} __attribute__((aligned(64))) HiloTW;
+
+static struct {
+    ProcesoLogico procesos[MAX_PROCESOS_LOGICOS];
+    HiloTW* hilos;
+    int numHilos;
+    pthread_barrier_t barrera;
+    tiempo_us* minimos;
+    tiempo_us gvt;
+    int gvtPedido;
+    long enVuelo;                 // Enviados por buzón y aún no recibidos
+    long rondas;
+} tw;
+
+static void* reservar(size_t n)
+{
+    void* p = malloc(n);
+    if (p == NULL) {
+        perror("malloc");
+        exit(1);
+    }
+    return p;
+}
+
+static int comparar(const EventoTW* a, const EventoTW* b)
+{
+    return comparar_eventos_pl(&a->e, &b->e);
+}
+
+// ---------------------------------------------------------------------
+// Colas de un PL
+
+static void insertar_pendiente(ProcesoLogico* pl, EventoTW* ev)
+{
+    // Casi siempre va al final: se busca desde atrás
+    EventoTW* p = pl->ultimoPendiente;
+    while (p && comparar(p, ev) > 0)
+        p = p->ant;
+    ev->ant = p;
+    ev->sig = p ? p->sig : pl->primeroPendiente;
+    if (ev->sig)
+        ev->sig->ant = ev;
+    else
+        pl->ultimoPendiente = ev;
+    if (p)
+        p->sig = ev;
+    else
+        pl->primeroPendiente = ev;
+}
+
+static void quitar_pendiente(ProcesoLogico* pl, EventoTW* ev)
+{
+    if (ev->ant)
+        ev->ant->sig = ev->sig;
+    else
+        pl->primeroPendiente = ev->sig;
+    if (ev->sig)
+        ev->sig->ant = ev->ant;
+    else
+        pl->ultimoPendiente = ev->ant;
+    ev->ant = ev->sig = NULL;
+}
+
+static EventoTW* siguiente_evento(ProcesoLogico* pl, int* esLlegada)
+{
+    EventoTW* p = pl->primeroPendiente;
+    EventoTW* l = (pl->siguienteLlegada < pl->numLlegadas) ? &pl->llegadas[pl->siguienteLlegada] : NULL;
+    *esLlegada = (l && (p == NULL || comparar(l, p) < 0));
+    return *esLlegada ? l : p;
+}
+
+static tiempo_us tiempo_siguiente(ProcesoLogico* pl)
+{
+    int esLlegada;
+    EventoTW* ev = siguiente_evento(pl, &esLlegada);
+    return ev ? ev->e.tiempo : TIEMPO_INFINITO;
+}
+
+// ---------------------------------------------------------------------
+// Envío de mensajes
+
+static void encaminar(HiloTW* h, EventoTW* ev)
+{
+    int destino = tw.procesos[ev->e.destino].hilo;
+    if (destino == h->indice) {
+        ev->sig = NULL;
+        if (h->bandejaUltimo)
+            h->bandejaUltimo->sig = ev;
+        else
+            h->bandejaPrimero = ev;
+        h->bandejaUltimo = ev;
+    } else {
+        __atomic_add_fetch(&tw.enVuelo, 1, __ATOMIC_SEQ_CST);
+        buzon_enviar(&tw.hilos[destino].buzon, MSG_EVENTO, ev, 0);
+    }
+}
+
+typedef struct {
+    HiloTW* h;
+    ProcesoLogico* pl;
+} ContextoEnvio;
+
+// Recibe los eventos que genera el modelo: les da un uid, los anota para
+// poder anularlos y los encamina
+static void enviar(void* ctx, const EventoPL* e)
+{
+    ContextoEnvio* c = (ContextoEnvio*)ctx;
+    EventoTW* ev = reservar(sizeof(EventoTW));
+    ev->e = *e;
+    ev->anti = 0;
+    ev->uid = ((unsigned long long)(c->pl->indice + 1) << 40) | ++c->pl->enviados;
+    ev->ant = ev->sig = NULL;
+
+    Procesado* p = c->pl->actual;
+    if (p->numEnviados == p->capEnviados) {
+        p->capEnviados = p->capEnviados ? p->capEnviados * 2 : 4;
+        p->enviados = realloc(p->enviados, p->capEnviados * sizeof(Enviado));
+        if (p->enviados == NULL) {
+            perror("realloc");
+            exit(1);
+        }
+    }
+    p->enviados[p->numEnviados].destino = e->destino;
+    p->enviados[p->numEnviados].uid = ev->uid;
+    p->numEnviados++;
+
+    encaminar(c->h, ev);
+}
+
+static void enviar_anti(HiloTW* h, int destino, unsigned long long uid)
+{
+    EventoTW* ev = reservar(sizeof(EventoTW));
+    memset(ev, 0, sizeof(EventoTW));
+    ev->anti = 1;
+    ev->e.destino = destino;
+    ev->uid = uid;
+    encaminar(h, ev);
+}
+
+// ---------------------------------------------------------------------
+// Procesar, deshacer y anular
+
+static void procesar(HiloTW* h, ProcesoLogico* pl)
+{
+    int esLlegada;
+    EventoTW* ev = siguiente_evento(pl, &esLlegada);
+    if (esLlegada)
+        pl->siguienteLlegada++;
+    else
+        quitar_pendiente(pl, ev);
+
+    Procesado* p = reservar(sizeof(Procesado));
+    p->ev = ev;
+    p->esLlegada = esLlegada;
+    copiar_estado_pl(&p->antes, &pl->estado);
+    p->enviados = NULL;
+    p->numEnviados = p->capEnviados = 0;
+    p->sig = NULL;
+    p->ant = pl->ultimoProc;
+    if (pl->ultimoProc)
+        pl->ultimoProc->sig = p;
+    else
+        pl->primeroProc = p;
+    pl->ultimoProc = p;
+
+    pl->actual = p;
+    ContextoEnvio ctx = { h, pl };
+    manejar_evento_pl(&pl->estado, pl->indice, &ev->e, enviar, &ctx);
+    pl->actual = NULL;
+    pl->procesados++;
+}
+
+static void deshacer_ultimo(HiloTW* h, ProcesoLogico* pl)
+{
+    Procesado* p = pl->ultimoProc;
+    pl->ultimoProc = p->ant;
+    if (pl->ultimoProc)
+        pl->ultimoProc->sig = NULL;
+    else
+        pl->primeroProc = NULL;
+
+    liberar_estado_pl(&pl->estado);
+    pl->estado = p->antes;
+    for (int k = 0; k < p->numEnviados; k++)
+        enviar_anti(h, p->enviados[k].destino, p->enviados[k].uid);
+    if (p->esLlegada)
+        pl->siguienteLlegada--;
+    else
+        insertar_pendiente(pl, p->ev);
+
+    pl->deshechos++;
+    free(p->enviados);
+    free(p);
+}
+
+// Deshace los eventos procesados posteriores a ref (y ref mismo si incluido)
+static void retroceder(HiloTW* h, ProcesoLogico* pl, const EventoTW* ref, int incluido)
+{
+    pl->retrocesos++;
+    while (pl->ultimoProc) {
+        int c = comparar(pl->ultimoProc->ev, ref);
+        if (c < 0 || (c == 0 && !incluido))
+            break;
+        deshacer_ultimo(h, pl);
+    }
+}
+
+static void anular(HiloTW* h, ProcesoLogico* pl, unsigned long long uid)
+{
+    for (EventoTW* ev = pl->primeroPendiente; ev; ev = ev->sig) {
+        if (ev->uid == uid) {
+            quitar_pendiente(pl, ev);
+            free(ev);
+            return;
+        }
+    }
+    // Ya procesado: volver a antes de él. Los mensajes de un mismo origen
+    // llegan en orden, así que el positivo siempre llegó antes que su anti
+    for (Procesado* p = pl->ultimoProc; p; p = p->ant) {
+        if (!p->esLlegada && p->ev->uid == uid) {
+            EventoTW* ev = p->ev;
+            retroceder(h, pl, ev, 1);
+            quitar_pendiente(pl, ev);
+            free(ev);
+            return;
+        }
+    }
+    fprintf(stderr, "Time Warp: antimensaje %llx sin evento en el proceso %d\n", uid, pl->indice);
+    exit(1);
+}
+
+static void entregar(HiloTW* h, EventoTW* ev)
+{
+    ProcesoLogico* pl = &tw.procesos[ev->e.destino];
+    if (ev->anti) {
+        anular(h, pl, ev->uid);
+        free(ev);
+        return;
+    }
+    if (pl->ultimoProc && comparar(ev, pl->ultimoProc->ev) < 0)
+        retroceder(h, pl, ev, 0);  // Rezagado
+    insertar_pendiente(pl, ev);
+}
+
+// Entrega todo lo que haya en la bandeja local y en el buzón
+static int entregar_mensajes(HiloTW* h)
+{
+    int entregados = 0;
+    for (;;) {
+        EventoTW* ev = h->bandejaPrimero;
+        if (ev) {
+            h->bandejaPrimero = ev->sig;
+            if (h->bandejaPrimero == NULL)
+                h->bandejaUltimo = NULL;
+            entregar(h, ev);
+            entregados++;
+            continue;
+        }
+        Mensaje m;
+        if (!buzon_recibir(&h->buzon, &m))
+            break;
+        if (m.tipo == MSG_EVENTO) {
+            __atomic_sub_fetch(&tw.enVuelo, 1, __ATOMIC_SEQ_CST);
+            entregar(h, m.dato);
+            entregados++;
+        }
+    }
+    return entregados;
+}
+
+// ---------------------------------------------------------------------
+// GVT
+
+static void pedir_gvt(HiloTW* h)
+{
+    if (__atomic_exchange_n(&tw.gvtPedido, 1, __ATOMIC_SEQ_CST) == 0) {
+        for (int i = 0; i < tw.numHilos; i++)
+            if (i != h->indice)
+                buzon_enviar(&tw.hilos[i].buzon, MSG_DESPERTAR, NULL, 0);
+    }
+}
+
+// Libera lo procesado antes del GVT: ya no se puede deshacer
+static void fosilizar(ProcesoLogico* pl, tiempo_us gvt)
+{
+    while (pl->primeroProc && pl->primeroProc->ev->e.tiempo < gvt) {
+        Procesado* p = pl->primeroProc;
+        pl->primeroProc = p->sig;
+        if (pl->primeroProc)
+            pl->primeroProc->ant = NULL;
+        else
+            pl->ultimoProc = NULL;
+        if (!p->esLlegada)
+            free(p->ev);
+        liberar_estado_pl(&p->antes);
+        free(p->enviados);
+        free(p);
+    }
+}
+
+// Devuelve 1 si la simulación terminó
+static int ronda_gvt(HiloTW* h)
+{
+    pthread_barrier_wait(&tw.barrera);
+
+    // Vaciar buzones hasta que nada quede en vuelo (los retrocesos generan
+    // antimensajes nuevos)
+    int quieto;
+    do {
+        entregar_mensajes(h);
+        pthread_barrier_wait(&tw.barrera);
+        quieto = (__atomic_load_n(&tw.enVuelo, __ATOMIC_SEQ_CST) == 0);
+        pthread_barrier_wait(&tw.barrera);
+    } while (!quieto);
+
+    tiempo_us minimo = TIEMPO_INFINITO;
+    for (int i = 0; i < NUM_PROCESOS; i++) {
+        if (tw.procesos[i].hilo == h->indice) {
+            tiempo_us t = tiempo_siguiente(&tw.procesos[i]);
+            if (t < minimo)
+                minimo = t;
+        }
+    }
+    tw.minimos[h->indice] = minimo;
+    pthread_barrier_wait(&tw.barrera);
+
+    tiempo_us gvt = TIEMPO_INFINITO;
+    for (int i = 0; i < tw.numHilos; i++)
+        if (tw.minimos[i] < gvt)
+            gvt = tw.minimos[i];
+    for (int i = 0; i < NUM_PROCESOS; i++)
+        if (tw.procesos[i].hilo == h->indice)
+            fosilizar(&tw.procesos[i], gvt);
+    h->desdeGVT = 0;
+    if (h->indice == 0) {
+        tw.gvt = gvt;
+        tw.rondas++;
+        __atomic_store_n(&tw.gvtPedido, 0, __ATOMIC_SEQ_CST);
+    }
+    pthread_barrier_wait(&tw.barrera);
+    return gvt == TIEMPO_INFINITO;
+}
+
+// ---------------------------------------------------------------------
+// Hilos
+
+static ProcesoLogico* elegir_proceso(HiloTW* h)
+{
+    ProcesoLogico* mejor = NULL;
+    EventoTW* evMejor = NULL;
+    for (int i = 0; i < NUM_PROCESOS; i++) {
+        ProcesoLogico* pl = &tw.procesos[i];
+        if (pl->hilo != h->indice)
+            continue;
+        int esLlegada;
+        EventoTW* ev = siguiente_evento(pl, &esLlegada);
+        if (ev && (evMejor == NULL || comparar(ev, evMejor) < 0)) {
+            mejor = pl;
+            evMejor = ev;
+        }
+    }
+    return mejor;
+}
+
+static void* hiloTimeWarp(void* arg)
+{
+    HiloTW* h = (HiloTW*)arg;
+    for (;;) {
+        entregar_mensajes(h);
+        if (__atomic_load_n(&tw.gvtPedido, __ATOMIC_SEQ_CST)) {
+            if (ronda_gvt(h))
+                break;
+            continue;
+        }
+
+        ProcesoLogico* pl = elegir_proceso(h);
+        if (pl && tiempo_siguiente(pl) <= tw.gvt + VENTANA_TW) {
+            procesar(h, pl);
+            if (++h->desdeGVT >= GVT_PERIODO)
+                pedir_gvt(h);
+            continue;
+        }
+
+        if (pl == NULL) {
+            // Nada que hacer: esperar un poco a que llegue algo
+            struct timespec hasta;
+            clock_gettime(CLOCK_MONOTONIC, &hasta);
+            hasta.tv_nsec += 1000000;
+            if (hasta.tv_nsec >= 1000000000L) {
+                hasta.tv_sec++;
+                hasta.tv_nsec -= 1000000000L;
+            }
+            buzon_esperar(&h->buzon, &hasta);
+            if (entregar_mensajes(h) > 0)
+                continue;
+        }
+        // Sin trabajo o fuera de la ventana: hace falta un GVT nuevo
+        pedir_gvt(h);
+    }
+    return NULL;
+}
+
+// ---------------------------------------------------------------------
+
+// Las llegadas se generan todas antes y cada PL de entrada las consume en orden
+static void agregar_llegada(void* ctx, const EventoPL* e)
+{
+    int* capacidad = (int*)ctx;
+    ProcesoLogico* pl = &tw.procesos[e->destino];
+    if (pl->numLlegadas == capacidad[e->destino]) {
+        capacidad[e->destino] = capacidad[e->destino] ? capacidad[e->destino] * 2 : 1024;
+        pl->llegadas = realloc(pl->llegadas, capacidad[e->destino] * sizeof(EventoTW));
+        if (pl->llegadas == NULL) {
+            perror("realloc");
+            exit(1);
+        }
+    }
+    EventoTW* ev = &pl->llegadas[pl->numLlegadas++];
+    memset(ev, 0, sizeof(EventoTW));
+    ev->e = *e;
+}
+
+void ejecutar_motor_timewarp(unsigned int semilla, int numHilos, Estadisticas* est, EstadisticasTimeWarp* stw)
+{
+    if (numHilos <= 0)
+        numHilos = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (numHilos <= 0)
+        numHilos = 1;
+    if (numHilos > NUM_PROCESOS)
+        numHilos = NUM_PROCESOS;
+
+    memset(&tw, 0, sizeof(tw));
+    tw.numHilos = numHilos;
+    iniciar_estadisticas(est);
+
+    for (int i = 0; i < NUM_PROCESOS; i++) {
+        ProcesoLogico* pl = &tw.procesos[i];
+        pl->indice = i;
+        // Cada hombrillo va con el subtramo al que se entra desde él en 1→N
+        pl->hilo = (i < NUM_SUBTRAMOS ? i : i - NUM_SUBTRAMOS + 1) % numHilos;
+        iniciar_estado_pl(&pl->estado, i);
+    }
+    int capacidad[MAX_PROCESOS_LOGICOS] = {0};
+    generar_llegadas_pl(semilla, est, agregar_llegada, capacidad);
+
+    tw.hilos = reservar(numHilos * sizeof(HiloTW));
+    tw.minimos = reservar(numHilos * sizeof(tiempo_us));
+    pthread_barrier_init(&tw.barrera, NULL, numHilos);
+    for (int i = 0; i < numHilos; i++) {
+        HiloTW* h = &tw.hilos[i];
+        h->indice = i;
+        buzon_iniciar(&h->buzon, CAPACIDAD_BUZON_TW);
+        h->bandejaPrimero = h->bandejaUltimo = NULL;
+        h->desdeGVT = 0;
+    }
+
+    // El hilo que llama es el hilo 0
+    for (int i = 1; i < numHilos; i++)
+        crear_hilo(&tw.hilos[i].hilo, hiloTimeWarp, &tw.hilos[i]);
+    hiloTimeWarp(&tw.hilos[0]);
+    for (int i = 1; i < numHilos; i++)
+        pthread_join(tw.hilos[i].hilo, NULL);
+
+    // GVT infinito: todo está confirmado
+    memset(stw, 0, sizeof(*stw));
+    for (int i = 0; i < NUM_PROCESOS; i++) {
+        ProcesoLogico* pl = &tw.procesos[i];
+        if (i < NUM_SUBTRAMOS) {
+            est->estadisticasSubtramos[i][DIR_1A4] = pl->estado.porDireccion[DIR_1A4];
+            est->estadisticasSubtramos[i][DIR_4A1] = pl->estado.porDireccion[DIR_4A1];
+            est->vehiculosCompletados += pl->estado.completados;
+        } else {
+            est->hombrillos[i - NUM_SUBTRAMOS] = pl->estado.hombrillo;
+        }
+        stw->eventosProcesados += pl->procesados;
+        stw->eventosDeshechos += pl->deshechos;
+        stw->retrocesos += pl->retrocesos;
+        liberar_estado_pl(&pl->estado);
+        free(pl->llegadas);
+    }
+    stw->rondasGVT = tw.rondas;
+    stw->hilos = numHilos;
+
+    for (int i = 0; i < numHilos; i++)
+        buzon_destruir(&tw.hilos[i].buzon);
+    pthread_barrier_destroy(&tw.barrera);
+    free(tw.minimos);
+    free(tw.hilos);
+}
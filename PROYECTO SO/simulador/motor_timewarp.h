@@ -0,0 +1,20 @@
+// Motor optimista (Time Warp): un proceso lógico por subtramo y por
+// hombrillo, repartidos entre varios hilos
+#ifndef MOTOR_TIMEWARP_H
+#define MOTOR_TIMEWARP_H
+
+#include "trafico.h"
+
+typedef struct {
+    long eventosProcesados;   // Incluye los que luego se deshicieron
+    long eventosDeshechos;
+    long retrocesos;          // Veces que un proceso tuvo que volver atrás
+    long rondasGVT;
+    int hilos;
+} EstadisticasTimeWarp;
+
+// Con numHilos = 1 nunca retrocede; con cualquier número de hilos el
+// resultado es idéntico al del motor des para la misma semilla
+void ejecutar_motor_timewarp(unsigned int semilla, int numHilos, Estadisticas* est, EstadisticasTimeWarp* tw);
+
+#endif
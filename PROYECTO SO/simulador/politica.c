@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "politica.h"
+
+// Pasa todo el que quepa, mirando la cola por orden de llegada: un auto
+// adelanta a un camión que todavía no cabe (la regla de siempre de los
+// motores)
+static int pasar_si_cabe(const EstadoSubtramo* s, vehicleType tipo, const int esperando[2], int delante)
+{
+    (void)s;
+    (void)tipo;
+    (void)esperando;
+    (void)delante;
+    return 1;
+}
+
+// Nadie adelanta: solo pasa el primero de la cola (el turno FIFO de Alpha
+// y Beta)
+static int pasar_en_orden(const EstadoSubtramo* s, vehicleType tipo, const int esperando[2], int delante)
+{
+    (void)s;
+    (void)tipo;
+    (void)esperando;
+    return delante == 0;
+}
+
+// Un auto no pasa mientras espere un camión, para que los camiones no se
+// queden sin sitio en los subtramos con pesos. Gamma2-1 solo despierta
+// antes a los camiones del subtramo 2; aquí además no se les cuela nadie
+static int pasar_camiones_primero(const EstadoSubtramo* s, vehicleType tipo, const int esperando[2], int delante)
+{
+    (void)s;
+    (void)delante;
+    return tipo == CAMION || esperando[CAMION] == 0;
+}
+
+static const PoliticaAdmision politicas[] = {
+    { "cabe",     "pasa todo el que quepa, por orden de llegada", pasar_si_cabe },
+    { "fifo",     "nadie adelanta: solo pasa el primero de la cola", pasar_en_orden },
+    { "camiones", "un auto no pasa mientras espere un camión", pasar_camiones_primero },
+};
+
+#define NUM_POLITICAS (int)(sizeof(politicas) / sizeof(politicas[0]))
+
+const PoliticaAdmision* politicaAdmision = &politicas[0];
+
+int elegir_politica(const char* nombre)
+{
+    for (int i = 0; i < NUM_POLITICAS; i++) {
+        if (strcmp(nombre, politicas[i].nombre) == 0) {
+            politicaAdmision = &politicas[i];
+            return 0;
+        }
+    }
+    return -1;
+}
+
+int es_politica_por_defecto()
+{
+    return politicaAdmision == &politicas[0];
+}
+
+void mostrar_politicas(FILE* f)
+{
+    for (int i = 0; i < NUM_POLITICAS; i++)
+        fprintf(f, "  %-9s %s\n", politicas[i].nombre, politicas[i].descripcion);
+}
+
+int admite_llegada(const EstadoSubtramo* s, vehicleType tipo, const int esperando[2])
+{
+    return puede_entrar_subtramo(s, tipo)
+        && politicaAdmision->puede_pasar(s, tipo, esperando, esperando[AUTO] + esperando[CAMION]);
+}
+
+void empezar_recorrido(RecorridoCola* r, int esperando[2])
+{
+    r->esperando = esperando;
+    r->delante = 0;
+}
+
+int pasa_en_recorrido(RecorridoCola* r, const EstadoSubtramo* s, vehicleType tipo)
+{
+    int otros[2] = { r->esperando[AUTO], r->esperando[CAMION] };
+    otros[tipo]--;
+    if (puede_entrar_subtramo(s, tipo) && politicaAdmision->puede_pasar(s, tipo, otros, r->delante)) {
+        r->esperando[tipo]--;
+        return 1;
+    }
+    r->delante++;
+    return 0;
+}
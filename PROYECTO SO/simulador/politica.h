@@ -0,0 +1,55 @@
+// Política de admisión a los subtramos
+//
+// Lo que distingue de verdad a Problema2Alpha.c, Problema2Beta.c,
+// Problema2Gamma*.c y camion*.c es a quién se deja pasar cuando un subtramo
+// tiene cola: en todos cabe lo mismo (puede_entrar_subtramo()), pero unos
+// dejan que un auto adelante a un camión que no cabe, otros respetan el
+// orden de llegada y otros dan prioridad a los camiones. La política es esa
+// decisión y nada más; la generación, el recorrido, las estadísticas y el
+// final son los de cada motor, así que cualquier motor que la consulte
+// sirve para todas.
+//
+// La consultan los motores que tienen colas de espera explícitas por
+// subtramo (des, pool, actores y, por modelo_pl, timewarp y cmb). Se elige
+// por ejecución con la opción de escenario politica=NOMBRE.
+#ifndef POLITICA_H
+#define POLITICA_H
+
+#include <stdio.h>
+
+#include "trafico.h"
+
+typedef struct {
+    const char* nombre;
+    const char* descripcion;
+
+    // ¿Pasa ya un vehículo de este tipo que cabe en el subtramo? esperando:
+    // los demás vehículos de la cola del subtramo, por tipo; delante:
+    // cuántos de ellos llegaron antes que él y siguen esperando
+    int (*puede_pasar)(const EstadoSubtramo* s, vehicleType tipo, const int esperando[2], int delante);
+} PoliticaAdmision;
+
+// La que usan todos los motores; por defecto "cabe", la regla de siempre
+extern const PoliticaAdmision* politicaAdmision;
+
+// -1 si no hay ninguna con ese nombre
+int elegir_politica(const char* nombre);
+int es_politica_por_defecto();
+void mostrar_politicas(FILE* f);
+
+// Un vehículo que llega a un subtramo con esperando[tipo] en la cola:
+// entra si cabe y la política lo deja pasar por delante de todos ellos
+int admite_llegada(const EstadoSubtramo* s, vehicleType tipo, const int esperando[2]);
+
+// Recorrido de una cola por orden de llegada tras liberar espacio. El motor
+// lleva la cuenta de su cola en esperando[2] (suma al encolar) y pregunta
+// por cada vehículo en orden; si pasa, se descuenta de esperando
+typedef struct {
+    int* esperando;
+    int delante;
+} RecorridoCola;
+
+void empezar_recorrido(RecorridoCola* r, int esperando[2]);
+int pasa_en_recorrido(RecorridoCola* r, const EstadoSubtramo* s, vehicleType tipo);
+
+#endif
@@ -0,0 +1,494 @@
+// Banco A/B de las variantes originales (Problema2Alpha.c, Problema2Beta.c,
+// Problema2Gamma*.c): cuál es más rápida y cuál espera menos en los
+// hombrillos, y si la diferencia es de verdad o es ruido. Alpha y Beta son
+// ya el mismo código (los turnos de espera_fifo.c; solo cambian comentarios
+// y llaves), así que basta con una de las dos: compararlas solo mide ruido
+// y añade pruebas a la corrección de Holm
+//
+// Compilar (desde "PROYECTO SO"):
+//   gcc -O2 -pthread -Isimulador simulador/*.c simulador/programas/ab_variantes.c -o ab_variantes -lm
+//
+// Uso:
+//   ./ab_variantes [--repeticiones=N] [--semilla=N] [--horas=H] [--vehiculos-hora=V]
+//                  [--unidad-us=US] [--umbral=PCT] REFERENCIA.c VARIANTE.c...
+//
+// Por ejemplo, todas frente a Alpha:
+//   ./ab_variantes Problema2Alpha.c Problema2Gamma.c Problema2Gamma2.c
+//                  Problema2Gamma2-1.c Problema2Gamma3.c
+//
+// Compila cada variante, con los .c de sus #include "X.h" locales (como
+// espera_fifo.c), con las mismas opciones (-DHORAS_SIMULACION,
+// -DVEHICULOS_POR_HORA y -DUNIDAD_SUBTRAMO_US; 1 hora de 150 vehículos y
+// 35000 us por defecto, que con la cadencia de las variantes son unos 10 s
+// por ejecución; Gamma2-1 usa 40000 por su cuenta, así que sin la misma
+// unidad se compararía otra autopista y no otro código) y las ejecuta
+// --repeticiones veces (5). En la repetición r todas reciben SEMILLA =
+// --semilla + r, así que ven exactamente las mismas llegadas y los mismos
+// tiempos de recorrido; el orden de las variantes rota en cada repetición
+// para que ninguna vaya siempre primera. De cada ejecución se mide el
+// tiempo de pared, la CPU y los cambios de contexto (wait4), los vehículos
+// por segundo y los percentiles 50, 95 y 99 de la espera de los vehículos
+// que pararon en un hombrillo, desde que llegaron al subtramo lleno hasta
+// que entraron (lo anotan las variantes en el fichero ESPERAS; los que
+// pasan sin parar no cuentan).
+//
+// Como cada repetición tiene la misma semilla para todas, la comparación
+// con la referencia (la primera variante) es pareada: se toma la
+// diferencia repetición a repetición, su intervalo de confianza al 95% y
+// su p (t de Student a dos colas; 1 si la diferencia no llega a la
+// resolución de la métrica, que entonces no se cuenta). Como se hace una prueba por métrica y
+// variante, con 7 métricas y 4 variantes alguna saldría significativa por
+// azar casi siempre; por eso las p se corrigen con Holm sobre todas las
+// pruebas y una diferencia es significativa si su p corregida es menor
+// que 0.05. Una variante significativamente peor que la referencia en más
+// de --umbral por ciento (5) en cualquier métrica es una regresión y el
+// programa termina con 2, para poder usarlo de puerta antes de fusionar.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#include "estadistica.h"
+
+#define MAX_VARIANTES 16
+#define MAX_REPETICIONES 64
+#define NIVEL_SIGNIFICACION 0.05
+
+typedef enum {
+    PARED, VEHICULOS_SEG, CPU, CAMBIOS, ESPERA_P50, ESPERA_P95, ESPERA_P99, NUM_METRICAS
+} Metrica;
+
+// Una diferencia por debajo de la resolución no cuenta aunque sea
+// constante: la espera se anota en microsegundos enteros y la CPU que da
+// wait4 va a golpes del reloj del núcleo
+static const struct {
+    const char* nombre;
+    const char* cabecera;
+    int decimales;
+    double resolucion;
+    int mayorEsMejor;
+} metricas[NUM_METRICAS] = {
+    [PARED]         = { "pared (s)",       "Pared s", 2, 0.001, 0 },
+    [VEHICULOS_SEG] = { "vehículos/s",     "Veh/s",   2, 0.01,  1 },
+    [CPU]           = { "CPU (s)",         "CPU s",   3, 0.004, 0 },
+    [CAMBIOS]       = { "cambios ctx",     "Cambios", 0, 1,     0 },
+    [ESPERA_P50]    = { "hombrillo p50 ms", "p50 ms",  3, 0.01,  0 },
+    [ESPERA_P95]    = { "hombrillo p95 ms", "p95 ms",  3, 0.01,  0 },
+    [ESPERA_P99]    = { "hombrillo p99 ms", "p99 ms",  3, 0.01,  0 },
+};
+
+typedef struct {
+    const char* fuente;
+    char nombre[64];
+    char binario[256];
+    double muestras[NUM_METRICAS][MAX_REPETICIONES];
+} Variante;
+
+static Variante variantes[MAX_VARIANTES];
+static int numVariantes;
+static char directorio[] = "/tmp/ab_variantes_XXXXXX";
+static int directorioCreado;
+
+static double segundos_desde(const struct timespec* inicio)
+{
+    struct timespec ahora;
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    return (ahora.tv_sec - inicio->tv_sec) + (ahora.tv_nsec - inicio->tv_nsec) / 1e9;
+}
+
+// Única salida de limpieza (atexit): también se borra todo si se termina
+// con exit(1) a medias. Los hijos salen con _exit y no pasan por aquí
+static void borrar_directorio()
+{
+    if (!directorioCreado)
+        return;
+    char fichero[512];
+    for (int k = 0; k < numVariantes; k++)
+        if (variantes[k].binario[0] != '\0')
+            unlink(variantes[k].binario);
+    snprintf(fichero, sizeof(fichero), "%s/salida.txt", directorio);
+    unlink(fichero);
+    snprintf(fichero, sizeof(fichero), "%s/esperas.txt", directorio);
+    unlink(fichero);
+    rmdir(directorio);
+    directorioCreado = 0;
+}
+
+// Lanza argv con la salida estándar a salida (si no es NULL) y espera
+static int ejecutar_proceso(char* const argv[], const char* salida, struct rusage* uso)
+{
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        exit(1);
+    }
+    if (pid == 0) {
+        if (salida != NULL && freopen(salida, "w", stdout) == NULL) {
+            perror(salida);
+            _exit(127);
+        }
+        execvp(argv[0], argv);
+        perror(argv[0]);
+        _exit(127);
+    }
+    int estado;
+    if (wait4(pid, &estado, 0, uso) < 0) {
+        perror("wait4");
+        exit(1);
+    }
+    return WIFEXITED(estado) ? WEXITSTATUS(estado) : 128 + WTERMSIG(estado);
+}
+
+// Los .c hermanos de los #include "X.h" de la variante (espera_fifo.c
+// para Alpha y Beta), que hay que compilar con ella
+static int fuentes_locales(const char* fuente, char extras[][256], int max)
+{
+    FILE* f = fopen(fuente, "r");
+    if (f == NULL) {
+        perror(fuente);
+        exit(1);
+    }
+    const char* barra = strrchr(fuente, '/');
+    int largoDir = barra != NULL ? (int)(barra - fuente + 1) : 0;
+    char linea[512], cabecera[256];
+    int n = 0;
+    while (n < max && fgets(linea, sizeof(linea), f) != NULL) {
+        char* punto;
+        if (sscanf(linea, " #include \"%255[^\"]\"", cabecera) != 1
+            || (punto = strrchr(cabecera, '.')) == NULL || strcmp(punto, ".h") != 0)
+            continue;
+        *punto = '\0';
+        int largo = snprintf(extras[n], sizeof(extras[n]), "%.*s%s.c", largoDir, fuente, cabecera);
+        if (largo < (int)sizeof(extras[n]) && access(extras[n], R_OK) == 0)
+            n++;
+    }
+    fclose(f);
+    return n;
+}
+
+// El nombre es el del fichero sin .c, o la ruta entera si otra variante
+// anterior tiene el mismo; el binario va numerado para que dos fuentes
+// con el mismo nombre en directorios distintos no se pisen
+static void nombrar(int k)
+{
+    Variante* v = &variantes[k];
+    const char* base = strrchr(v->fuente, '/');
+    base = base != NULL ? base + 1 : v->fuente;
+    for (int intento = 0; intento < 2; intento++) {
+        snprintf(v->nombre, sizeof(v->nombre), "%s", intento == 0 ? base : v->fuente);
+        char* punto = strrchr(v->nombre, '.');
+        if (punto != NULL && strchr(punto, '/') == NULL)
+            *punto = '\0';
+        int repetido = 0;
+        for (int j = 0; j < k; j++)
+            repetido |= strcmp(variantes[j].nombre, v->nombre) == 0;
+        if (!repetido)
+            break;
+    }
+    snprintf(v->binario, sizeof(v->binario), "%s/%02d_%s", directorio, k + 1, base);
+}
+
+static void compilar(Variante* v, int horas, int vehiculosHora, int unidadUs)
+{
+    char defHoras[64], defVehiculos[64], defUnidad[64];
+    snprintf(defHoras, sizeof(defHoras), "-DHORAS_SIMULACION=%d", horas);
+    snprintf(defVehiculos, sizeof(defVehiculos), "-DVEHICULOS_POR_HORA=%d", vehiculosHora);
+    snprintf(defUnidad, sizeof(defUnidad), "-DUNIDAD_SUBTRAMO_US=%d", unidadUs);
+    char* compilador = getenv("CC") != NULL ? getenv("CC") : "gcc";
+    char extras[8][256];
+    int numExtras = fuentes_locales(v->fuente, extras, 8);
+    char* argv[9 + 8] = { compilador, "-O2", "-pthread", defHoras, defVehiculos, defUnidad, (char*)v->fuente };
+    int argc = 7;
+    for (int i = 0; i < numExtras; i++)
+        argv[argc++] = extras[i];
+    argv[argc++] = "-o";
+    argv[argc++] = v->binario;
+    argv[argc] = NULL;
+    struct rusage uso;
+    if (ejecutar_proceso(argv, NULL, &uso) != 0) {
+        fprintf(stderr, "No se pudo compilar %s\n", v->fuente);
+        exit(1);
+    }
+}
+
+static int comparar_long(const void* a, const void* b)
+{
+    long x = *(const long*)a, y = *(const long*)b;
+    return (x > y) - (x < y);
+}
+
+// Percentil por rango más cercano de muestras ya ordenadas
+static double percentil(const long* muestras, long n, double p)
+{
+    if (n == 0)
+        return 0;
+    long k = (long)(p / 100 * n + 0.999999);
+    if (k < 1)
+        k = 1;
+    return (double)muestras[k - 1];
+}
+
+static void leer_esperas(const char* fichero, double* p50, double* p95, double* p99)
+{
+    FILE* f = fopen(fichero, "r");
+    if (f == NULL) {
+        perror(fichero);
+        exit(1);
+    }
+    long capacidad = 4096, n = 0, x;
+    long* muestras = malloc(capacidad * sizeof(long));
+    if (muestras == NULL) {
+        perror("malloc");
+        exit(1);
+    }
+    while (fscanf(f, "%ld", &x) == 1) {
+        if (n == capacidad) {
+            capacidad *= 2;
+            long* mas = realloc(muestras, capacidad * sizeof(long));
+            if (mas == NULL) {
+                perror("realloc");
+                exit(1);
+            }
+            muestras = mas;
+        }
+        muestras[n++] = x;
+    }
+    fclose(f);
+    qsort(muestras, n, sizeof(long), comparar_long);
+    *p50 = percentil(muestras, n, 50) / 1000;
+    *p95 = percentil(muestras, n, 95) / 1000;
+    *p99 = percentil(muestras, n, 99) / 1000;
+    free(muestras);
+}
+
+// Lo que la variante dice al final que ha circulado
+static int leer_total_vehiculos(const char* fichero)
+{
+    FILE* f = fopen(fichero, "r");
+    if (f == NULL) {
+        perror(fichero);
+        exit(1);
+    }
+    char linea[512];
+    int total = 0;
+    while (fgets(linea, sizeof(linea), f) != NULL) {
+        char* p = strstr(linea, "TOTAL DE VEHÍCULOS EN EL DÍA:");
+        if (p != NULL)
+            sscanf(p + strlen("TOTAL DE VEHÍCULOS EN EL DÍA:"), "%d", &total);
+    }
+    fclose(f);
+    return total;
+}
+
+static void medir(Variante* v, int rep, unsigned int semilla)
+{
+    char salida[512], esperas[512], valorSemilla[32];
+    snprintf(salida, sizeof(salida), "%s/salida.txt", directorio);
+    snprintf(esperas, sizeof(esperas), "%s/esperas.txt", directorio);
+    snprintf(valorSemilla, sizeof(valorSemilla), "%u", semilla);
+    setenv("SEMILLA", valorSemilla, 1);
+    setenv("ESPERAS", esperas, 1);
+
+    char* argv[] = { v->binario, NULL };
+    struct rusage uso;
+    struct timespec inicio;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    int estado = ejecutar_proceso(argv, salida, &uso);
+    double pared = segundos_desde(&inicio);
+    if (estado != 0) {
+        fprintf(stderr, "%s terminó con %d (semilla %u)\n", v->nombre, estado, semilla);
+        exit(1);
+    }
+
+    v->muestras[PARED][rep] = pared;
+    v->muestras[VEHICULOS_SEG][rep] = leer_total_vehiculos(salida) / pared;
+    v->muestras[CPU][rep] = uso.ru_utime.tv_sec + uso.ru_utime.tv_usec / 1e6
+                          + uso.ru_stime.tv_sec + uso.ru_stime.tv_usec / 1e6;
+    v->muestras[CAMBIOS][rep] = (double)(uso.ru_nvcsw + uso.ru_nivcsw);
+    leer_esperas(esperas, &v->muestras[ESPERA_P50][rep], &v->muestras[ESPERA_P95][rep],
+                 &v->muestras[ESPERA_P99][rep]);
+    unlink(salida);
+    unlink(esperas);
+}
+
+static void acumular_metrica(Acumulador* a, const Variante* v, Metrica k, int repeticiones)
+{
+    iniciar_acumulador(a);
+    for (int r = 0; r < repeticiones; r++)
+        acumular(a, v->muestras[k][r]);
+}
+
+// Diferencias repetición a repetición frente a la referencia
+static void acumular_diferencia(Acumulador* a, const Variante* v, const Variante* ref, Metrica k, int repeticiones)
+{
+    iniciar_acumulador(a);
+    for (int r = 0; r < repeticiones; r++)
+        acumular(a, v->muestras[k][r] - ref->muestras[k][r]);
+}
+
+// p a dos colas de que la diferencia media sea 0. Una diferencia constante
+// no tiene varianza: es 0 si es nula y segura si no
+static double p_diferencia(const Acumulador* d)
+{
+    double error = desviacion(d) / sqrt((double)d->n);
+    if (error == 0)
+        return d->media == 0 ? 1 : 0;
+    return p_t_student(d->media / error, d->n - 1);
+}
+
+static const double* pOrden;
+
+static int comparar_p(const void* a, const void* b)
+{
+    double x = pOrden[*(const int*)a], y = pOrden[*(const int*)b];
+    return (x > y) - (x < y);
+}
+
+// Holm-Bonferroni: la i-ésima p más pequeña de m se multiplica por m - i y
+// ninguna corregida queda por debajo de la anterior. Controla la
+// probabilidad de dar por buena alguna diferencia falsa entre todas
+static void corregir_holm(const double* p, double* corregida, int m)
+{
+    int orden[MAX_VARIANTES * NUM_METRICAS];
+    for (int i = 0; i < m; i++)
+        orden[i] = i;
+    pOrden = p;
+    qsort(orden, m, sizeof(int), comparar_p);
+    double maximo = 0;
+    for (int i = 0; i < m; i++) {
+        double c = (m - i) * p[orden[i]];
+        if (c > 1)
+            c = 1;
+        if (c > maximo)
+            maximo = c;
+        corregida[orden[i]] = maximo;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    int repeticiones = 5;
+    unsigned int semilla = 1;
+    int horas = 1;
+    int vehiculosHora = 150;
+    int unidadUs = 35000;
+    double umbral = 5;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--repeticiones=", 15) == 0) {
+            repeticiones = atoi(argv[i] + 15);
+        } else if (strncmp(argv[i], "--semilla=", 10) == 0) {
+            semilla = (unsigned int)strtoul(argv[i] + 10, NULL, 10);
+        } else if (strncmp(argv[i], "--horas=", 8) == 0) {
+            horas = atoi(argv[i] + 8);
+        } else if (strncmp(argv[i], "--vehiculos-hora=", 17) == 0) {
+            vehiculosHora = atoi(argv[i] + 17);
+        } else if (strncmp(argv[i], "--unidad-us=", 12) == 0) {
+            unidadUs = atoi(argv[i] + 12);
+        } else if (strncmp(argv[i], "--umbral=", 9) == 0) {
+            umbral = atof(argv[i] + 9);
+        } else if (strncmp(argv[i], "--", 2) != 0 && numVariantes < MAX_VARIANTES) {
+            variantes[numVariantes++].fuente = argv[i];
+        } else {
+            numVariantes = 0;
+            break;
+        }
+    }
+    if (numVariantes < 2 || repeticiones < 2 || repeticiones > MAX_REPETICIONES
+        || horas < 1 || horas > 24 || vehiculosHora < 1 || unidadUs < 1) {
+        fprintf(stderr, "Uso: %s [--repeticiones=N] [--semilla=N] [--horas=H] [--vehiculos-hora=V]\n"
+                        "          [--unidad-us=US] [--umbral=PCT] REFERENCIA.c VARIANTE.c...\n"
+                        "(de 2 a %d variantes y de 2 a %d repeticiones)\n",
+                argv[0], MAX_VARIANTES, MAX_REPETICIONES);
+        return 1;
+    }
+    if (mkdtemp(directorio) == NULL) {
+        perror("mkdtemp");
+        return 1;
+    }
+    directorioCreado = 1;
+    atexit(borrar_directorio);
+
+    printf("⚖️  BANCO A/B DE LAS VARIANTES\n");
+    printf("🚗 %d hora(s) de %d vehículos  ⏱️  Unidad de subtramo: %d us  🔁 Repeticiones: %d  🌱 Semillas: %u a %u  📏 Umbral: %.1f%%\n",
+           horas, vehiculosHora, unidadUs, repeticiones, semilla, semilla + repeticiones - 1, umbral);
+    for (int k = 0; k < numVariantes; k++) {
+        nombrar(k);
+        compilar(&variantes[k], horas, vehiculosHora, unidadUs);
+    }
+    printf("==========================================\n");
+
+    for (int r = 0; r < repeticiones; r++) {
+        printf("🔁 Repetición %d/%d (SEMILLA=%u):", r + 1, repeticiones, semilla + r);
+        fflush(stdout);
+        for (int j = 0; j < numVariantes; j++) {
+            Variante* v = &variantes[(j + r) % numVariantes];
+            medir(v, r, semilla + r);
+            printf(" %s", v->nombre);
+            fflush(stdout);
+        }
+        printf("\n");
+    }
+    borrar_directorio();
+
+    printf("\n📊 MEDIAS (± semiancho del IC 95%%)\n");
+    printf("%-20s", "Variante");
+    for (int k = 0; k < NUM_METRICAS; k++)
+        printf(" | %17s", metricas[k].cabecera);
+    printf("\n");
+    for (int i = 0; i < numVariantes; i++) {
+        printf("%-20s", variantes[i].nombre);
+        for (int k = 0; k < NUM_METRICAS; k++) {
+            Acumulador a;
+            acumular_metrica(&a, &variantes[i], k, repeticiones);
+            printf(" | %8.*f ±%7.*f", metricas[k].decimales, a.media, metricas[k].decimales, semiancho_ic95(&a));
+        }
+        printf("\n");
+    }
+
+    const Variante* ref = &variantes[0];
+    int numPruebas = (numVariantes - 1) * NUM_METRICAS;
+    double p[MAX_VARIANTES * NUM_METRICAS], pHolm[MAX_VARIANTES * NUM_METRICAS];
+    for (int i = 1; i < numVariantes; i++)
+        for (int k = 0; k < NUM_METRICAS; k++) {
+            Acumulador d;
+            acumular_diferencia(&d, &variantes[i], ref, k, repeticiones);
+            p[(i - 1) * NUM_METRICAS + k] = fabs(d.media) < metricas[k].resolucion ? 1 : p_diferencia(&d);
+        }
+    corregir_holm(p, pHolm, numPruebas);
+
+    int regresiones = 0;
+    printf("\n🔬 FRENTE A %s (diferencia pareada por semilla, IC 95%%, p corregida con Holm sobre %d pruebas)\n",
+           ref->nombre, numPruebas);
+    for (int i = 1; i < numVariantes; i++) {
+        printf("%s:\n", variantes[i].nombre);
+        for (int k = 0; k < NUM_METRICAS; k++) {
+            Acumulador base, d;
+            acumular_metrica(&base, ref, k, repeticiones);
+            acumular_diferencia(&d, &variantes[i], ref, k, repeticiones);
+            double semiancho = semiancho_ic95(&d);
+            double pct = base.media != 0 ? 100 * d.media / base.media : 0;
+            double pctSemiancho = base.media != 0 ? 100 * semiancho / base.media : 0;
+            double pc = pHolm[(i - 1) * NUM_METRICAS + k];
+            int significativa = pc < NIVEL_SIGNIFICACION;
+            int peor = metricas[k].mayorEsMejor ? d.media < 0 : d.media > 0;
+            int regresion = significativa && peor && (pct < 0 ? -pct : pct) > umbral;
+            regresiones += regresion;
+            printf("  %-16s %+8.1f%% ± %5.1f%%  p %.3f  %s\n", metricas[k].nombre, pct, pctSemiancho, pc,
+                   regresion ? "❌ REGRESIÓN" : !significativa ? "= sin diferencia significativa"
+                                              : peor ? "peor (dentro del umbral)" : "✅ mejor");
+        }
+    }
+
+    printf("==========================================\n");
+    if (regresiones > 0) {
+        printf("❌ %d regresión(es) de más del %.1f%% frente a %s\n", regresiones, umbral, ref->nombre);
+        return 2;
+    }
+    printf("✅ Ninguna variante es significativamente peor que %s en más del %.1f%%\n", ref->nombre, umbral);
+    return 0;
+}
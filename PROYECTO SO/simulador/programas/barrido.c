@@ -0,0 +1,422 @@
+// Barrido de parámetros con caché de resultados
+//
+// Compilar (desde "PROYECTO SO"):
+//   gcc -O2 -pthread -Isimulador simulador/*.c simulador/programas/barrido.c -o barrido -lm
+//
+// Uso:
+//   ./barrido [--barrer-capacidad=S:LISTA]... [--barrer-vehiculos=LISTA]
+//             [--barrer-camiones=N/D,N/D...] [--semillas=R] [--semilla=N]
+//             [--procesos=N] [--cache=FICHERO]
+//             [--escenario=FICHERO] [--CLAVE=VALOR del escenario]
+//
+// LISTA es una lista de enteros separados por comas o un rango
+// MIN..MAX[:PASO]. Se simula el producto cartesiano de los valores
+// barridos (la capacidad de cada subtramo S, el tope de vehículos por hora
+// y la proporción de camiones) sobre el escenario, R días por punto con las
+// semillas N, N+1... (las mismas en todos los puntos, para que las
+// diferencias entre puntos no sean de suerte). vehiculos-por-hora es el
+// tope del día: para más tráfico hay que bajar también llegada-min-us. Los
+// hombrillos no tienen capacidad en el modelo, así que no hay nada que
+// barrer ahí.
+//
+// Cada día va a la caché (cache_dias.h, barrido.cache por defecto) y antes
+// de simular se busca en ella, así que repetir un barrido que se solapa con
+// otro solo simula los puntos nuevos. Los días que faltan se reparten entre
+// procesos (uno por núcleo por defecto): el motor des lee el escenario y la
+// autopista globales, así que cada proceso se pone el de su punto sin
+// molestar a los demás, toma días de un contador compartido y deja el
+// resultado en memoria compartida.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#include "trafico.h"
+#include "escenario.h"
+#include "motor_des.h"
+#include "cache_dias.h"
+#include "estadistica.h"
+
+#define MAX_VALORES 1000
+
+typedef struct {
+    int numValores;
+    int valores[MAX_VALORES];
+} ListaEnteros;
+
+typedef struct {
+    ListaEnteros capacidad[MAX_SUBTRAMOS];   // numValores 0: no se barre
+    ListaEnteros vehiculosPorHora;
+    int numCamiones;
+    Proporcion camiones[MAX_VALORES];
+
+    Escenario escenarioBase;
+    Autopista autopistaBase;
+    int numPuntos;
+} Barrido;
+
+static Barrido barrido;
+
+// Lo que se reparte entre los procesos
+typedef struct {
+    int siguiente;          // Próxima tarea sin empezar
+    int numTareas;
+    int* punto;             // [tarea]
+    unsigned int* semilla;  // [tarea]
+    Estadisticas* dias;     // [tarea]
+} Tareas;
+
+// "a,b,c" o "MIN..MAX[:PASO]"; -1 si no se entiende
+static int leer_lista(const char* texto, int minimo, ListaEnteros* l)
+{
+    char* fin;
+    l->numValores = 0;
+    long a = strtol(texto, &fin, 10);
+    if (fin != texto && strncmp(fin, "..", 2) == 0) {
+        const char* resto = fin + 2;
+        long b = strtol(resto, &fin, 10), paso = 1;
+        if (fin == resto)
+            return -1;
+        if (*fin == ':') {
+            resto = fin + 1;
+            paso = strtol(resto, &fin, 10);
+            if (fin == resto || paso < 1)
+                return -1;
+        }
+        if (*fin != '\0' || a < minimo || b < a)
+            return -1;
+        for (long v = a; v <= b; v += paso) {
+            if (l->numValores == MAX_VALORES)
+                return -1;
+            l->valores[l->numValores++] = (int)v;
+        }
+        return 0;
+    }
+
+    const char* p = texto;
+    for (;;) {
+        long v = strtol(p, &fin, 10);
+        if (fin == p || v < minimo || v > 1000000000L || l->numValores == MAX_VALORES)
+            return -1;
+        l->valores[l->numValores++] = (int)v;
+        if (*fin == '\0')
+            return 0;
+        if (*fin != ',')
+            return -1;
+        p = fin + 1;
+    }
+}
+
+static int leer_proporciones(const char* texto)
+{
+    const char* p = texto;
+    barrido.numCamiones = 0;
+    for (;;) {
+        char* fin;
+        long num = strtol(p, &fin, 10);
+        if (fin == p || *fin != '/')
+            return -1;
+        const char* resto = fin + 1;
+        long den = strtol(resto, &fin, 10);
+        if (fin == resto || den < 1 || den > 1000000 || num < 0 || num > den || barrido.numCamiones == MAX_VALORES)
+            return -1;
+        barrido.camiones[barrido.numCamiones++] = (Proporcion){ (int)num, (int)den };
+        if (*fin == '\0')
+            return 0;
+        if (*fin != ',')
+            return -1;
+        p = fin + 1;
+    }
+}
+
+// Valores de cada dimensión en el punto, de la más rápida (el primer
+// subtramo) a la más lenta (los camiones)
+static void poner_punto(int punto)
+{
+    escenario = barrido.escenarioBase;
+    autopista = barrido.autopistaBase;
+    for (int i = 0; i < NUM_SUBTRAMOS; i++) {
+        const ListaEnteros* l = &barrido.capacidad[i];
+        if (l->numValores > 0) {
+            autopista.capacidad[i] = l->valores[punto % l->numValores];
+            punto /= l->numValores;
+        }
+    }
+    if (barrido.vehiculosPorHora.numValores > 0) {
+        escenario.vehiculosPorHora = barrido.vehiculosPorHora.valores[punto % barrido.vehiculosPorHora.numValores];
+        punto /= barrido.vehiculosPorHora.numValores;
+    }
+    if (barrido.numCamiones > 0)
+        escenario.camiones = barrido.camiones[punto % barrido.numCamiones];
+    fijar_escenario();
+}
+
+static void trabajar(Tareas* t)
+{
+    for (;;) {
+        int k = __atomic_fetch_add(&t->siguiente, 1, __ATOMIC_RELAXED);
+        if (k >= t->numTareas)
+            break;
+        poner_punto(t->punto[k]);
+        ejecutar_motor_des(t->semilla[k], &t->dias[k]);
+    }
+}
+
+// Memoria compartida con los procesos hijos, que la heredan con fork()
+static void* compartida(size_t tam)
+{
+    void* p = mmap(NULL, tam > 0 ? tam : 1, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+        perror("mmap");
+        exit(1);
+    }
+    return p;
+}
+
+static void simular_tareas(Tareas* t, int numProcesos)
+{
+    if (numProcesos > t->numTareas)
+        numProcesos = t->numTareas;
+    fflush(stdout);
+    pid_t* hijos = malloc(numProcesos * sizeof(pid_t));
+    if (hijos == NULL) {
+        perror("malloc");
+        exit(1);
+    }
+    for (int p = 0; p < numProcesos; p++) {
+        hijos[p] = fork();
+        if (hijos[p] < 0) {
+            perror("fork");
+            exit(1);
+        }
+        if (hijos[p] == 0) {
+            trabajar(t);
+            _exit(0);
+        }
+    }
+    for (int p = 0; p < numProcesos; p++) {
+        int estado;
+        waitpid(hijos[p], &estado, 0);
+        if (!WIFEXITED(estado) || WEXITSTATUS(estado) != 0) {
+            fprintf(stderr, "El proceso %d terminó mal; no se guarda nada en la caché\n", p);
+            exit(1);
+        }
+    }
+    free(hijos);
+}
+
+static double segundos_desde(const struct timespec* inicio)
+{
+    struct timespec ahora;
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    return (ahora.tv_sec - inicio->tv_sec) + (ahora.tv_nsec - inicio->tv_nsec) / 1e9;
+}
+
+static void mostrar_cabecera()
+{
+    printf("Punto |");
+    for (int i = 0; i < NUM_SUBTRAMOS; i++)
+        if (barrido.capacidad[i].numValores > 0)
+            printf(" Cap.%-2d|", i + 1);
+    if (barrido.vehiculosPorHora.numValores > 0)
+        printf(" Veh/h |");
+    if (barrido.numCamiones > 0)
+        printf(" Camiones |");
+    printf(" Vehículos/día | Esperaron/día |  Espera media (us)  | Espera máx. (s)\n");
+}
+
+// Una línea por punto con la media de sus días (± IC 95% de la espera)
+static void mostrar_punto(int punto, const Estadisticas* dias, int numSemillas)
+{
+    printf("%5d |", punto + 1);
+    for (int i = 0; i < NUM_SUBTRAMOS; i++)
+        if (barrido.capacidad[i].numValores > 0)
+            printf(" %5d |", autopista.capacidad[i]);
+    if (barrido.vehiculosPorHora.numValores > 0)
+        printf(" %5d |", escenario.vehiculosPorHora);
+    if (barrido.numCamiones > 0) {
+        char texto[24];
+        snprintf(texto, sizeof(texto), "%d/%d", escenario.camiones.numerador, escenario.camiones.denominador);
+        printf(" %8s |", texto);
+    }
+
+    Acumulador vehiculos, esperaron, espera;
+    iniciar_acumulador(&vehiculos);
+    iniciar_acumulador(&esperaron);
+    iniciar_acumulador(&espera);
+    tiempo_us maxima = 0;
+    for (int r = 0; r < numSemillas; r++) {
+        const Estadisticas* est = &dias[r];
+        long n = 0;
+        tiempo_us total = 0;
+        for (int h = 0; h < NUM_HOMBRILLOS; h++) {
+            n += est->hombrillos[h].totalVehiculosEsperado;
+            total += est->hombrillos[h].tiempoTotalEspera;
+            if (est->hombrillos[h].tiempoMaxEspera > maxima)
+                maxima = est->hombrillos[h].tiempoMaxEspera;
+        }
+        acumular(&vehiculos, est->totalVehiculosDia);
+        acumular(&esperaron, n);
+        if (n > 0)
+            acumular(&espera, (double)total / n);
+    }
+    printf(" %13.1f | %13.1f | %9.0f ± %7.0f | %15.3f\n", vehiculos.media, esperaron.media,
+           espera.media, semiancho_ic95(&espera), (double)maxima / USEG_POR_SEGUNDO);
+}
+
+int main(int argc, char* argv[])
+{
+    int numSemillas = 5;
+    unsigned int semilla = 1;
+    int numProcesos = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    const char* ficheroCache = "barrido.cache";
+
+    if (leer_argumentos_escenario(argc, argv) < 0)
+        return 1;
+    barrido.escenarioBase = escenario;
+    barrido.autopistaBase = autopista;
+
+    for (int i = 1; i < argc; i++) {
+        int ok = 1;
+        if (strncmp(argv[i], "--barrer-capacidad=", 19) == 0) {
+            char* fin;
+            long s = strtol(argv[i] + 19, &fin, 10);
+            ok = fin != argv[i] + 19 && *fin == ':' && s >= 1 && s <= NUM_SUBTRAMOS;
+            // Un vehículo que no cabe nunca bloquearía la autopista
+            if (ok) {
+                const int* peso = autopista.peso[s - 1];
+                int minimo = peso[AUTO] > peso[CAMION] ? peso[AUTO] : peso[CAMION];
+                ok = leer_lista(fin + 1, minimo, &barrido.capacidad[s - 1]) == 0;
+            }
+        } else if (strncmp(argv[i], "--barrer-vehiculos=", 19) == 0) {
+            ok = leer_lista(argv[i] + 19, 1, &barrido.vehiculosPorHora) == 0;
+        } else if (strncmp(argv[i], "--barrer-camiones=", 18) == 0) {
+            ok = leer_proporciones(argv[i] + 18) == 0;
+        } else if (strncmp(argv[i], "--semillas=", 11) == 0) {
+            numSemillas = atoi(argv[i] + 11);
+        } else if (strncmp(argv[i], "--semilla=", 10) == 0) {
+            semilla = (unsigned int)strtoul(argv[i] + 10, NULL, 10);
+        } else if (strncmp(argv[i], "--procesos=", 11) == 0) {
+            numProcesos = atoi(argv[i] + 11);
+        } else if (strncmp(argv[i], "--cache=", 8) == 0) {
+            ficheroCache = argv[i] + 8;
+        } else if (es_opcion_escenario(argv[i])) {
+            // Ya leída por leer_argumentos_escenario()
+        } else {
+            ok = 0;
+        }
+        if (!ok) {
+            fprintf(stderr, "Opción no válida: %s\n", argv[i]);
+            fprintf(stderr, "Uso: %s [--barrer-capacidad=S:LISTA]... [--barrer-vehiculos=LISTA]\n"
+                            "          [--barrer-camiones=N/D,N/D...] [--semillas=R] [--semilla=N]\n"
+                            "          [--procesos=N] [--cache=FICHERO]\n"
+                            "          [--escenario=FICHERO] [--CLAVE=VALOR del escenario]\n"
+                            "LISTA: a,b,c o MIN..MAX[:PASO]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (numSemillas < 2)
+        numSemillas = 2;
+    if (numProcesos < 1)
+        numProcesos = 1;
+
+    long puntos = 1;
+    for (int i = 0; i < NUM_SUBTRAMOS; i++)
+        if (barrido.capacidad[i].numValores > 0)
+            puntos *= barrido.capacidad[i].numValores;
+    if (barrido.vehiculosPorHora.numValores > 0)
+        puntos *= barrido.vehiculosPorHora.numValores;
+    if (barrido.numCamiones > 0)
+        puntos *= barrido.numCamiones;
+    if (puntos * numSemillas > 10000000L) {
+        fprintf(stderr, "Demasiados días: %ld puntos por %d semillas\n", puntos, numSemillas);
+        return 1;
+    }
+    barrido.numPuntos = (int)puntos;
+    int numDias = barrido.numPuntos * numSemillas;
+
+    printf("🧭 BARRIDO DE PARÁMETROS (motor: des)\n");
+    printf("📐 Puntos: %d  🎲 Semillas por punto: %d (desde %u)  ⚙️  Procesos: %d  🗄️  Caché: %s\n",
+           barrido.numPuntos, numSemillas, semilla, numProcesos, ficheroCache);
+    mostrar_autopista();
+    mostrar_escenario();
+    printf("==========================================\n");
+
+    CacheDias cache;
+    if (abrir_cache(&cache, ficheroCache) < 0)
+        return 1;
+
+    unsigned long long* claves = malloc(numDias * sizeof(unsigned long long));
+    Estadisticas* dias = malloc(numDias * sizeof(Estadisticas));
+    int* tareaDe = malloc(numDias * sizeof(int));   // Tarea de cada día, -1 si estaba en la caché
+    if (claves == NULL || dias == NULL || tareaDe == NULL) {
+        perror("malloc");
+        exit(1);
+    }
+
+    // Lo que ya está en la caché no se vuelve a simular
+    Tareas* t = compartida(sizeof(Tareas));
+    t->punto = compartida(numDias * sizeof(int));
+    t->semilla = compartida(numDias * sizeof(unsigned int));
+    t->numTareas = 0;
+    bloquear_cache(&cache);
+    for (int p = 0; p < barrido.numPuntos; p++) {
+        poner_punto(p);
+        for (int r = 0; r < numSemillas; r++) {
+            int d = p * numSemillas + r;
+            claves[d] = clave_dia(semilla + (unsigned int)r);
+            tareaDe[d] = -1;
+            if (!buscar_en_cache(&cache, claves[d], &dias[d])) {
+                tareaDe[d] = t->numTareas;
+                t->punto[t->numTareas] = p;
+                t->semilla[t->numTareas] = semilla + (unsigned int)r;
+                t->numTareas++;
+            }
+        }
+    }
+    soltar_cache(&cache);
+    t->dias = compartida(t->numTareas * sizeof(Estadisticas));
+    t->siguiente = 0;
+
+    struct timespec inicio;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    if (t->numTareas > 0)
+        simular_tareas(t, numProcesos);
+    double segundos = segundos_desde(&inicio);
+
+    bloquear_cache(&cache);
+    for (int d = 0; d < numDias; d++) {
+        if (tareaDe[d] >= 0) {
+            dias[d] = t->dias[tareaDe[d]];
+            guardar_en_cache(&cache, claves[d], &dias[d]);
+        }
+    }
+    unsigned long long guardados = cache.cab->usadas;
+    soltar_cache(&cache);
+
+    mostrar_cabecera();
+    for (int p = 0; p < barrido.numPuntos; p++) {
+        poner_punto(p);
+        mostrar_punto(p, &dias[p * numSemillas], numSemillas);
+    }
+
+    printf("\n🗄️  Días en la caché: %d de %d; simulados %d en %.3f s", numDias - t->numTareas, numDias,
+           t->numTareas, segundos);
+    if (t->numTareas > 0 && segundos > 0)
+        printf(" (%.1f días por segundo)", t->numTareas / segundos);
+    printf("\n🗄️  La caché guarda %llu días\n", guardados);
+
+    munmap(t->dias, t->numTareas > 0 ? t->numTareas * sizeof(Estadisticas) : 1);
+    munmap(t->semilla, numDias * sizeof(unsigned int));
+    munmap(t->punto, numDias * sizeof(int));
+    munmap(t, sizeof(Tareas));
+    free(claves);
+    free(dias);
+    free(tareaDe);
+    cerrar_cache(&cache);
+    printf("🎯 BARRIDO COMPLETADO\n");
+    return 0;
+}
@@ -0,0 +1,234 @@
+// Coste de las estadísticas por vehículo: statsMutex global frente a
+// contadores repartidos por hilo (contadores.h)
+//
+// Compilar (desde "PROYECTO SO"):
+//   gcc -O2 -pthread -Isimulador simulador/*.c simulador/programas/bench_estadisticas.c -o bench_estadisticas -lm
+//
+// Uso:
+//   ./bench_estadisticas [--hilos=1,64] [--vehiculos=N] [--repeticiones=N]
+//
+// Cada hilo registra --vehiculos vehículos seguidos sin simular nada más:
+// la llegada, cada subtramo, una espera en cada hombrillo y la salida, lo
+// mismo que anotan los motores hilos, pool y fibras por vehículo. Así el
+// tiempo es solo el de las estadísticas. La versión con mutex es la que
+// usaban esos motores: statsMutex para llegadas, subtramos y completados y
+// un mutex por hombrillo. A las dos se les resta lo que tarda el mismo
+// bucle sin estadísticas. Se informa la mejor de las repeticiones y se
+// comprueba que las dos versiones cuentan lo mismo.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "trafico.h"
+#include "escenario.h"
+#include "contadores.h"
+
+#define MAX_HILOS_BENCH 1024
+
+typedef struct {
+    pthread_mutex_t statsMutex;
+    pthread_mutex_t mutexHombrillo[MAX_HOMBRILLOS];
+    Estadisticas est;
+} EstadisticasConMutex;
+
+static EstadisticasConMutex conMutex;
+static ContadoresRepartidos repartidos;
+static int vehiculosPorHilo;
+static pthread_barrier_t salida;
+
+static double segundos_desde(const struct timespec* inicio)
+{
+    struct timespec ahora;
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    return (ahora.tv_sec - inicio->tv_sec) + (ahora.tv_nsec - inicio->tv_nsec) / 1e9;
+}
+
+// El vehículo n del hilo; los sorteos solo reparten las cuentas
+static void preparar_vehiculo(Vehiculo* v, int hilo, int n)
+{
+    generar_vehiculo(v, hilo * vehiculosPorHilo + n + 1, (tiempo_us)n * 997 % USEG_TOTAL_SIMULACION, 12345u);
+}
+
+// Lo que cuesta el bucle sin anotar nada
+static void* registrar_nada(void* arg)
+{
+    int hilo = (int)(long)arg;
+    pthread_barrier_wait(&salida);
+    for (int n = 0; n < vehiculosPorHilo; n++) {
+        Vehiculo v;
+        preparar_vehiculo(&v, hilo, n);
+        __asm__ volatile("" : : "r"(&v) : "memory");
+    }
+    return NULL;
+}
+
+static void* registrar_con_mutex(void* arg)
+{
+    int hilo = (int)(long)arg;
+    pthread_barrier_wait(&salida);
+    for (int n = 0; n < vehiculosPorHilo; n++) {
+        Vehiculo v;
+        preparar_vehiculo(&v, hilo, n);
+
+        pthread_mutex_lock(&conMutex.statsMutex);
+        registrar_llegada(&conMutex.est, &v);
+        pthread_mutex_unlock(&conMutex.statsMutex);
+
+        for (int i = 0; i < NUM_SUBTRAMOS; i++) {
+            pthread_mutex_lock(&conMutex.statsMutex);
+            conMutex.est.estadisticasSubtramos[i][v.dir]++;
+            pthread_mutex_unlock(&conMutex.statsMutex);
+        }
+        for (int h = 0; h < NUM_HOMBRILLOS; h++) {
+            pthread_mutex_lock(&conMutex.mutexHombrillo[h]);
+            registrar_entrada_hombrillo(&conMutex.est.hombrillos[h]);
+            pthread_mutex_unlock(&conMutex.mutexHombrillo[h]);
+
+            pthread_mutex_lock(&conMutex.mutexHombrillo[h]);
+            registrar_salida_hombrillo(&conMutex.est.hombrillos[h], n % 1000);
+            pthread_mutex_unlock(&conMutex.mutexHombrillo[h]);
+        }
+
+        pthread_mutex_lock(&conMutex.statsMutex);
+        conMutex.est.vehiculosCompletados++;
+        pthread_mutex_unlock(&conMutex.statsMutex);
+    }
+    return NULL;
+}
+
+static void* registrar_repartido(void* arg)
+{
+    int hilo = (int)(long)arg;
+    FragmentoContadores* f = fragmento_del_hilo(&repartidos);
+    pthread_barrier_wait(&salida);
+    for (int n = 0; n < vehiculosPorHilo; n++) {
+        Vehiculo v;
+        preparar_vehiculo(&v, hilo, n);
+
+        contar_llegada(f, &v);
+        for (int i = 0; i < NUM_SUBTRAMOS; i++)
+            contar_subtramo(f, i, v.dir);
+        for (int h = 0; h < NUM_HOMBRILLOS; h++) {
+            contar_entrada_hombrillo(&repartidos, h);
+            contar_salida_hombrillo(&repartidos, f, h, n % 1000);
+        }
+        contar_completado(f);
+    }
+    return NULL;
+}
+
+static double medir(void* (*funcion)(void*), int numHilos)
+{
+    pthread_t hilos[MAX_HILOS_BENCH];
+    struct timespec inicio;
+    pthread_barrier_init(&salida, NULL, numHilos + 1);
+    for (int t = 0; t < numHilos; t++)
+        pthread_create(&hilos[t], NULL, funcion, (void*)(long)t);
+    // Los hilos esperan en la barrera hasta que llega este, así que se
+    // cuenta desde antes: con pocos núcleos pueden terminar antes de que
+    // este vuelva de la barrera
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    pthread_barrier_wait(&salida);
+    for (int t = 0; t < numHilos; t++)
+        pthread_join(hilos[t], NULL);
+    double s = segundos_desde(&inicio);
+    pthread_barrier_destroy(&salida);
+    return s;
+}
+
+// Lo que sí deben dar igual: todo menos el máximo de vehículos a la vez en
+// un hombrillo, que depende de cómo se intercalen los hilos
+static int mismas_cuentas(Estadisticas* a, Estadisticas* b)
+{
+    for (int h = 0; h < NUM_HOMBRILLOS; h++)
+        a->hombrillos[h].maxEspera = b->hombrillos[h].maxEspera = 0;
+    return memcmp(a, b, sizeof(Estadisticas)) == 0;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* listaHilos = "1,64";
+    int vehiculos = 200000;
+    int repeticiones = 3;
+
+    if (leer_argumentos_escenario(argc, argv) < 0)
+        return 1;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--hilos=", 8) == 0) {
+            listaHilos = argv[i] + 8;
+        } else if (strncmp(argv[i], "--vehiculos=", 12) == 0) {
+            vehiculos = atoi(argv[i] + 12);
+        } else if (strncmp(argv[i], "--repeticiones=", 15) == 0) {
+            repeticiones = atoi(argv[i] + 15);
+        } else if (es_opcion_escenario(argv[i])) {
+            // Ya leída por leer_argumentos_escenario()
+        } else {
+            fprintf(stderr, "Uso: %s [--hilos=1,64] [--vehiculos=N] [--repeticiones=N]\n"
+                            "          [--escenario=FICHERO] [--CLAVE=VALOR del escenario]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (vehiculos < 1)
+        vehiculos = 1;
+    if (repeticiones < 1)
+        repeticiones = 1;
+
+    printf("📈 ESTADÍSTICAS POR VEHÍCULO: STATSMUTEX FRENTE A CONTADORES REPARTIDOS\n");
+    printf("🚗 Vehículos por medición: %d  🔁 Repeticiones: %d  🧩 Fragmentos: %d de %zu bytes\n",
+           vehiculos, repeticiones, MAX_FRAGMENTOS, sizeof(FragmentoContadores));
+    mostrar_autopista();
+    printf("==========================================\n");
+    printf("Hilos | Mutex ns/veh | Repartidos ns/veh | Aceleración\n");
+    printf("------|--------------|-------------------|------------\n");
+
+    const char* p = listaHilos;
+    while (*p) {
+        char* fin;
+        int numHilos = (int)strtol(p, &fin, 10);
+        if (fin == p || numHilos < 1 || numHilos > MAX_HILOS_BENCH) {
+            fprintf(stderr, "Lista de hilos no válida: %s\n", listaHilos);
+            return 1;
+        }
+        p = (*fin == ',') ? fin + 1 : fin;
+
+        vehiculosPorHilo = (vehiculos + numHilos - 1) / numHilos;
+        long total = (long)vehiculosPorHilo * numHilos;
+        double mejorBase = 0, mejorMutex = 0, mejorRepartido = 0;
+        for (int rep = 0; rep < repeticiones; rep++) {
+            double s = medir(registrar_nada, numHilos);
+            if (rep == 0 || s < mejorBase)
+                mejorBase = s;
+
+            pthread_mutex_init(&conMutex.statsMutex, NULL);
+            for (int h = 0; h < NUM_HOMBRILLOS; h++)
+                pthread_mutex_init(&conMutex.mutexHombrillo[h], NULL);
+            iniciar_estadisticas(&conMutex.est);
+            s = medir(registrar_con_mutex, numHilos);
+            if (rep == 0 || s < mejorMutex)
+                mejorMutex = s;
+            pthread_mutex_destroy(&conMutex.statsMutex);
+            for (int h = 0; h < NUM_HOMBRILLOS; h++)
+                pthread_mutex_destroy(&conMutex.mutexHombrillo[h]);
+
+            iniciar_contadores(&repartidos);
+            s = medir(registrar_repartido, numHilos);
+            if (rep == 0 || s < mejorRepartido)
+                mejorRepartido = s;
+
+            Estadisticas juntas;
+            juntar_contadores(&repartidos, &juntas);
+            if (!mismas_cuentas(&conMutex.est, &juntas)) {
+                fprintf(stderr, "❌ Con %d hilos los contadores repartidos no cuentan lo mismo\n", numHilos);
+                return 1;
+            }
+        }
+        double nsMutex = (mejorMutex - mejorBase) * 1e9 / total;
+        double nsRepartido = (mejorRepartido - mejorBase) * 1e9 / total;
+        printf("%5d | %12.1f | %17.1f | %9.2fx\n", numHilos, nsMutex, nsRepartido, nsMutex / nsRepartido);
+    }
+    printf("✅ Las dos versiones cuentan lo mismo\n");
+    printf("🎯 BENCHMARK COMPLETADO\n");
+    return 0;
+}
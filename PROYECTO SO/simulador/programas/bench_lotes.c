@@ -0,0 +1,120 @@
+// Réplicas por segundo: motor DES (una réplica tras otra) frente al motor
+// por lotes (CARRILES réplicas a la vez en vectores)
+//
+// Compilar (desde "PROYECTO SO"):
+//   gcc -O2 -march=native -pthread -Isimulador simulador/*.c simulador/programas/bench_lotes.c -o bench_lotes -lm
+// Con -DCARRILES=16 los lotes son de 16 réplicas y con -DCARRILES=1 el
+// motor por lotes queda escalar (la versión de respaldo sin SIMD).
+//
+// Uso:
+//   ./bench_lotes [--replicas=R] [--semilla=N] [--repeticiones=N]
+//                 [--escenario=FICHERO] [--CLAVE=VALOR del escenario]
+//
+// Antes de medir comprueba que cada réplica del lote da exactamente las
+// mismas estadísticas que el motor DES con su semilla.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "trafico.h"
+#include "escenario.h"
+#include "motor_des.h"
+#include "motor_lotes.h"
+#include "politica.h"
+
+static double segundos_desde(const struct timespec* inicio)
+{
+    struct timespec ahora;
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    return (ahora.tv_sec - inicio->tv_sec) + (ahora.tv_nsec - inicio->tv_nsec) / 1e9;
+}
+
+int main(int argc, char* argv[])
+{
+    int numReplicas = 256;
+    unsigned int semilla = 12345u;
+    int repeticiones = 3;
+
+    if (leer_argumentos_escenario(argc, argv) < 0)
+        return 1;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--replicas=", 11) == 0) {
+            numReplicas = atoi(argv[i] + 11);
+        } else if (strncmp(argv[i], "--semilla=", 10) == 0) {
+            semilla = (unsigned int)strtoul(argv[i] + 10, NULL, 10);
+        } else if (strncmp(argv[i], "--repeticiones=", 15) == 0) {
+            repeticiones = atoi(argv[i] + 15);
+        } else if (es_opcion_escenario(argv[i])) {
+            // Ya leída por leer_argumentos_escenario()
+        } else {
+            fprintf(stderr, "Uso: %s [--replicas=R] [--semilla=N] [--repeticiones=N]\n"
+                            "          [--escenario=FICHERO] [--CLAVE=VALOR del escenario]\n", argv[0]);
+            return 1;
+        }
+    }
+    // El motor por lotes lleva la regla de capacidad en vectores y no tiene
+    // colas que una política pueda recorrer
+    if (!es_politica_por_defecto()) {
+        fprintf(stderr, "El motor por lotes solo admite la política cabe\n");
+        return 1;
+    }
+    if (numReplicas < 1)
+        numReplicas = 1;
+    if (repeticiones < 1)
+        repeticiones = 1;
+
+    unsigned int* semillas = malloc(numReplicas * sizeof(unsigned int));
+    Estadisticas* des = malloc(numReplicas * sizeof(Estadisticas));
+    Estadisticas* lotes = malloc(numReplicas * sizeof(Estadisticas));
+    if (semillas == NULL || des == NULL || lotes == NULL) {
+        perror("malloc");
+        exit(1);
+    }
+    for (int r = 0; r < numReplicas; r++)
+        semillas[r] = semilla + r;
+
+    printf("📈 RÉPLICAS POR SEGUNDO: DES FRENTE A LOTES DE %d CARRILES\n", CARRILES);
+    printf("🔁 Réplicas: %d  🎲 Semillas: %u..%u  🔁 Repeticiones: %d\n",
+           numReplicas, semilla, semilla + numReplicas - 1, repeticiones);
+    mostrar_autopista();
+    mostrar_escenario();
+    printf("==========================================\n");
+
+    double mejorDes = 0, mejorLotes = 0;
+    for (int rep = 0; rep < repeticiones; rep++) {
+        struct timespec inicio;
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        for (int r = 0; r < numReplicas; r++)
+            ejecutar_motor_des(semillas[r], &des[r]);
+        double s = segundos_desde(&inicio);
+        if (rep == 0 || s < mejorDes)
+            mejorDes = s;
+
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        ejecutar_motor_lotes(semillas, numReplicas, lotes);
+        s = segundos_desde(&inicio);
+        if (rep == 0 || s < mejorLotes)
+            mejorLotes = s;
+
+        // iniciar_estadisticas() deja a cero también el relleno
+        for (int r = 0; r < numReplicas; r++) {
+            if (memcmp(&des[r], &lotes[r], sizeof(Estadisticas)) != 0) {
+                fprintf(stderr, "❌ La réplica con semilla %u no coincide con el motor DES\n", semillas[r]);
+                return 1;
+            }
+        }
+    }
+
+    printf("Motor | Segundos | Réplicas/s | Aceleración\n");
+    printf("------|----------|------------|------------\n");
+    printf("des   | %8.3f | %10.1f | %9.2fx\n", mejorDes, numReplicas / mejorDes, 1.0);
+    printf("lotes | %8.3f | %10.1f | %9.2fx\n", mejorLotes, numReplicas / mejorLotes, mejorDes / mejorLotes);
+    printf("✅ Las %d réplicas coinciden con el motor DES\n", numReplicas);
+
+    free(semillas);
+    free(des);
+    free(lotes);
+    printf("🎯 BENCHMARK COMPLETADO\n");
+    return 0;
+}
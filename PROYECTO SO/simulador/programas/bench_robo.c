@@ -0,0 +1,89 @@
+// Escalado del motor de fibras con robo de trabajo de 1 a N hilos
+//
+// Compilar (desde "PROYECTO SO"):
+//   gcc -O2 -pthread -Isimulador simulador/*.c simulador/programas/bench_robo.c -o bench_robo -lm
+//
+// Uso:
+//   ./bench_robo [--max-hilos=N] [--vehiculos=N] [--acelerar=N] [--repeticiones=N]
+//
+// Cada medición lanza --vehiculos vehículos a la vez (el límite de un
+// VEHICULOS_POR_HORA muy alto) con el reloj acelerado, de modo que los
+// usleep del modelo casi no cuentan y lo que se mide es el trabajo de
+// planificar y despertar fibras. Se informa la mejor de las repeticiones.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "trafico.h"
+#include "motor_fibras.h"
+
+static double segundos_desde(const struct timespec* inicio)
+{
+    struct timespec ahora;
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    return (ahora.tv_sec - inicio->tv_sec) + (ahora.tv_nsec - inicio->tv_nsec) / 1e9;
+}
+
+int main(int argc, char* argv[])
+{
+    int maxHilos = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int vehiculos = 200000;
+    int aceleracion = 1000000;
+    int repeticiones = 3;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--max-hilos=", 12) == 0) {
+            maxHilos = atoi(argv[i] + 12);
+        } else if (strncmp(argv[i], "--vehiculos=", 12) == 0) {
+            vehiculos = atoi(argv[i] + 12);
+        } else if (strncmp(argv[i], "--acelerar=", 11) == 0) {
+            aceleracion = atoi(argv[i] + 11);
+        } else if (strncmp(argv[i], "--repeticiones=", 15) == 0) {
+            repeticiones = atoi(argv[i] + 15);
+        } else {
+            fprintf(stderr, "Uso: %s [--max-hilos=N] [--vehiculos=N] [--acelerar=N] [--repeticiones=N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (maxHilos < 1)
+        maxHilos = 1;
+    if (repeticiones < 1)
+        repeticiones = 1;
+
+    printf("📈 ESCALADO DEL MOTOR DE FIBRAS (robo de trabajo)\n");
+    printf("🚗 Vehículos simultáneos: %d  ⏩ Aceleración: %d  🔁 Repeticiones: %d\n",
+           vehiculos, aceleracion, repeticiones);
+    printf("🖥️  Núcleos en línea: %ld\n", sysconf(_SC_NPROCESSORS_ONLN));
+    printf("==========================================\n");
+    printf("Hilos | Segundos | Vehículos/s | Aceleración\n");
+    printf("------|----------|-------------|------------\n");
+
+    double base = 0;
+    for (int hilos = 1; hilos <= maxHilos; hilos++) {
+        double mejor = 0;
+        for (int r = 0; r < repeticiones; r++) {
+            Estadisticas est;
+            OpcionesFibras op = { hilos, PILA_FIBRA_RAFAGA, vehiculos };
+            struct timespec inicio;
+            clock_gettime(CLOCK_MONOTONIC, &inicio);
+            ejecutar_motor_fibras(12345u + r, aceleracion, &op, &est);
+            double s = segundos_desde(&inicio);
+
+            if (est.vehiculosCompletados != vehiculos) {
+                fprintf(stderr, "❌ Con %d hilos terminaron %d de %d vehículos\n",
+                        hilos, est.vehiculosCompletados, vehiculos);
+                return 1;
+            }
+            if (r == 0 || s < mejor)
+                mejor = s;
+        }
+        if (hilos == 1)
+            base = mejor;
+        printf("%5d | %8.3f | %11.0f | %9.2fx\n", hilos, mejor, vehiculos / mejor, base / mejor);
+    }
+
+    printf("🎯 BENCHMARK COMPLETADO\n");
+    return 0;
+}
@@ -0,0 +1,145 @@
+// Comprueba que des, timewarp y cmb dan el mismo día con la misma semilla
+//
+// Compilar (desde "PROYECTO SO"):
+//   gcc -O2 -pthread -Isimulador simulador/*.c simulador/programas/comprobar_motores.c -o comprobar_motores -lm
+//
+// Uso:
+//   ./comprobar_motores [--semillas=N] [--max-hilos=N] [--max-procesos=N]
+//
+// Los tres ejecutan el mismo modelo (modelo_pl.h) con el mismo orden total
+// de eventos: des en un hilo, timewarp repartido en hilos con retrocesos y
+// cmb repartido en procesos. Para cada escenario de la lista y cada semilla
+// de 1 a --semillas (5 por defecto) simula el día con des y lo compara campo
+// a campo con timewarp de 1 a --max-hilos hilos (4) y con cmb de 1 a
+// --max-procesos procesos (4). Termina con 1 y dice qué campo difiere en
+// cuanto uno no coincide.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "trafico.h"
+#include "escenario.h"
+#include "politica.h"
+#include "motor_des.h"
+#include "motor_timewarp.h"
+#include "motor_cmb.h"
+
+typedef struct {
+    const char* nombre;
+    const char* opciones[3];  // clave=valor sobre el escenario por defecto
+} EscenarioPrueba;
+
+static const EscenarioPrueba escenarios[] = {
+    { "por defecto",                 { NULL } },
+    { "política fifo",               { "politica=fifo" } },
+    { "política camiones",           { "politica=camiones" } },
+    { "mitad camiones, 3/4 hacia 1", { "camiones=1/2", "sentido-4a1=3/4" } },
+    { "ocho subtramos",              { "subtramos=4,2/1/2,2,3*2,2/1/2,1,3" } },
+};
+
+#define NUM_ESCENARIOS (int)(sizeof(escenarios) / sizeof(escenarios[0]))
+
+// Campo a campo: las estructuras llevan relleno que no se copia igual
+static const char* diferencia(const Estadisticas* a, const Estadisticas* b)
+{
+    static char campo[64];
+    if (a->totalVehiculosDia != b->totalVehiculosDia)
+        return "totalVehiculosDia";
+    if (a->vehiculosCompletados != b->vehiculosCompletados)
+        return "vehiculosCompletados";
+    for (int h = 0; h < 24; h++)
+        for (int d = 0; d < 2; d++)
+            if (a->estadisticasHorarias[h][d] != b->estadisticasHorarias[h][d]) {
+                snprintf(campo, sizeof(campo), "estadisticasHorarias[%d][%d]", h, d);
+                return campo;
+            }
+    for (int i = 0; i < NUM_SUBTRAMOS; i++)
+        for (int d = 0; d < 2; d++)
+            if (a->estadisticasSubtramos[i][d] != b->estadisticasSubtramos[i][d]) {
+                snprintf(campo, sizeof(campo), "estadisticasSubtramos[%d][%d]", i, d);
+                return campo;
+            }
+    for (int h = 0; h < NUM_HOMBRILLOS; h++) {
+        const EstadisticaHombrillo* x = &a->hombrillos[h];
+        const EstadisticaHombrillo* y = &b->hombrillos[h];
+        if (x->vehiculosEsperando != y->vehiculosEsperando || x->maxEspera != y->maxEspera
+            || x->tiempoMaxEspera != y->tiempoMaxEspera || x->tiempoTotalEspera != y->tiempoTotalEspera
+            || x->totalVehiculosEsperado != y->totalVehiculosEsperado) {
+            snprintf(campo, sizeof(campo), "hombrillos[%d]", h);
+            return campo;
+        }
+    }
+    return NULL;
+}
+
+static int comparar(const char* escenarioNombre, unsigned int semilla, const char* motor, int reparto,
+                    const Estadisticas* des, const Estadisticas* otro)
+{
+    const char* campo = diferencia(des, otro);
+    if (campo == NULL)
+        return 1;
+    printf("❌ %s, semilla %u: %s con %d difiere de des en %s\n", escenarioNombre, semilla, motor, reparto, campo);
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    int numSemillas = 5;
+    int maxHilos = 4;
+    int maxProcesos = 4;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--semillas=", 11) == 0) {
+            numSemillas = atoi(argv[i] + 11);
+        } else if (strncmp(argv[i], "--max-hilos=", 12) == 0) {
+            maxHilos = atoi(argv[i] + 12);
+        } else if (strncmp(argv[i], "--max-procesos=", 15) == 0) {
+            maxProcesos = atoi(argv[i] + 15);
+        } else {
+            fprintf(stderr, "Uso: %s [--semillas=N] [--max-hilos=N] [--max-procesos=N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    printf("🔍 COMPROBANDO QUE des, timewarp Y cmb DAN EL MISMO DÍA\n");
+    Escenario escenarioBase = escenario;
+    Autopista autopistaBase = autopista;
+    const PoliticaAdmision* politicaBase = politicaAdmision;
+    int comparaciones = 0;
+
+    for (int k = 0; k < NUM_ESCENARIOS; k++) {
+        escenario = escenarioBase;
+        autopista = autopistaBase;
+        politicaAdmision = politicaBase;
+        for (int o = 0; escenarios[k].opciones[o] != NULL; o++) {
+            char clave[32];
+            const char* igual = strchr(escenarios[k].opciones[o], '=');
+            snprintf(clave, sizeof(clave), "%.*s", (int)(igual - escenarios[k].opciones[o]), escenarios[k].opciones[o]);
+            if (aplicar_opcion_escenario(clave, igual + 1) < 0)
+                return 1;
+        }
+
+        for (unsigned int semilla = 1; semilla <= (unsigned int)numSemillas; semilla++) {
+            Estadisticas des, otro;
+            ejecutar_motor_des(semilla, &des);
+            for (int h = 1; h <= maxHilos; h++) {
+                EstadisticasTimeWarp tw;
+                ejecutar_motor_timewarp(semilla, h, &otro, &tw);
+                if (!comparar(escenarios[k].nombre, semilla, "timewarp", h, &des, &otro))
+                    return 1;
+                comparaciones++;
+            }
+            for (int p = 1; p <= maxProcesos; p++) {
+                EstadisticasCMB ecmb;
+                ejecutar_motor_cmb(semilla, p, &otro, &ecmb);
+                if (!comparar(escenarios[k].nombre, semilla, "cmb", p, &des, &otro))
+                    return 1;
+                comparaciones++;
+            }
+        }
+        printf("✅ %s: %d semillas iguales\n", escenarios[k].nombre, numSemillas);
+    }
+
+    printf("🎯 %d COMPARACIONES, TODAS IGUALES\n", comparaciones);
+    return 0;
+}
@@ -0,0 +1,279 @@
+// Estimación analítica de un día (analitico.h) y su error frente a la simulación
+//
+// Compilar (desde "PROYECTO SO"):
+//   gcc -O2 -pthread -Isimulador simulador/*.c simulador/programas/estimar.c -o estimar -lm
+//
+// Uso:
+//   ./estimar [--comparar[=R]] [--semilla=N]
+//             [--escenario=FICHERO] [--CLAVE=VALOR del escenario]
+//   ./estimar --validar[=R] [--semilla=N]
+//
+// Sin más opciones da al instante la utilización de cada subtramo, las
+// salidas por hora y la espera media en cada hombrillo del escenario.
+// --comparar simula además R días con el motor de eventos discretos (30
+// por defecto) y pone junto a cada cifra la media simulada, su intervalo
+// al 95% y el error relativo de la estimación. --validar hace lo mismo con
+// los escenarios estándar (el base y unos cuantos "¿y si...?" sobre él,
+// entre ellos los tiempos de Gamma2-1) y termina con una tabla del
+// error de cada uno, que es la que dice cuándo fiarse de la estimación.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "trafico.h"
+#include "escenario.h"
+#include "politica.h"
+#include "motor_des.h"
+#include "analitico.h"
+#include "estadistica.h"
+
+// Menos vehículos que esperan al día que esto y la media simulada es puro ruido
+#define MIN_ESPERARON 20
+
+typedef struct {
+    const char* nombre;
+    const char* opciones[3];  // clave=valor sobre el escenario por defecto
+} EscenarioEstandar;
+
+static const EscenarioEstandar estandar[] = {
+    { "base (por defecto)",          { NULL } },
+    { "subtramo 3 con capacidad 2",  { "subtramos=4,2/1/2,2,3" } },
+    { "la mitad camiones",           { "camiones=1/2" } },
+    { "llegadas un 8% más seguidas", { "llegada-min-us=50000" } },
+    { "tres de cada cuatro 4→1",     { "sentido-4a1=3/4" } },
+    { "tiempos de Gamma2-1",         { "unidad-subtramo-us=40000" } },
+    { "subtramos un 20% más lentos", { "unidad-subtramo-us=42000" } },
+    { "ocho subtramos",              { "subtramos=4,2/1/2,2,3*2,2/1/2,1,3" } },
+};
+
+#define NUM_ESTANDAR (int)(sizeof(estandar) / sizeof(estandar[0]))
+
+typedef struct {
+    Acumulador vehiculosHora;
+    Acumulador esperaron[MAX_HOMBRILLOS];
+    Acumulador espera[MAX_HOMBRILLOS];      // us, de los días en que alguien esperó
+    double segundos;
+} Simulado;
+
+typedef struct {
+    double errorVehiculos;
+    double errorEspera;     // Media de |error| en los hombrillos con bastantes esperas
+    double peorEspera;
+    int hombrillosMedidos;
+    double peorEsperaron;   // Error de los vehículos que esperan al día, el mayor en valor absoluto
+    int hombrillosContados;
+} ErrorEscenario;
+
+static double segundos_desde(const struct timespec* inicio)
+{
+    struct timespec ahora;
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    return (ahora.tv_sec - inicio->tv_sec) + (ahora.tv_nsec - inicio->tv_nsec) / 1e9;
+}
+
+static void simular(int numDias, unsigned int semilla, Simulado* s)
+{
+    iniciar_acumulador(&s->vehiculosHora);
+    for (int h = 0; h < NUM_HOMBRILLOS; h++) {
+        iniciar_acumulador(&s->esperaron[h]);
+        iniciar_acumulador(&s->espera[h]);
+    }
+
+    struct timespec inicio;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    for (int r = 0; r < numDias; r++) {
+        Estadisticas est;
+        ejecutar_motor_des(semilla + (unsigned int)r, &est);
+        acumular(&s->vehiculosHora, (double)est.totalVehiculosDia / HORAS_SIMULACION);
+        for (int h = 0; h < NUM_HOMBRILLOS; h++) {
+            const EstadisticaHombrillo* hb = &est.hombrillos[h];
+            acumular(&s->esperaron[h], hb->totalVehiculosEsperado);
+            if (hb->totalVehiculosEsperado > 0)
+                acumular(&s->espera[h], (double)hb->tiempoTotalEspera / hb->totalVehiculosEsperado);
+        }
+    }
+    s->segundos = segundos_desde(&inicio);
+}
+
+static double error_relativo(double estimado, double simulado)
+{
+    return simulado != 0 ? 100 * (estimado - simulado) / simulado : 0;
+}
+
+static void mostrar_comparacion(const EstimacionDia* e, const Simulado* s, int numDias, ErrorEscenario* err)
+{
+    printf("\n⚖️  ESTIMACIÓN FRENTE A %d DÍAS SIMULADOS (motor des, media ± IC 95%%):\n", numDias);
+    err->errorVehiculos = error_relativo(e->llegadasPorHora, s->vehiculosHora.media);
+    printf("Vehículos por hora: %.1f estimados, %.1f ± %.1f simulados (%+.1f%%)\n",
+           e->llegadasPorHora, s->vehiculosHora.media, semiancho_ic95(&s->vehiculosHora), err->errorVehiculos);
+
+    printf("\nHombrillo | Esperan: est.  simulado            error | Espera (us): est.  simulado               error\n");
+    printf("----------|-----------------------------------------|----------------------------------------------\n");
+    err->errorEspera = 0;
+    err->peorEspera = 0;
+    err->hombrillosMedidos = 0;
+    err->peorEsperaron = 0;
+    err->hombrillosContados = 0;
+    for (int h = 0; h < NUM_HOMBRILLOS; h++) {
+        const Acumulador* esperaron = &s->esperaron[h];
+        const Acumulador* espera = &s->espera[h];
+        double errorEsperaron = error_relativo(e->esperaronHombrillo[h], esperaron->media);
+        printf("%5d-%-3d | %13.1f %8.1f ± %6.1f %+8.1f%% | ", h + 1, h + 2, e->esperaronHombrillo[h],
+               esperaron->media, semiancho_ic95(esperaron), errorEsperaron);
+        // Cuenta también si la estimación pone esperas donde casi no las hay
+        if (esperaron->media >= MIN_ESPERARON
+            || (esperaron->media > 0 && e->esperaronHombrillo[h] >= MIN_ESPERARON)) {
+            if (fabs(errorEsperaron) > fabs(err->peorEsperaron))
+                err->peorEsperaron = errorEsperaron;
+            err->hombrillosContados++;
+        }
+        if (e->esperaHombrillo[h] < 0) {
+            printf("%17s %9.0f ± %7.0f %9s\n", "sin límite", espera->media, semiancho_ic95(espera), "-");
+            continue;
+        }
+        double error = error_relativo(e->esperaHombrillo[h], espera->media);
+        printf("%17.0f %9.0f ± %7.0f %+8.1f%%%s\n", e->esperaHombrillo[h], espera->media, semiancho_ic95(espera),
+               error, esperaron->media < MIN_ESPERARON ? " (pocas esperas)" : "");
+        if (esperaron->media >= MIN_ESPERARON) {
+            err->errorEspera += fabs(error);
+            if (fabs(error) > fabs(err->peorEspera))
+                err->peorEspera = error;
+            err->hombrillosMedidos++;
+        }
+    }
+    if (err->hombrillosMedidos > 0)
+        err->errorEspera /= err->hombrillosMedidos;
+}
+
+// printf("%-*s") cuenta bytes y los nombres llevan tildes y flechas
+static void mostrar_nombre(const char* nombre, int ancho)
+{
+    int letras = 0;
+    for (const char* c = nombre; *c != '\0'; c++)
+        if ((*c & 0xC0) != 0x80)
+            letras++;
+    printf("%s%*s", nombre, ancho > letras ? ancho - letras : 0, "");
+}
+
+static void validar(int numDias, unsigned int semilla)
+{
+    Escenario escenarioBase = escenario;
+    Autopista autopistaBase = autopista;
+    const PoliticaAdmision* politicaBase = politicaAdmision;
+    ErrorEscenario errores[NUM_ESTANDAR];
+    int saturados[NUM_ESTANDAR];
+    double rho[NUM_ESTANDAR];
+
+    for (int k = 0; k < NUM_ESTANDAR; k++) {
+        escenario = escenarioBase;
+        autopista = autopistaBase;
+        politicaAdmision = politicaBase;
+        for (int o = 0; estandar[k].opciones[o] != NULL; o++) {
+            char clave[32];
+            const char* igual = strchr(estandar[k].opciones[o], '=');
+            snprintf(clave, sizeof(clave), "%.*s", (int)(igual - estandar[k].opciones[o]), estandar[k].opciones[o]);
+            if (aplicar_opcion_escenario(clave, igual + 1) < 0)
+                exit(1);
+        }
+
+        printf("\n==========================================\n");
+        printf("📐 ESCENARIO %d: %s\n", k + 1, estandar[k].nombre);
+        mostrar_autopista();
+        EstimacionDia e;
+        estimar_dia(&e);
+        mostrar_estimacion(&e);
+        Simulado s;
+        simular(numDias, semilla, &s);
+        mostrar_comparacion(&e, &s, numDias, &errores[k]);
+        saturados[k] = e.saturado;
+        rho[k] = e.utilizacion[e.cuello];
+    }
+
+    printf("\n==========================================\n");
+    printf("📋 ERROR DE LA ESTIMACIÓN EN LOS ESCENARIOS ESTÁNDAR\n");
+    printf("(espera: media de |error| en los hombrillos con %d o más esperas al día; esperan: el\n"
+           " peor error en los vehículos que esperan al día, en los hombrillos con %d o más\n"
+           " esperas simuladas o estimadas)\n", MIN_ESPERARON, MIN_ESPERARON);
+    printf("Escenario                    | Cuello | Vehículos/h | Espera media |  Peor   | Esperan peor\n");
+    printf("-----------------------------|--------|-------------|--------------|---------|-------------\n");
+    for (int k = 0; k < NUM_ESTANDAR; k++) {
+        mostrar_nombre(estandar[k].nombre, 28);
+        printf(" | %6.3f | %+10.1f%% | ", rho[k], errores[k].errorVehiculos);
+        if (saturados[k])
+            printf("%12s | %7s | ", "saturado", "-");
+        else if (errores[k].hombrillosMedidos == 0)
+            printf("%12s | %7s | ", "sin esperas", "-");
+        else
+            printf("%11.1f%% | %+6.0f%% | ", errores[k].errorEspera, errores[k].peorEspera);
+        if (saturados[k] || errores[k].hombrillosContados == 0)
+            printf("%12s\n", "-");
+        else
+            printf("%+11.0f%%\n", errores[k].peorEsperaron);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    int numDias = 0;
+    int validando = 0;
+    unsigned int semilla = 1;
+
+    if (leer_argumentos_escenario(argc, argv) < 0)
+        return 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--comparar") == 0) {
+            numDias = 30;
+        } else if (strncmp(argv[i], "--comparar=", 11) == 0) {
+            numDias = atoi(argv[i] + 11);
+        } else if (strcmp(argv[i], "--validar") == 0) {
+            validando = 1;
+            numDias = 30;
+        } else if (strncmp(argv[i], "--validar=", 10) == 0) {
+            validando = 1;
+            numDias = atoi(argv[i] + 10);
+        } else if (strncmp(argv[i], "--semilla=", 10) == 0) {
+            semilla = (unsigned int)strtoul(argv[i] + 10, NULL, 10);
+        } else if (es_opcion_escenario(argv[i])) {
+            // Ya leída por leer_argumentos_escenario()
+        } else {
+            fprintf(stderr, "Uso: %s [--comparar[=R]] [--semilla=N]\n"
+                            "          [--escenario=FICHERO] [--CLAVE=VALOR del escenario]\n"
+                            "       %s --validar[=R] [--semilla=N]\n", argv[0], argv[0]);
+            return 1;
+        }
+    }
+    if ((validando || numDias > 0) && numDias < 2)
+        numDias = 2;
+
+    printf("🧮 ESTIMADOR ANALÍTICO (colas GI/G/c en fila, dos momentos)\n");
+    if (validando) {
+        validar(numDias, semilla);
+        printf("🎯 VALIDACIÓN COMPLETADA\n");
+        return 0;
+    }
+
+    mostrar_autopista();
+    mostrar_escenario();
+    if (!es_politica_por_defecto())
+        printf("⚠️  La estimación supone la política \"cabe\"; la simulación usa \"%s\"\n", politicaAdmision->nombre);
+
+    struct timespec inicio;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    EstimacionDia e;
+    estimar_dia(&e);
+    double segundos = segundos_desde(&inicio);
+    mostrar_estimacion(&e);
+    printf("⏱️  Estimación en %.1f us\n", segundos * 1e6);
+
+    if (numDias > 0) {
+        Simulado s;
+        ErrorEscenario err;
+        simular(numDias, semilla, &s);
+        mostrar_comparacion(&e, &s, numDias, &err);
+        printf("⏱️  Simulación en %.3f s\n", s.segundos);
+    }
+    printf("🎯 ESTIMACIÓN COMPLETADA\n");
+    return 0;
+}
@@ -0,0 +1,360 @@
+// Lector de trazas binarias (traza.h) del simulador
+//
+// Compilar (desde "PROYECTO SO"):
+//   gcc -O2 -pthread -Isimulador simulador/*.c simulador/programas/leer_traza.c -o leer_traza -lm
+//
+// Uso:
+//   ./leer_traza FICHERO [--eventos] [--vehiculo=ID] [--repeticiones=N] [--chrome=SALIDA]
+//
+// Sin opciones resume la traza: eventos por clase, entradas por subtramo,
+// esperas por hombrillo y a qué velocidad se decodifica (la mejor de
+// --repeticiones pasadas sobre el fichero ya proyectado en memoria, sin
+// contar la lectura del disco). --eventos escribe cada evento en una línea
+// de texto, y --vehiculo solo los de ese vehículo.
+//
+// --chrome escribe la traza en el formato JSON de Chrome (chrome://tracing
+// o ui.perfetto.dev) con el tiempo del modelo: cada vehículo es una pista
+// con su viaje, un tramo por subtramo recorrido, la espera en la entrada
+// bloqueado en el semáforo del primer subtramo y las esperas en hombrillos
+// bloqueado en el del siguiente. La ocupación de cada subtramo y los
+// vehículos esperando en cada hombrillo van como contadores. Se hace
+// después de la simulación, así que a ella solo le cuesta la traza binaria.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+
+#include "trafico.h"
+#include "registro.h"
+#include "traza.h"
+
+static const char* nombresClase[] = { "inicia", "entra", "circula", "sale", "lleno", "espero", "termina" };
+#define NUM_CLASES ((int)(sizeof(nombresClase) / sizeof(nombresClase[0])))
+
+typedef struct {
+    long bloques;
+    long eventos;
+    long porClase[8];
+    long entradas[MAX_SUBTRAMOS][2];
+    long esperas[MAX_HOMBRILLOS];
+    tiempo_us esperaTotal[MAX_HOMBRILLOS];
+    tiempo_us esperaMax[MAX_HOMBRILLOS];
+    tiempo_us ultimo;
+} Resumen;
+
+static double segundos_desde(const struct timespec* inicio)
+{
+    struct timespec ahora;
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    return (ahora.tv_sec - inicio->tv_sec) + (ahora.tv_nsec - inicio->tv_nsec) / 1e9;
+}
+
+static void acumular(Resumen* r, const EventoTraza* ev, int n)
+{
+    for (int k = 0; k < n; k++) {
+        r->porClase[ev[k].clase & 7]++;
+        if (ev[k].t > r->ultimo)
+            r->ultimo = ev[k].t;
+        if (ev[k].clase == REG_ENTRA && ev[k].lugar >= 0 && ev[k].lugar < MAX_SUBTRAMOS) {
+            r->entradas[ev[k].lugar][ev[k].dir]++;
+        } else if (ev[k].clase == REG_ESPERO && ev[k].lugar >= 0 && ev[k].lugar < MAX_HOMBRILLOS) {
+            r->esperas[ev[k].lugar]++;
+            r->esperaTotal[ev[k].lugar] += ev[k].valor;
+            if (ev[k].valor > r->esperaMax[ev[k].lugar])
+                r->esperaMax[ev[k].lugar] = ev[k].valor;
+        }
+    }
+    r->eventos += n;
+    r->bloques++;
+}
+
+static void escribir_eventos(const EventoTraza* ev, int n, int vehiculo)
+{
+    for (int k = 0; k < n; k++) {
+        if (vehiculo > 0 && ev[k].vehiculo != vehiculo)
+            continue;
+        printf("%lld %d %s %s %s %d %lld\n", ev[k].t, ev[k].vehiculo,
+               ev[k].clase < NUM_CLASES ? nombresClase[ev[k].clase] : "?",
+               ev[k].tipo == CAMION ? "camion" : "auto", ev[k].dir == DIR_1A4 ? "1a4" : "4a1",
+               ev[k].lugar, ev[k].valor);
+    }
+}
+
+// Conversión al formato de Chrome
+//
+// Los bloques de varios procesos (motor procesos) y los de los motores con
+// reloj real no están del todo en orden, y los contadores se calculan
+// acumulando: primero se ordenan todos los eventos por tiempo, y a igual
+// tiempo en el orden del fichero
+typedef struct {
+    EventoTraza ev;
+    long orden;
+} EventoOrdenado;
+
+typedef struct {
+    tiempo_us inicio;           // INICIA
+    char entro;                 // Ya tiene el primer subtramo
+} ViajeChrome;
+
+static int comparar_eventos(const void* x, const void* y)
+{
+    const EventoOrdenado* a = x;
+    const EventoOrdenado* b = y;
+    if (a->ev.t != b->ev.t)
+        return a->ev.t < b->ev.t ? -1 : 1;
+    return (a->orden > b->orden) - (a->orden < b->orden);
+}
+
+static EventoOrdenado* cargar_eventos(LectorTraza* l, const char* fichero, long* total, int* maxVehiculo)
+{
+    static EventoTraza bloque[TRAZA_EVENTOS_POR_BLOQUE];
+    long n = 0, capacidad = 0;
+    EventoOrdenado* eventos = NULL;
+    int leidos;
+
+    *maxVehiculo = 0;
+    rebobinar_lector_traza(l);
+    while ((leidos = leer_bloque_traza(l, bloque)) > 0) {
+        if (n + leidos > capacidad) {
+            capacidad = (n + leidos) * 2;
+            eventos = realloc(eventos, capacidad * sizeof(EventoOrdenado));
+            if (eventos == NULL) {
+                perror("realloc");
+                exit(1);
+            }
+        }
+        for (int k = 0; k < leidos; k++, n++) {
+            eventos[n].ev = bloque[k];
+            eventos[n].orden = n;
+            if (bloque[k].vehiculo > *maxVehiculo)
+                *maxVehiculo = bloque[k].vehiculo;
+        }
+    }
+    if (leidos < 0) {
+        fprintf(stderr, "%s: bloque corrupto\n", fichero);
+        exit(1);
+    }
+    qsort(eventos, n, sizeof(EventoOrdenado), comparar_eventos);
+    *total = n;
+    return eventos;
+}
+
+// Cada evento JSON en su línea; la coma va delante de todos menos el primero
+static void evento_json(FILE* f, long* escritos, const char* formato, ...)
+    __attribute__((format(printf, 3, 4)));
+
+static void evento_json(FILE* f, long* escritos, const char* formato, ...)
+{
+    va_list args;
+    fputs(*escritos ? ",\n" : "\n", f);
+    va_start(args, formato);
+    vfprintf(f, formato, args);
+    va_end(args);
+    (*escritos)++;
+}
+
+#define PID_VEHICULOS 1
+#define PID_AUTOPISTA 2
+
+static int exportar_chrome(LectorTraza* l, const char* fichero, const char* salida)
+{
+    long total;
+    int maxVehiculo;
+    EventoOrdenado* eventos = cargar_eventos(l, fichero, &total, &maxVehiculo);
+    ViajeChrome* viajes = calloc(maxVehiculo + 1, sizeof(ViajeChrome));
+    if (viajes == NULL) {
+        perror("calloc");
+        exit(1);
+    }
+
+    FILE* f = fopen(salida, "w");
+    if (f == NULL) {
+        perror(salida);
+        return -1;
+    }
+    static char buffer[1 << 20];
+    setvbuf(f, buffer, _IOFBF, sizeof(buffer));
+
+    long escritos = 0;
+    int ocupacion[MAX_SUBTRAMOS] = {0};
+    int esperando[MAX_HOMBRILLOS] = {0};
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", f);
+    evento_json(f, &escritos, "{\"ph\":\"M\",\"pid\":%d,\"name\":\"process_name\",\"args\":{\"name\":\"Vehículos\"}}", PID_VEHICULOS);
+    evento_json(f, &escritos, "{\"ph\":\"M\",\"pid\":%d,\"name\":\"process_name\",\"args\":{\"name\":\"Autopista\"}}", PID_AUTOPISTA);
+
+    for (long k = 0; k < total; k++) {
+        const EventoTraza* ev = &eventos[k].ev;
+        if (ev->vehiculo < 0 || ev->lugar < 0 || ev->lugar >= MAX_SUBTRAMOS)
+            continue;
+        ViajeChrome* viaje = &viajes[ev->vehiculo];
+        int i = ev->lugar;
+
+        switch (ev->clase) {
+        case REG_INICIA:
+            viaje->inicio = ev->t;
+            viaje->entro = 0;
+            evento_json(f, &escritos, "{\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"name\":\"thread_name\","
+                        "\"args\":{\"name\":\"Vehículo %d (%s %s)\"}}", PID_VEHICULOS, ev->vehiculo, ev->vehiculo,
+                        ev->tipo == CAMION ? "camión" : "auto", ev->dir == DIR_1A4 ? "1→4" : "4→1");
+            break;
+        case REG_ENTRA:
+            if (!viaje->entro && ev->t > viaje->inicio)
+                evento_json(f, &escritos, "{\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%lld,\"dur\":%lld,"
+                            "\"name\":\"bloqueado en subtramos[%d].semaforo\",\"cat\":\"espera\"}",
+                            PID_VEHICULOS, ev->vehiculo, viaje->inicio, ev->t - viaje->inicio, i);
+            viaje->entro = 1;
+            evento_json(f, &escritos, "{\"ph\":\"C\",\"pid\":%d,\"ts\":%lld,\"name\":\"Subtramo %d\",\"args\":{\"vehiculos\":%d}}",
+                        PID_AUTOPISTA, ev->t, i + 1, ++ocupacion[i]);
+            break;
+        case REG_CIRCULA:
+            evento_json(f, &escritos, "{\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%lld,\"dur\":%lld,"
+                        "\"name\":\"circulando en subtramo %d\",\"cat\":\"subtramo\"}",
+                        PID_VEHICULOS, ev->vehiculo, ev->t, ev->valor, i + 1);
+            break;
+        case REG_SALE:
+            evento_json(f, &escritos, "{\"ph\":\"C\",\"pid\":%d,\"ts\":%lld,\"name\":\"Subtramo %d\",\"args\":{\"vehiculos\":%d}}",
+                        PID_AUTOPISTA, ev->t, i + 1, --ocupacion[i]);
+            break;
+        case REG_LLENO:
+            if (ev->valor >= 0 && ev->valor < MAX_HOMBRILLOS)
+                evento_json(f, &escritos, "{\"ph\":\"C\",\"pid\":%d,\"ts\":%lld,\"name\":\"Hombrillo %lld-%lld\","
+                            "\"args\":{\"esperando\":%d}}",
+                            PID_AUTOPISTA, ev->t, ev->valor + 1, ev->valor + 2, ++esperando[ev->valor]);
+            break;
+        case REG_ESPERO:
+            if (i >= MAX_HOMBRILLOS)
+                break;
+            // El hombrillo i está entre los subtramos i e i + 1
+            evento_json(f, &escritos, "{\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%lld,\"dur\":%lld,"
+                        "\"name\":\"esperando en hombrillo %d-%d\",\"cat\":\"espera\","
+                        "\"args\":{\"bloqueado en\":\"subtramos[%d].semaforo\"}}",
+                        PID_VEHICULOS, ev->vehiculo, ev->t - ev->valor, ev->valor, i + 1, i + 2,
+                        ev->dir == DIR_1A4 ? i + 1 : i);
+            evento_json(f, &escritos, "{\"ph\":\"C\",\"pid\":%d,\"ts\":%lld,\"name\":\"Hombrillo %d-%d\",\"args\":{\"esperando\":%d}}",
+                        PID_AUTOPISTA, ev->t, i + 1, i + 2, --esperando[i]);
+            break;
+        case REG_TERMINA:
+            evento_json(f, &escritos, "{\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%lld,\"dur\":%lld,"
+                        "\"name\":\"viaje\",\"cat\":\"viaje\"}",
+                        PID_VEHICULOS, ev->vehiculo, viaje->inicio, ev->t - viaje->inicio);
+            break;
+        }
+    }
+    fputs("\n]}\n", f);
+    int error = ferror(f);
+    if (fclose(f) != 0 || error) {
+        perror(salida);
+        return -1;
+    }
+
+    printf("🧭 %ld eventos de la traza → %ld eventos de Chrome en %s\n", total, escritos, salida);
+    free(viajes);
+    free(eventos);
+    return 0;
+}
+
+// Una pasada por todo el fichero. -1 si está corrupto
+static int recorrer(LectorTraza* l, const char* fichero, Resumen* r, int eventos, int vehiculo, double* segundos)
+{
+    static EventoTraza bloque[TRAZA_EVENTOS_POR_BLOQUE];
+
+    memset(r, 0, sizeof(*r));
+    rebobinar_lector_traza(l);
+    struct timespec inicio;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    int n;
+    while ((n = leer_bloque_traza(l, bloque)) > 0) {
+        acumular(r, bloque, n);
+        if (eventos)
+            escribir_eventos(bloque, n, vehiculo);
+    }
+    *segundos = segundos_desde(&inicio);
+    if (n < 0) {
+        fprintf(stderr, "%s: bloque %ld corrupto\n", fichero, r->bloques + 1);
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* fichero = NULL;
+    int eventos = 0;
+    int vehiculo = 0;
+    int repeticiones = 5;
+    const char* chrome = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--eventos") == 0) {
+            eventos = 1;
+        } else if (strncmp(argv[i], "--vehiculo=", 11) == 0) {
+            vehiculo = atoi(argv[i] + 11);
+            eventos = 1;
+        } else if (strncmp(argv[i], "--repeticiones=", 15) == 0) {
+            repeticiones = atoi(argv[i] + 15);
+        } else if (strncmp(argv[i], "--chrome=", 9) == 0) {
+            chrome = argv[i] + 9;
+        } else if (argv[i][0] != '-' && fichero == NULL) {
+            fichero = argv[i];
+        } else {
+            fichero = NULL;
+            break;
+        }
+    }
+    if (fichero == NULL) {
+        fprintf(stderr, "Uso: %s FICHERO [--eventos] [--vehiculo=ID] [--repeticiones=N] [--chrome=SALIDA]\n", argv[0]);
+        return 1;
+    }
+
+    LectorTraza l;
+    if (abrir_lector_traza(&l, fichero) < 0)
+        return 1;
+    if (chrome != NULL) {
+        int error = exportar_chrome(&l, fichero, chrome);
+        cerrar_lector_traza(&l);
+        return error < 0;
+    }
+    Resumen r;
+    double segundos;
+    if (recorrer(&l, fichero, &r, eventos, vehiculo, &segundos) < 0)
+        return 1;
+    if (eventos) {
+        cerrar_lector_traza(&l);
+        return 0;
+    }
+
+    // La primera pasada ya trajo el fichero a memoria
+    double mejor = segundos;
+    for (int rep = 1; rep < repeticiones; rep++) {
+        if (recorrer(&l, fichero, &r, 0, 0, &segundos) < 0)
+            return 1;
+        if (segundos < mejor)
+            mejor = segundos;
+    }
+    size_t bytes = l.tam;
+    cerrar_lector_traza(&l);
+
+    printf("🧾 TRAZA %s\n", fichero);
+    printf("📦 %ld bloques, %ld eventos, %zu bytes (%.2f bytes por evento)\n",
+           r.bloques, r.eventos, bytes, r.eventos ? (double)bytes / r.eventos : 0.0);
+    printf("⏰ Último evento: %.3f s del modelo\n", r.ultimo / 1e6);
+    printf("==========================================\n");
+    for (int c = 0; c < NUM_CLASES; c++)
+        printf("  %-8s %ld\n", nombresClase[c], r.porClase[c]);
+
+    printf("🛣️  Entradas por subtramo (1→4 / 4→1):\n");
+    for (int i = 0; i < MAX_SUBTRAMOS; i++)
+        if (r.entradas[i][0] || r.entradas[i][1])
+            printf("  Subtramo %d: %ld / %ld\n", i + 1, r.entradas[i][0], r.entradas[i][1]);
+
+    printf("🅿️  Esperas por hombrillo:\n");
+    for (int h = 0; h < MAX_HOMBRILLOS; h++)
+        if (r.esperas[h])
+            printf("  Hombrillo %d-%d: %ld esperas, media %.3f s, máxima %.3f s\n", h + 1, h + 2, r.esperas[h],
+                   r.esperaTotal[h] / 1e6 / r.esperas[h], r.esperaMax[h] / 1e6);
+
+    printf("⚡ Decodificación: %.2f ms, %.0f MB/s, %.1f millones de eventos/s\n",
+           mejor * 1e3, bytes / mejor / 1e6, r.eventos / mejor / 1e6);
+    return 0;
+}
@@ -0,0 +1,143 @@
+// Monitor de las estadísticas en vivo (vivo.h) de un simulador en marcha
+//
+// Compilar (desde "PROYECTO SO"):
+//   gcc -O2 -pthread -Isimulador simulador/*.c simulador/programas/monitor.c -o monitor -lm
+//
+// Uso:
+//   ./simulador_trafico --motor=hilos --acelerar=20 --vivo &
+//   ./monitor --pid=PID [--periodo=MS] [--veces=N]
+//   ./monitor --nombre=/NOMBRE ...
+//
+// Proyecta el segmento solo para leer y cada --periodo ms (500 por defecto)
+// copia la última foto con el seqlock y redibuja la pantalla, como top:
+// tiempo del modelo, vehículos en curso, ocupación de cada subtramo,
+// hombrillos y llegadas por hora. El simulador no se entera de que lo
+// miran. Termina cuando la simulación acaba o tras --veces pantallas.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+
+#include "trafico.h"
+#include "vivo.h"
+
+#define ANCHO_BARRA 40
+
+// El simulador crea el segmento cuando arranca el motor: se espera a que
+// aparezca y a que tenga la cabecera completa
+static const SegmentoVivo* abrir_segmento(const char* nombre)
+{
+    int fd = -1;
+    for (int intento = 0; intento < 100 && fd < 0; intento++) {
+        fd = shm_open(nombre, O_RDONLY, 0);
+        if (fd < 0)
+            usleep(100000);
+    }
+    if (fd < 0) {
+        perror(nombre);
+        exit(1);
+    }
+    const SegmentoVivo* s = mmap(NULL, sizeof(SegmentoVivo), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (s == MAP_FAILED) {
+        perror("mmap");
+        exit(1);
+    }
+    while (__atomic_load_n(&s->magia, __ATOMIC_ACQUIRE) != VIVO_MAGIA)
+        usleep(10000);
+    if (s->version != VIVO_VERSION) {
+        fprintf(stderr, "%s: versión %u del segmento, este monitor lee la %d\n", nombre, s->version, VIVO_VERSION);
+        exit(1);
+    }
+    return s;
+}
+
+static void barra(int valor, int maximo)
+{
+    int llenos = maximo > 0 ? valor * ANCHO_BARRA / maximo : 0;
+    if (llenos > ANCHO_BARRA)
+        llenos = ANCHO_BARRA;
+    putchar('[');
+    for (int k = 0; k < ANCHO_BARRA; k++)
+        putchar(k < llenos ? '#' : ' ');
+    putchar(']');
+}
+
+static void dibujar(const SegmentoVivo* s)
+{
+    const FotoVivo* f = &s->foto;
+    const Estadisticas* est = &f->est;
+    double progreso = f->duracion > 0 ? 100.0 * f->tiempoModelo / f->duracion : 0;
+
+    printf("\033[H\033[J");
+    printf("📡 Simulador %d (motor: %s)%s  foto %ld\n", s->pid, s->motor,
+           s->terminado ? "  — TERMINADO" : "", s->publicaciones);
+    printf("⏰ Tiempo del modelo: %.1f h de %.1f h (%.1f%%)\n",
+           (double)f->tiempoModelo / f->usegPorHora, (double)f->duracion / f->usegPorHora, progreso);
+    printf("🚗 Generados: %d  completados: %d  en curso: %d\n",
+           est->totalVehiculosDia, est->vehiculosCompletados, f->enCurso);
+
+    printf("\n🛣️  OCUPACIÓN (vehículos dentro / capacidad, total que circuló)\n");
+    for (int i = 0; i < f->numSubtramos; i++) {
+        printf("Subtramo %2d ", i + 1);
+        barra(f->ocupacion[i], f->capacidad[i]);
+        printf(" %d/%d  %d\n", f->ocupacion[i], f->capacidad[i],
+               est->estadisticasSubtramos[i][0] + est->estadisticasSubtramos[i][1]);
+    }
+
+    printf("\n🅿️  HOMBRILLOS (esperando ahora, máximo, espera máxima)\n");
+    for (int h = 0; h < f->numSubtramos - 1; h++) {
+        const EstadisticaHombrillo* eh = &est->hombrillos[h];
+        printf("Hombrillo %2d-%-2d %4d %4d %9.3f s\n", h + 1, h + 2, eh->vehiculosEsperando,
+               eh->maxEspera, (double)eh->tiempoMaxEspera / USEG_POR_SEGUNDO);
+    }
+
+    printf("\n📈 LLEGADAS POR HORA (1→4 + 4→1)\n");
+    tiempo_us t = f->tiempoModelo < f->duracion ? f->tiempoModelo : f->duracion - 1;
+    int horaActual = f->usegPorHora > 0 ? (int)(t / f->usegPorHora) : 0;
+    for (int hora = 0; hora <= horaActual && hora < 24; hora++)
+        printf("%2d: %4d + %4d%s", hora + 1, est->estadisticasHorarias[hora][0],
+               est->estadisticasHorarias[hora][1], hora % 4 == 3 ? "\n" : "   ");
+    printf("\n");
+    fflush(stdout);
+}
+
+int main(int argc, char* argv[])
+{
+    char nombre[64] = "";
+    int periodoMs = 500;
+    int veces = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--pid=", 6) == 0) {
+            snprintf(nombre, sizeof(nombre), "/simulador_vivo_%d", atoi(argv[i] + 6));
+        } else if (strncmp(argv[i], "--nombre=", 9) == 0) {
+            snprintf(nombre, sizeof(nombre), "%s", argv[i] + 9);
+        } else if (strncmp(argv[i], "--periodo=", 10) == 0) {
+            periodoMs = atoi(argv[i] + 10);
+        } else if (strncmp(argv[i], "--veces=", 8) == 0) {
+            veces = atoi(argv[i] + 8);
+        } else {
+            nombre[0] = '\0';
+            break;
+        }
+    }
+    if (nombre[0] == '\0' || periodoMs <= 0) {
+        fprintf(stderr, "Uso: %s --pid=PID|--nombre=NOMBRE [--periodo=MS] [--veces=N]\n", argv[0]);
+        return 1;
+    }
+
+    const SegmentoVivo* s = abrir_segmento(nombre);
+    SegmentoVivo copia;
+    for (int n = 1;; n++) {
+        leer_segmento_vivo(s, &copia);
+        dibujar(&copia);
+        if (copia.terminado || n == veces)
+            break;
+        usleep((useconds_t)periodoMs * 1000);
+    }
+    munmap((void*)s, sizeof(SegmentoVivo));
+    return 0;
+}
@@ -0,0 +1,228 @@
+// Réplicas de Monte Carlo: R días independientes en paralelo
+//
+// Compilar (desde "PROYECTO SO"):
+//   gcc -O2 -pthread -Isimulador simulador/*.c simulador/programas/replicas.c -o replicas -lm
+//
+// Uso:
+//   ./replicas [--replicas=R] [--semilla=N] [--hilos=N]
+//              [--escenario=FICHERO] [--CLAVE=VALOR del escenario]
+//
+// Cada réplica es un día completo con el motor de eventos discretos y su
+// propia semilla, derivada de --semilla y del número de réplica; la tabla
+// de semillas se imprime para poder repetir cualquier día con
+// ./simulador_trafico --motor=des --semilla=S (con las mismas opciones de
+// escenario). Los hilos (uno por núcleo por defecto) toman réplicas de un
+// contador común y cada réplica escribe solo en su propia ranura de
+// resultados, así que no comparten nada más.
+//
+// Se muestran media, desviación típica e intervalo de confianza al 95% de
+// las llegadas por hora, los vehículos por subtramo y las métricas de los
+// hombrillos.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "trafico.h"
+#include "escenario.h"
+#include "metricas.h"
+#include "motor_des.h"
+#include "estadistica.h"
+
+typedef struct {
+    int numReplicas;
+    unsigned int* semillas;
+    Estadisticas* resultados;
+    int siguiente;  // Próxima réplica sin empezar
+} Replicas;
+
+static Replicas rep;
+
+// Semillas bien separadas aunque --semilla cambie en una unidad
+// (finalizador de SplitMix32)
+static unsigned int semilla_replica(unsigned int base, int r)
+{
+    unsigned int x = base + (unsigned int)r * 0x9E3779B9u;
+    x ^= x >> 16;
+    x *= 0x85EBCA6Bu;
+    x ^= x >> 13;
+    x *= 0xC2B2AE35u;
+    x ^= x >> 16;
+    return x;
+}
+
+static void* trabajador(void* arg)
+{
+    (void)arg;
+    for (;;) {
+        int r = __atomic_fetch_add(&rep.siguiente, 1, __ATOMIC_RELAXED);
+        if (r >= rep.numReplicas)
+            break;
+        ejecutar_motor_des(rep.semillas[r], &rep.resultados[r]);
+    }
+    return NULL;
+}
+
+static double segundos_desde(const struct timespec* inicio)
+{
+    struct timespec ahora;
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    return (ahora.tv_sec - inicio->tv_sec) + (ahora.tv_nsec - inicio->tv_nsec) / 1e9;
+}
+
+// "media ± semiancho (sd)"
+static void mostrar_acumulador(const Acumulador* a, double escala)
+{
+    printf("%10.3f ± %8.3f (sd %8.3f)", a->media / escala, semiancho_ic95(a) / escala, desviacion(a) / escala);
+}
+
+static void mostrar_resumen()
+{
+    int n = rep.numReplicas;
+
+    printf("\n📈 LLEGADAS POR HORA (media ± IC 95%%):\n");
+    printf("Hora |          Dirección 1→4           |          Dirección 4→1\n");
+    printf("-----|----------------------------------|----------------------------------\n");
+    for (int hora = 0; hora < 24; hora++) {
+        printf("%2d   | ", hora + 1);
+        for (int d = 0; d < 2; d++) {
+            Acumulador a;
+            iniciar_acumulador(&a);
+            for (int r = 0; r < n; r++)
+                acumular(&a, rep.resultados[r].estadisticasHorarias[hora][d]);
+            mostrar_acumulador(&a, 1);
+            printf(d == 0 ? " | " : "\n");
+        }
+    }
+
+    printf("\n🛣️  VEHÍCULOS POR SUBTRAMO (media ± IC 95%%):\n");
+    for (int i = 0; i < NUM_SUBTRAMOS; i++) {
+        for (int d = 0; d < 2; d++) {
+            Acumulador a;
+            iniciar_acumulador(&a);
+            for (int r = 0; r < n; r++)
+                acumular(&a, rep.resultados[r].estadisticasSubtramos[i][d]);
+            printf("Subtramo %d %s: ", i + 1, d == DIR_1A4 ? "1→4" : "4→1");
+            mostrar_acumulador(&a, 1);
+            printf("\n");
+        }
+    }
+
+    printf("\n🅿️  HOMBRILLOS (media ± IC 95%%):\n");
+    for (int i = 0; i < NUM_HOMBRILLOS; i++) {
+        Acumulador maxEspera, tiempoMax, promedio, esperaron;
+        iniciar_acumulador(&maxEspera);
+        iniciar_acumulador(&tiempoMax);
+        iniciar_acumulador(&promedio);
+        iniciar_acumulador(&esperaron);
+        for (int r = 0; r < n; r++) {
+            const EstadisticaHombrillo* h = &rep.resultados[r].hombrillos[i];
+            acumular(&maxEspera, h->maxEspera);
+            acumular(&tiempoMax, (double)h->tiempoMaxEspera);
+            acumular(&esperaron, h->totalVehiculosEsperado);
+            if (h->totalVehiculosEsperado > 0)
+                acumular(&promedio, (double)h->tiempoTotalEspera / h->totalVehiculosEsperado);
+        }
+        printf("Hombrillo %d-%d:\n", i + 1, i + 2);
+        printf("  Máximo vehículos esperando:    ");
+        mostrar_acumulador(&maxEspera, 1);
+        printf("\n  Tiempo máximo de espera (s):   ");
+        mostrar_acumulador(&tiempoMax, USEG_POR_SEGUNDO);
+        printf("\n  Tiempo promedio de espera (s): ");
+        mostrar_acumulador(&promedio, USEG_POR_SEGUNDO);
+        printf("\n  Vehículos que esperaron:       ");
+        mostrar_acumulador(&esperaron, 1);
+        printf("\n");
+    }
+
+    Acumulador total, completados;
+    iniciar_acumulador(&total);
+    iniciar_acumulador(&completados);
+    for (int r = 0; r < n; r++) {
+        acumular(&total, rep.resultados[r].totalVehiculosDia);
+        acumular(&completados, rep.resultados[r].vehiculosCompletados);
+    }
+    printf("\n📦 Vehículos en el día:        ");
+    mostrar_acumulador(&total, 1);
+    printf("\n🏁 Completaron el recorrido:   ");
+    mostrar_acumulador(&completados, 1);
+    printf("\n");
+}
+
+int main(int argc, char* argv[])
+{
+    int numReplicas = 30;
+    unsigned int semilla = (unsigned int)time(NULL);
+    int numHilos = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (leer_argumentos_escenario(argc, argv) < 0)
+        return 1;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--replicas=", 11) == 0) {
+            numReplicas = atoi(argv[i] + 11);
+        } else if (strncmp(argv[i], "--semilla=", 10) == 0) {
+            semilla = (unsigned int)strtoul(argv[i] + 10, NULL, 10);
+        } else if (strncmp(argv[i], "--hilos=", 8) == 0) {
+            numHilos = atoi(argv[i] + 8);
+        } else if (es_opcion_escenario(argv[i])) {
+            // Ya leída por leer_argumentos_escenario()
+        } else {
+            fprintf(stderr, "Uso: %s [--replicas=R] [--semilla=N] [--hilos=N]\n"
+                            "          [--escenario=FICHERO] [--CLAVE=VALOR del escenario]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (numReplicas < 1)
+        numReplicas = 1;
+    if (numHilos < 1)
+        numHilos = 1;
+    if (numHilos > numReplicas)
+        numHilos = numReplicas;
+
+    rep.numReplicas = numReplicas;
+    rep.semillas = malloc(numReplicas * sizeof(unsigned int));
+    rep.resultados = malloc(numReplicas * sizeof(Estadisticas));
+    pthread_t* hilos = malloc(numHilos * sizeof(pthread_t));
+    if (rep.semillas == NULL || rep.resultados == NULL || hilos == NULL) {
+        perror("malloc");
+        exit(1);
+    }
+    for (int r = 0; r < numReplicas; r++)
+        rep.semillas[r] = semilla_replica(semilla, r);
+
+    printf("🎲 RÉPLICAS DE MONTE CARLO (motor: des)\n");
+    printf("🔁 Réplicas: %d  🎲 Semilla base: %u  🧵 Hilos: %d\n", numReplicas, semilla, numHilos);
+    mostrar_autopista();
+    mostrar_escenario();
+    printf("==========================================\n");
+
+    MetricasEjecucion metricas;
+    iniciar_metricas(&metricas);
+    struct timespec inicio;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+
+    for (int k = 0; k < numHilos; k++)
+        crear_hilo(&hilos[k], trabajador, NULL);
+    for (int k = 0; k < numHilos; k++)
+        pthread_join(hilos[k], NULL);
+
+    double segundos = segundos_desde(&inicio);
+    terminar_metricas(&metricas);
+
+    printf("Réplica |    Semilla | Vehículos | Completados\n");
+    printf("--------|------------|-----------|------------\n");
+    for (int r = 0; r < numReplicas; r++)
+        printf("%7d | %10u | %9d | %11d\n", r + 1, rep.semillas[r],
+               rep.resultados[r].totalVehiculosDia, rep.resultados[r].vehiculosCompletados);
+
+    mostrar_resumen();
+    mostrar_metricas(&metricas);
+    printf("  Réplicas por segundo: %.1f\n", numReplicas / segundos);
+
+    free(hilos);
+    free(rep.semillas);
+    free(rep.resultados);
+    printf("🎯 RÉPLICAS COMPLETADAS\n");
+    return 0;
+}
@@ -0,0 +1,234 @@
+// Simulador de la autopista con motor seleccionable
+//
+// Compilar (desde "PROYECTO SO"):
+//   gcc -O2 -pthread -Isimulador simulador/*.c simulador/programas/simulador.c -o simulador_trafico -lm
+//
+// Uso:
+//   ./simulador_trafico [--motor=des|hilos|procesos|pool|fibras|actores|timewarp|cmb] [--semilla=N]
+//                       [--acelerar=N] [--hilos=N] [--procesos=N] [--pila=BYTES] [--rafaga=N]
+//                       [--log=NIVEL] [--traza=FICHERO] [--muestreo=N]
+//                       [--vivo[=NOMBRE]] [--periodo-vivo=MS] [--giro=VUELTAS]
+//                       [--escenario=FICHERO] [--CLAVE=VALOR del escenario]
+//
+//   des    eventos discretos con reloj virtual (un día en milisegundos)
+//   hilos  un pthread por vehículo, como Problema2Gamma2-1.c (--acelerar
+//          divide los usleep para no esperar los 12 minutos del día); en
+//          las entradas a los subtramos se gira hasta --giro vueltas antes
+//          de dormir (espera_giro.h, 0 = dormir enseguida)
+//   procesos lo mismo con los vehículos repartidos en --procesos procesos
+//          que comparten el estado por memoria compartida (shm_open)
+//   pool   --hilos hilos fijos (por defecto uno por núcleo) que mueven los
+//          vehículos como máquinas de estado
+//   fibras una fibra con --pila bytes de pila por vehículo (16 KB con
+//          página de guarda por defecto), repartidas en --hilos hilos;
+//          --rafaga=N lanza N vehículos a la vez en t=0 (prueba de
+//          vehículos simultáneos, p.ej. --rafaga=1000000 --pila=2048, sin
+//          guarda: la llevan solo las pilas de una página o más)
+//   actores un hilo por subtramo y por hombrillo, dueño de sus contadores;
+//          los vehículos pasan como mensajes por buzones sin bloqueo
+//   timewarp simulación optimista en paralelo: un proceso lógico por
+//          subtramo y por hombrillo en --hilos hilos; con cualquier número
+//          de hilos da el mismo resultado que des para la misma semilla
+//   cmb    simulación conservadora en --procesos procesos (subtramos
+//          contiguos) con mensajes nulos; mismo resultado que des
+//
+// --escenario carga los parámetros del modelo de un fichero y cada uno se
+// puede cambiar también suelto (escenario.h); p.ej. --subtramos cambia la
+// autopista con una lista de CAPACIDAD[/PESO_AUTO/PESO_CAMION][*REPETICIONES]:
+// "4,2/1/2,1,3" (la de Gamma2-1, por defecto) o "4*10,2/1/2*20,3*10" para
+// un corredor de 40 subtramos, y --politica elige a quién se deja pasar
+// cuando un subtramo tiene cola (politica.h: cabe, fifo o camiones). Las
+// políticas distintas de cabe las aplican los motores con colas de espera:
+// des, pool, actores, timewarp y cmb
+//
+// --log=info (inicio, hombrillos y final de cada vehículo) o
+// --log=depuracion (además cada subtramo) escribe lo que hace cada vehículo
+// desde un hilo aparte (registro.h); por defecto no se escribe nada. Todos
+// los motores salvo timewarp y cmb lo escriben. --traza guarda todos los
+// eventos en un fichero binario compacto (traza.h) que se lee con
+// leer_traza, y --muestreo=N se queda solo con 1 de cada N vehículos
+//
+// --vivo publica las estadísticas mientras corre en un segmento de memoria
+// compartida (vivo.h, por defecto /simulador_vivo_PID) cada --periodo-vivo
+// ms; se miran con monitor --pid=PID. Lo hacen los motores con reloj real
+//
+// Al final se muestran las métricas del proceso (hilos creados, memoria
+// residente máxima, cambios de contexto) para comparar los motores.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "trafico.h"
+#include "escenario.h"
+#include "metricas.h"
+#include "motor_des.h"
+#include "motor_hilos.h"
+#include "motor_pool.h"
+#include "motor_fibras.h"
+#include "motor_actores.h"
+#include "motor_timewarp.h"
+#include "motor_cmb.h"
+#include "fibras.h"
+#include "registro.h"
+#include "vivo.h"
+#include "espera_giro.h"
+#include "politica.h"
+
+int main(int argc, char* argv[])
+{
+    const char* motor = "des";
+    unsigned int semilla = (unsigned int)time(NULL);
+    int aceleracion = 1;
+    int numHilos = 0;
+    int numProcesos = 0;
+    OpcionesRegistro opRegistro = { NIVEL_NADA, ANILLO_LLENO_PIERDE, NULL, NULL, 1 };
+    OpcionesFibras opFibras = { 0, PILA_FIBRA_POR_DEFECTO, 0 };
+    EstadisticasTimeWarp estTW;
+    EstadisticasCMB estCMB;
+    EsperasHilos esperas;
+    char nombreVivo[64];
+    const char* vivo = NULL;
+    int periodoVivo = VIVO_PERIODO_MS;
+
+    if (leer_argumentos_escenario(argc, argv) < 0)
+        return 1;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--motor=", 8) == 0) {
+            motor = argv[i] + 8;
+        } else if (strncmp(argv[i], "--semilla=", 10) == 0) {
+            semilla = (unsigned int)strtoul(argv[i] + 10, NULL, 10);
+        } else if (strncmp(argv[i], "--acelerar=", 11) == 0) {
+            aceleracion = atoi(argv[i] + 11);
+        } else if (strncmp(argv[i], "--hilos=", 8) == 0) {
+            numHilos = atoi(argv[i] + 8);
+        } else if (strncmp(argv[i], "--procesos=", 11) == 0) {
+            numProcesos = atoi(argv[i] + 11);
+        } else if (strncmp(argv[i], "--pila=", 7) == 0) {
+            opFibras.tamPila = (size_t)atol(argv[i] + 7);
+        } else if (strncmp(argv[i], "--rafaga=", 9) == 0) {
+            opFibras.rafaga = atoi(argv[i] + 9);
+        } else if (strncmp(argv[i], "--log=", 6) == 0) {
+            int nivel = leer_nivel_registro(argv[i] + 6);
+            if (nivel < 0) {
+                fprintf(stderr, "Nivel de registro no válido: %s (nada, error, aviso, info o depuracion)\n", argv[i] + 6);
+                return 1;
+            }
+            opRegistro.nivel = nivel;
+        } else if (strncmp(argv[i], "--traza=", 8) == 0) {
+            opRegistro.traza = argv[i] + 8;
+        } else if (strncmp(argv[i], "--muestreo=", 11) == 0) {
+            opRegistro.muestreo = atoi(argv[i] + 11);
+        } else if (strcmp(argv[i], "--vivo") == 0) {
+            snprintf(nombreVivo, sizeof(nombreVivo), "/simulador_vivo_%d", (int)getpid());
+            vivo = nombreVivo;
+        } else if (strncmp(argv[i], "--vivo=", 7) == 0) {
+            vivo = argv[i] + 7;
+        } else if (strncmp(argv[i], "--periodo-vivo=", 15) == 0) {
+            periodoVivo = atoi(argv[i] + 15);
+        } else if (strncmp(argv[i], "--giro=", 7) == 0) {
+            configurar_giro(atoi(argv[i] + 7));
+        } else if (es_opcion_escenario(argv[i])) {
+            // Ya leída por leer_argumentos_escenario()
+        } else {
+            fprintf(stderr, "Uso: %s [--motor=des|hilos|procesos|pool|fibras|actores|timewarp|cmb] [--semilla=N]\n"
+                            "          [--acelerar=N] [--hilos=N] [--procesos=N] [--pila=BYTES] [--rafaga=N]\n"
+                            "          [--log=NIVEL] [--traza=FICHERO] [--muestreo=N]\n"
+                            "          [--vivo[=NOMBRE]] [--periodo-vivo=MS] [--giro=VUELTAS]\n"
+                            "          [--escenario=FICHERO] [--CLAVE=VALOR del escenario]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // hilos, procesos y fibras esperan en semáforos y variables de
+    // condición: no hay una cola que la política pueda recorrer
+    if (!es_politica_por_defecto() && (strcmp(motor, "hilos") == 0 || strcmp(motor, "procesos") == 0
+                                       || strcmp(motor, "fibras") == 0)) {
+        fprintf(stderr, "El motor %s no aplica la política %s (sí des, pool, actores, timewarp y cmb)\n",
+                motor, politicaAdmision->nombre);
+        return 1;
+    }
+
+    printf("🚦 INICIANDO SIMULACIÓN DE TRÁFICO (motor: %s)\n", motor);
+    printf("⏰ Duración simulada: %d horas\n", HORAS_SIMULACION);
+    printf("🚗 Vehículos por hora: %d\n", VEHICULOS_POR_HORA);
+    printf("🎲 Semilla: %u\n", semilla);
+    mostrar_autopista();
+    mostrar_escenario();
+    if (vivo != NULL)
+        printf("📡 Estadísticas en vivo en %s (monitor --pid=%d)\n", vivo, (int)getpid());
+    printf("==========================================\n");
+
+    Estadisticas est;
+    MetricasEjecucion metricas;
+    iniciar_metricas(&metricas);
+    // Con el reloj virtual el registro puede frenar al motor sin cambiar nada
+    opRegistro.salida = stdout;
+    if (strcmp(motor, "des") == 0)
+        opRegistro.politica = ANILLO_LLENO_ESPERA;
+    if (iniciar_registro(&opRegistro) < 0)
+        return 1;
+    configurar_vivo(vivo, motor, periodoVivo);
+
+    if (strcmp(motor, "des") == 0) {
+        ejecutar_motor_des(semilla, &est);
+    } else if (strcmp(motor, "hilos") == 0) {
+        ejecutar_motor_hilos(semilla, aceleracion, &est, &esperas);
+    } else if (strcmp(motor, "procesos") == 0) {
+        ejecutar_motor_procesos(semilla, aceleracion, numProcesos, &est, &esperas);
+    } else if (strcmp(motor, "pool") == 0) {
+        ejecutar_motor_pool(semilla, aceleracion, numHilos, &est);
+    } else if (strcmp(motor, "fibras") == 0) {
+        opFibras.numHilos = numHilos;
+        ejecutar_motor_fibras(semilla, aceleracion, &opFibras, &est);
+    } else if (strcmp(motor, "actores") == 0) {
+        ejecutar_motor_actores(semilla, aceleracion, &est);
+    } else if (strcmp(motor, "timewarp") == 0) {
+        ejecutar_motor_timewarp(semilla, numHilos, &est, &estTW);
+    } else if (strcmp(motor, "cmb") == 0) {
+        ejecutar_motor_cmb(semilla, numProcesos, &est, &estCMB);
+    } else {
+        fprintf(stderr, "Motor desconocido: %s\n", motor);
+        return 1;
+    }
+
+    terminar_registro();
+    terminar_metricas(&metricas);
+    mostrar_estadisticas(&est);
+    mostrar_metricas(&metricas);
+    if (strcmp(motor, "fibras") == 0) {
+        printf("  Fibras creadas: %ld (%zu bytes por vehículo entre descriptor, datos, pila y guarda si la lleva)\n",
+               fibras_creadas(), memoria_por_vehiculo_fibra());
+        if (opFibras.rafaga > 0)
+            printf("  Memoria residente por vehículo simultáneo: %.2f KB\n",
+                   (double)metricas.maxRssKB / opFibras.rafaga);
+    }
+
+    if (strcmp(motor, "hilos") == 0 || strcmp(motor, "procesos") == 0) {
+        printf("  Esperas en las entradas a los subtramos:\n");
+        for (int i = 0; i < NUM_SUBTRAMOS; i++) {
+            char sitio[48];
+            if (autopista.conPeso[i]) {
+                snprintf(sitio, sizeof(sitio), "Subtramo %d (autos)", i + 1);
+                mostrar_giro(sitio, &esperas.autos[i]);
+                snprintf(sitio, sizeof(sitio), "Subtramo %d (camiones)", i + 1);
+                mostrar_giro(sitio, &esperas.camiones[i]);
+            } else {
+                snprintf(sitio, sizeof(sitio), "Subtramo %d", i + 1);
+                mostrar_giro(sitio, &esperas.semaforo[i]);
+            }
+        }
+    }
+    if (strcmp(motor, "timewarp") == 0) {
+        printf("  Procesos lógicos en %d hilos: %ld eventos procesados, %ld deshechos en %ld retrocesos, %ld rondas de GVT\n",
+               estTW.hilos, estTW.eventosProcesados, estTW.eventosDeshechos, estTW.retrocesos, estTW.rondasGVT);
+    }
+    if (strcmp(motor, "cmb") == 0) {
+        printf("  %d procesos: %ld eventos, %ld vehículos entre procesos, %ld mensajes nulos\n",
+               estCMB.procesos, estCMB.eventos, estCMB.mensajesVehiculo, estCMB.mensajesNulos);
+    }
+
+    printf("🎯 SIMULACIÓN COMPLETADA EXITOSAMENTE\n");
+    return 0;
+}
@@ -0,0 +1,363 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <pthread.h>
+#include <time.h>
+#include <sched.h>
+
+#include "registro.h"
+#include "traza.h"
+
+static const char* nombresNivel[] = { "nada", "error", "aviso", "info", "depuracion" };
+
+int leer_nivel_registro(const char* texto)
+{
+    for (int n = NIVEL_NADA; n <= NIVEL_DEPURACION; n++)
+        if (strcasecmp(texto, nombresNivel[n]) == 0)
+            return n;
+    char* fin;
+    long n = strtol(texto, &fin, 10);
+    if (fin == texto || *fin != '\0' || n < NIVEL_NADA || n > NIVEL_DEPURACION)
+        return -1;
+    return (int)n;
+}
+
+#ifndef SIN_REGISTRO
+
+#define TAM_ANILLO 1024       // Registros por hilo; potencia de 2
+#define PAUSA_ESCRITOR_NS 1000000
+
+// Lo que se guarda de cada mensaje; el texto se arma en el hilo escritor
+typedef struct {
+    long long ns;             // CLOCK_MONOTONIC, para ordenar
+    long long valor;
+    tiempo_us t;              // Tiempo del modelo
+    int tipo;
+    int id;
+    int vehiculoTipo;
+    int dir;
+    int lugar;
+    unsigned int anillo;      // Para desempatar
+} RegistroBinario;
+
+typedef enum { ANILLO_EN_USO, ANILLO_ABANDONADO, ANILLO_LIBRE } EstadoAnillo;
+
+// Un productor (el hilo dueño) y un consumidor (el escritor). Cuando el hilo
+// termina, el escritor vacía el anillo y lo deja libre para otro hilo: los
+// anillos no se liberan nunca, así que un hilo que sale tarde no toca
+// memoria ya devuelta
+typedef struct Anillo {
+    RegistroBinario registros[TAM_ANILLO];
+    unsigned long escrito __attribute__((aligned(64)));
+    unsigned long leido __attribute__((aligned(64)));
+    int estado;
+    unsigned int numero;
+    struct Anillo* sig;
+} Anillo;
+
+int nivelRegistro = NIVEL_NADA;
+
+static struct {
+    Anillo* anillos;          // Lista en la que solo se inserta, con CAS
+    unsigned int numAnillos;
+    long perdidos;
+    OpcionesRegistro op;
+    int hayTraza;
+    pthread_t escritor;
+    int parar;
+    int enMarcha;
+    pthread_mutex_t mutexTanda;   // Lo tiene el escritor mientras escribe una tanda
+    RegistroBinario* lote;    // Del escritor
+    size_t capLote;
+} reg = { .mutexTanda = PTHREAD_MUTEX_INITIALIZER };
+
+static EscritorTraza traza;    // Del escritor
+
+static const int nivelDeTipo[] = {
+    NIVEL_REG_INICIA, NIVEL_REG_ENTRA, NIVEL_REG_CIRCULA, NIVEL_REG_SALE,
+    NIVEL_REG_LLENO, NIVEL_REG_ESPERO, NIVEL_REG_TERMINA,
+};
+
+static __thread Anillo* anilloPropio;
+static pthread_key_t claveAnillo;
+static pthread_once_t claveCreada = PTHREAD_ONCE_INIT;
+static pthread_once_t forkPreparado = PTHREAD_ONCE_INIT;
+
+static void abandonar_anillo(void* p)
+{
+    Anillo* a = p;
+    __atomic_store_n(&a->estado, ANILLO_ABANDONADO, __ATOMIC_RELEASE);
+}
+
+static void crear_clave()
+{
+    pthread_key_create(&claveAnillo, abandonar_anillo);
+}
+
+// Un anillo libre de un hilo que ya terminó o uno nuevo
+static Anillo* tomar_anillo()
+{
+    pthread_once(&claveCreada, crear_clave);
+
+    Anillo* a;
+    for (a = __atomic_load_n(&reg.anillos, __ATOMIC_ACQUIRE); a != NULL; a = a->sig) {
+        int libre = ANILLO_LIBRE;
+        if (__atomic_load_n(&a->estado, __ATOMIC_RELAXED) == ANILLO_LIBRE &&
+            __atomic_compare_exchange_n(&a->estado, &libre, ANILLO_EN_USO, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+            break;
+    }
+
+    if (a == NULL) {
+        a = aligned_alloc(64, sizeof(Anillo));
+        if (a == NULL) {
+            perror("aligned_alloc");
+            exit(1);
+        }
+        a->escrito = a->leido = 0;
+        a->estado = ANILLO_EN_USO;
+        a->numero = __atomic_fetch_add(&reg.numAnillos, 1, __ATOMIC_RELAXED);
+        a->sig = __atomic_load_n(&reg.anillos, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&reg.anillos, &a->sig, a, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+            ;
+    }
+
+    pthread_setspecific(claveAnillo, a);
+    return a;
+}
+
+void preparar_registro_hilo()
+{
+    if (__atomic_load_n(&nivelRegistro, __ATOMIC_RELAXED) > NIVEL_NADA && anilloPropio == NULL)
+        anilloPropio = tomar_anillo();
+}
+
+void registrar_evento(TipoRegistro tipo, const Vehiculo* v, tiempo_us t, int lugar, long long valor)
+{
+    if (reg.op.muestreo > 1 && (v->id - 1) % reg.op.muestreo != 0)
+        return;
+
+    Anillo* a = anilloPropio;
+    if (a == NULL)
+        a = anilloPropio = tomar_anillo();
+
+    unsigned long e = a->escrito;
+    while (e - __atomic_load_n(&a->leido, __ATOMIC_ACQUIRE) == TAM_ANILLO) {
+        if (reg.op.politica == ANILLO_LLENO_PIERDE) {
+            __atomic_fetch_add(&reg.perdidos, 1, __ATOMIC_RELAXED);
+            return;
+        }
+        sched_yield();
+    }
+
+    struct timespec ahora;
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    RegistroBinario* r = &a->registros[e & (TAM_ANILLO - 1)];
+    r->ns = ahora.tv_sec * 1000000000LL + ahora.tv_nsec;
+    r->valor = valor;
+    r->t = t;
+    r->tipo = tipo;
+    r->id = v->id;
+    r->vehiculoTipo = v->tipo;
+    r->dir = v->dir;
+    r->lugar = lugar;
+    r->anillo = a->numero;
+    __atomic_store_n(&a->escrito, e + 1, __ATOMIC_RELEASE);
+}
+
+static int comparar_registros(const void* x, const void* y)
+{
+    const RegistroBinario* a = x;
+    const RegistroBinario* b = y;
+    if (a->ns != b->ns)
+        return a->ns < b->ns ? -1 : 1;
+    return (a->anillo > b->anillo) - (a->anillo < b->anillo);
+}
+
+// Mismos mensajes que los printf de Problema2Gamma2-1.c
+static void escribir_registro(FILE* f, const RegistroBinario* r)
+{
+    fprintf(f, "[%10.3f s] ", r->t / 1e6);
+    switch (r->tipo) {
+    case REG_INICIA:
+        fprintf(f, "🚗 Vehículo %d (%s) INICIANDO viaje dirección %s\n", r->id,
+                r->vehiculoTipo == CAMION ? "camión" : "auto", r->dir == DIR_1A4 ? "1→4" : "4→1");
+        break;
+    case REG_ENTRA:
+        fprintf(f, "🛣️  Vehículo %d ENTRÓ al subtramo %d\n", r->id, r->lugar + 1);
+        break;
+    case REG_CIRCULA:
+        fprintf(f, "⏱️  Vehículo %d CIRCULANDO en subtramo %d (%.3f s)\n", r->id, r->lugar + 1, r->valor / 1e6);
+        break;
+    case REG_SALE:
+        fprintf(f, "↪️  Vehículo %d SALIÓ del subtramo %d\n", r->id, r->lugar + 1);
+        break;
+    case REG_LLENO:
+        fprintf(f, "🅿️  Vehículo %d → Subtramo %d LLENO, YENDO al hombrillo %lld-%lld\n",
+                r->id, r->lugar + 1, r->valor + 1, r->valor + 2);
+        break;
+    case REG_ESPERO:
+        fprintf(f, "⏳ Vehículo %d ESPERÓ %.3f s en hombrillo %d-%d\n", r->id, r->valor / 1e6, r->lugar + 1, r->lugar + 2);
+        break;
+    case REG_TERMINA:
+        fprintf(f, "🏁 Vehículo %d terminó su recorrido\n", r->id);
+        break;
+    }
+}
+
+// Vacía todos los anillos en una tanda ordenada por instante real.
+// Devuelve cuántos registros escribió
+static size_t vaciar_anillos()
+{
+    size_t n = 0;
+    for (Anillo* a = __atomic_load_n(&reg.anillos, __ATOMIC_ACQUIRE); a != NULL; a = a->sig) {
+        int estado = __atomic_load_n(&a->estado, __ATOMIC_ACQUIRE);
+        unsigned long l = a->leido;
+        unsigned long e = __atomic_load_n(&a->escrito, __ATOMIC_ACQUIRE);
+        if (n + (e - l) > reg.capLote) {
+            reg.capLote = (n + (e - l)) * 2;
+            reg.lote = realloc(reg.lote, reg.capLote * sizeof(RegistroBinario));
+            if (reg.lote == NULL) {
+                perror("realloc");
+                exit(1);
+            }
+        }
+        for (; l != e; l++)
+            reg.lote[n++] = a->registros[l & (TAM_ANILLO - 1)];
+        __atomic_store_n(&a->leido, e, __ATOMIC_RELEASE);
+
+        // Abandonado antes de leer escrito: ya no queda nada por llegar
+        if (estado == ANILLO_ABANDONADO)
+            __atomic_store_n(&a->estado, ANILLO_LIBRE, __ATOMIC_RELEASE);
+    }
+
+    qsort(reg.lote, n, sizeof(RegistroBinario), comparar_registros);
+    for (size_t k = 0; k < n; k++) {
+        const RegistroBinario* r = &reg.lote[k];
+        if (nivelDeTipo[r->tipo] <= (int)reg.op.nivel)
+            escribir_registro(reg.op.salida, r);
+        if (reg.hayTraza) {
+            EventoTraza ev = {
+                .t = r->t, .vehiculo = r->id, .lugar = r->lugar, .valor = r->valor,
+                .clase = (unsigned char)r->tipo, .tipo = (unsigned char)r->vehiculoTipo, .dir = (unsigned char)r->dir,
+            };
+            anotar_evento_traza(&traza, &ev);
+        }
+    }
+    return n;
+}
+
+static void* hilo_escritor(void* arg)
+{
+    (void)arg;
+    while (!__atomic_load_n(&reg.parar, __ATOMIC_ACQUIRE)) {
+        pthread_mutex_lock(&reg.mutexTanda);
+        size_t n = vaciar_anillos();
+        pthread_mutex_unlock(&reg.mutexTanda);
+        if (n == 0) {
+            struct timespec pausa = { 0, PAUSA_ESCRITOR_NS };
+            nanosleep(&pausa, NULL);
+        }
+    }
+    pthread_mutex_lock(&reg.mutexTanda);
+    vaciar_anillos();
+    if (reg.op.salida != NULL)
+        fflush(reg.op.salida);
+    if (reg.hayTraza)
+        vaciar_escritor_traza(&traza);
+    pthread_mutex_unlock(&reg.mutexTanda);
+    return NULL;
+}
+
+static void arrancar_escritor()
+{
+    reg.parar = 0;
+    reg.enMarcha = 1;
+    pthread_create(&reg.escritor, NULL, hilo_escritor, NULL);
+}
+
+// fork() solo copia el hilo que lo llama. Se hace con el escritor fuera de
+// una tanda y la salida vacía (para que el hijo no repita lo del padre), y
+// el hijo arranca su propio escritor para sus vehículos. Los cerrojos de
+// los FILE los deja libres glibc en el hijo
+static void antes_de_fork()
+{
+    pthread_mutex_lock(&reg.mutexTanda);
+    if (reg.op.salida != NULL)
+        fflush(reg.op.salida);
+}
+
+static void despues_de_fork_padre()
+{
+    pthread_mutex_unlock(&reg.mutexTanda);
+}
+
+static void despues_de_fork_hijo()
+{
+    pthread_mutex_unlock(&reg.mutexTanda);
+    if (!reg.enMarcha)
+        return;
+
+    // Lo pendiente ya lo escribe el padre, y los dueños de los demás
+    // anillos no existen en el hijo
+    for (Anillo* a = reg.anillos; a != NULL; a = a->sig) {
+        a->leido = a->escrito;
+        if (a != anilloPropio)
+            a->estado = ANILLO_LIBRE;
+    }
+    reg.perdidos = 0;
+    reg.lote = NULL;
+    reg.capLote = 0;
+    if (reg.hayTraza)
+        descartar_escritor_traza(&traza);   // Su bloque a medias lo escribe el padre
+    arrancar_escritor();
+}
+
+static void preparar_fork()
+{
+    pthread_atfork(antes_de_fork, despues_de_fork_padre, despues_de_fork_hijo);
+}
+
+int iniciar_registro(const OpcionesRegistro* op)
+{
+    pthread_once(&forkPreparado, preparar_fork);
+    reg.op = *op;
+    if (reg.op.salida == NULL)
+        reg.op.nivel = NIVEL_NADA;
+    reg.perdidos = 0;
+
+    // La traza lleva todos los eventos, escriba el texto los que escriba
+    reg.hayTraza = op->traza != NULL;
+    if (reg.hayTraza && abrir_escritor_traza(&traza, op->traza) < 0)
+        return -1;
+    int nivel = reg.hayTraza ? NIVEL_DEPURACION : (int)reg.op.nivel;
+    __atomic_store_n(&nivelRegistro, nivel, __ATOMIC_RELAXED);
+    if (nivel > NIVEL_NADA)
+        arrancar_escritor();
+    return 0;
+}
+
+void terminar_registro()
+{
+    if (!reg.enMarcha)
+        return;
+    __atomic_store_n(&reg.parar, 1, __ATOMIC_RELEASE);
+    pthread_join(reg.escritor, NULL);
+    reg.enMarcha = 0;
+    __atomic_store_n(&nivelRegistro, NIVEL_NADA, __ATOMIC_RELAXED);
+    if (reg.hayTraza) {
+        cerrar_escritor_traza(&traza);
+        reg.hayTraza = 0;
+        // Cada proceso del motor procesos cuenta lo suyo; el padre, nada
+        if (traza.eventos > 0) {
+            printf("🧾 Traza: %ld eventos en %ld bytes (%.2f bytes por evento) en %s\n", traza.eventos, traza.bytes,
+                   (double)traza.bytes / traza.eventos, reg.op.traza);
+            fflush(stdout);
+        }
+    }
+    long perdidos = __atomic_load_n(&reg.perdidos, __ATOMIC_RELAXED);
+    if (perdidos > 0)
+        fprintf(stderr, "⚠️  Registro: %ld mensajes perdidos con los anillos llenos\n", perdidos);
+}
+
+#endif
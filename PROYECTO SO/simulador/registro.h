@@ -0,0 +1,106 @@
+// Registro asíncrono de lo que hace cada vehículo
+//
+// Los motores no llaman a printf: cada mensaje es un registro binario de
+// tamaño fijo que el hilo que lo produce deja en su propio anillo (uno por
+// hilo, un solo productor y un solo consumidor, sin bloqueos). Un hilo
+// aparte los ordena, les da formato (el de los printf de
+// Problema2Gamma2-1.c) y los escribe. Así el cerrojo interno de stdout no
+// vuelve a ser el punto donde se serializa la simulación.
+//
+// El mismo hilo puede escribir además todos los eventos en una traza
+// binaria compacta (traza.h), y se puede quedar solo con 1 de cada N
+// vehículos.
+//
+// El nivel se elige al arrancar; con -DSIN_REGISTRO desaparecen todas las
+// llamadas (para las compilaciones de benchmark).
+#ifndef REGISTRO_H
+#define REGISTRO_H
+
+#include <stdio.h>
+
+#include "trafico.h"
+
+typedef enum {
+    NIVEL_NADA,
+    NIVEL_ERROR,
+    NIVEL_AVISO,
+    NIVEL_INFO,         // Inicio, hombrillos y final de cada vehículo
+    NIVEL_DEPURACION    // Además cada entrada y salida de subtramo
+} NivelRegistro;
+
+typedef enum {
+    REG_INICIA,         // lugar = subtramo de entrada
+    REG_ENTRA,          // lugar = subtramo
+    REG_CIRCULA,        // lugar = subtramo, valor = us que tardará
+    REG_SALE,           // lugar = subtramo
+    REG_LLENO,          // lugar = subtramo lleno, valor = hombrillo
+    REG_ESPERO,         // lugar = hombrillo, valor = us de espera
+    REG_TERMINA,
+} TipoRegistro;
+
+// Nivel de cada tipo
+#define NIVEL_REG_INICIA   NIVEL_INFO
+#define NIVEL_REG_ENTRA    NIVEL_DEPURACION
+#define NIVEL_REG_CIRCULA  NIVEL_DEPURACION
+#define NIVEL_REG_SALE     NIVEL_DEPURACION
+#define NIVEL_REG_LLENO    NIVEL_INFO
+#define NIVEL_REG_ESPERO   NIVEL_INFO
+#define NIVEL_REG_TERMINA  NIVEL_INFO
+
+// Qué hace un hilo cuyo anillo está lleno. Con el reloj real esperar
+// cambiaría los tiempos del modelo, así que se pierde el mensaje (y se
+// cuenta); con el reloj virtual (des) esperar no cambia nada
+typedef enum {
+    ANILLO_LLENO_PIERDE,
+    ANILLO_LLENO_ESPERA
+} PoliticaRegistro;
+
+typedef struct {
+    NivelRegistro nivel;        // De los mensajes de texto
+    PoliticaRegistro politica;
+    FILE* salida;               // Para el texto
+    const char* traza;          // Fichero de traza binaria, o NULL
+    int muestreo;               // 1 de cada N vehículos (0 o 1: todos)
+} OpcionesRegistro;
+
+// Lee un nivel por nombre (nada, error, aviso, info, depuracion) o número;
+// -1 si no lo entiende
+int leer_nivel_registro(const char* texto);
+
+#ifdef SIN_REGISTRO
+
+#define REGISTRAR(tipo, v, t, lugar, valor) ((void)0)
+#define iniciar_registro(op) ((void)(op), 0)
+#define terminar_registro() ((void)0)
+#define preparar_registro_hilo() ((void)0)
+
+#else
+
+extern int nivelRegistro;
+
+// Un evento del vehículo v en el instante t del modelo. La comprobación del
+// nivel va en línea: con el registro apagado solo cuesta una comparación
+#define REGISTRAR(tipo, v, t, lugar, valor)                                        \
+    do {                                                                           \
+        if (__builtin_expect(NIVEL_##tipo <= __atomic_load_n(&nivelRegistro, __ATOMIC_RELAXED), 0)) \
+            registrar_evento((tipo), (v), (t), (lugar), (valor));                  \
+    } while (0)
+
+void registrar_evento(TipoRegistro tipo, const Vehiculo* v, tiempo_us t, int lugar, long long valor);
+
+// Toma ya el anillo del hilo que llama si hay registro. registrar_evento()
+// lo toma en su primera llamada, y eso reserva memoria: los hilos que
+// ejecutan fibras con pilas pequeñas lo llaman antes de entrar en ellas
+void preparar_registro_hilo();
+
+// Arranca el hilo escritor (-1 si no puede abrir la traza);
+// terminar_registro() escribe lo que quede, lo para y avisa en stderr si se
+// perdieron mensajes. Un hijo de fork() tiene su propio escritor, que añade
+// sus bloques a la misma traza, y debe llamar a terminar_registro() antes
+// de _exit()
+int iniciar_registro(const OpcionesRegistro* op);
+void terminar_registro();
+
+#endif
+
+#endif
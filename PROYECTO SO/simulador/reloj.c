@@ -0,0 +1,37 @@
+#include <unistd.h>
+
+#include "reloj.h"
+
+void iniciar_reloj(RelojReal* r, int aceleracion)
+{
+    r->aceleracion = (aceleracion > 0) ? aceleracion : 1;
+    clock_gettime(CLOCK_MONOTONIC, &r->inicio);
+}
+
+tiempo_us tiempo_modelo(const RelojReal* r)
+{
+    struct timespec ahora;
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    tiempo_us real = (ahora.tv_sec - r->inicio.tv_sec) * USEG_POR_SEGUNDO
+                   + (ahora.tv_nsec - r->inicio.tv_nsec) / 1000;
+    return real * r->aceleracion;
+}
+
+void dormir_modelo(const RelojReal* r, tiempo_us t)
+{
+    usleep((useconds_t)(t / r->aceleracion));
+}
+
+// Instante de CLOCK_MONOTONIC que corresponde al tiempo t del modelo
+struct timespec instante_real(const RelojReal* r, tiempo_us t)
+{
+    tiempo_us real = t / r->aceleracion;
+    struct timespec ts = r->inicio;
+    ts.tv_sec += real / USEG_POR_SEGUNDO;
+    ts.tv_nsec += (real % USEG_POR_SEGUNDO) * 1000;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+    return ts;
+}
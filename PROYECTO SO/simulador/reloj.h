@@ -0,0 +1,19 @@
+// Reloj de pared escalado para los motores que corren en tiempo real
+#ifndef RELOJ_H
+#define RELOJ_H
+
+#include <time.h>
+
+#include "trafico.h"
+
+typedef struct {
+    struct timespec inicio;
+    int aceleracion;  // Divide todos los tiempos del modelo
+} RelojReal;
+
+void iniciar_reloj(RelojReal* r, int aceleracion);
+tiempo_us tiempo_modelo(const RelojReal* r);
+void dormir_modelo(const RelojReal* r, tiempo_us t);
+struct timespec instante_real(const RelojReal* r, tiempo_us t);  // Para pthread_cond_timedwait
+
+#endif
@@ -0,0 +1,289 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "trafico.h"
+
+// Lo mismo que fijar_escenario() con escenarios/base.txt: los valores de
+// Problema2Gamma2-1.c (500 vehículos por hora, 24 horas de 30 s, 1 de cada
+// 4 camiones, mitad en cada sentido, usleep(55000 + (rand() % 10001))
+// entre llegadas) salvo el usleep(tiempo_subtramo * 35000) por subtramo de
+// las demás variantes. Gamma2-1 usa 40000 (escenarios/gamma2-1.txt), que
+// deja el subtramo 3 al 100%
+Escenario escenario = {
+    .vehiculosPorHora = 500,
+    .horas = 24,
+    .segundosPorHora = 30,
+    .camiones = { 1, 4 },
+    .sentido4a1 = { 1, 2 },
+    .llegadaMin = 55000,
+    .llegadaRango = 10001,
+    .unidadSubtramo = 35000,
+    .totalVehiculos = 500 * 24,
+    .usegPorHora = 30 * USEG_POR_SEGUNDO,
+    .usegTotal = 30 * 24 * USEG_POR_SEGUNDO,
+};
+
+// Lo mismo que definir_autopista() con la lista "4,2/1/2,1,3"
+Autopista autopista = {
+    .numSubtramos = 4,
+    .capacidad = { 4, 2, 1, 3 },
+    .peso = { { 1, 1 }, { 1, 2 }, { 1, 1 }, { 1, 1 } },
+    .conPeso = { 0, 1, 0, 0 },
+    .entrada = { 0, 3 },
+    .siguiente = { { 1, 2, 3, -1 }, { -1, 0, 1, 2 } },
+    .hombrillo = { { 0, 1, 2, -1 }, { -1, 0, 1, 2 } },
+};
+
+void definir_autopista(int numSubtramos, const int* capacidad, const int (*peso)[2])
+{
+    if (numSubtramos < 1 || numSubtramos > MAX_SUBTRAMOS) {
+        fprintf(stderr, "La autopista debe tener entre 1 y %d subtramos\n", MAX_SUBTRAMOS);
+        exit(1);
+    }
+
+    Autopista* a = &autopista;
+    memset(a, 0, sizeof(*a));
+    a->numSubtramos = numSubtramos;
+    for (int i = 0; i < numSubtramos; i++) {
+        a->capacidad[i] = capacidad[i];
+        a->peso[i][AUTO] = peso[i][AUTO];
+        a->peso[i][CAMION] = peso[i][CAMION];
+        a->conPeso[i] = (peso[i][AUTO] != 1 || peso[i][CAMION] != 1);
+
+        // En 1→N el hombrillo i separa el subtramo i del i+1; en N→1, el
+        // i-1 separa el subtramo i del i-1
+        int ultimo = (i == numSubtramos - 1);
+        a->siguiente[DIR_1A4][i] = ultimo ? -1 : i + 1;
+        a->hombrillo[DIR_1A4][i] = ultimo ? -1 : i;
+        a->siguiente[DIR_4A1][i] = i - 1;
+        a->hombrillo[DIR_4A1][i] = i - 1;
+    }
+    a->entrada[DIR_1A4] = 0;
+    a->entrada[DIR_4A1] = numSubtramos - 1;
+}
+
+// Un número positivo al principio de *p; avanza *p. -1 si no hay
+static int leer_numero(const char** p)
+{
+    char* fin;
+    long n = strtol(*p, &fin, 10);
+    if (fin == *p || n < 1 || n > 1000000)
+        return -1;
+    *p = fin;
+    return (int)n;
+}
+
+int leer_autopista(const char* texto)
+{
+    int capacidad[MAX_SUBTRAMOS];
+    int peso[MAX_SUBTRAMOS][2];
+    int n = 0;
+    const char* p = texto;
+
+    for (;;) {
+        int cap = leer_numero(&p);
+        int pesoAuto = 1, pesoCamion = 1, veces = 1;
+        if (cap < 0)
+            return -1;
+        if (*p == '/') {
+            p++;
+            pesoAuto = leer_numero(&p);
+            if (pesoAuto < 0 || *p != '/')
+                return -1;
+            p++;
+            pesoCamion = leer_numero(&p);
+            if (pesoCamion < 0)
+                return -1;
+        }
+        if (*p == '*') {
+            p++;
+            veces = leer_numero(&p);
+            if (veces < 0)
+                return -1;
+        }
+        // Un vehículo que no cabe nunca bloquearía la autopista para siempre
+        if (pesoAuto > cap || pesoCamion > cap || veces > MAX_SUBTRAMOS - n)
+            return -1;
+        for (int k = 0; k < veces; k++, n++) {
+            capacidad[n] = cap;
+            peso[n][AUTO] = pesoAuto;
+            peso[n][CAMION] = pesoCamion;
+        }
+
+        if (*p == '\0')
+            break;
+        if (*p != ',')
+            return -1;
+        p++;
+    }
+
+    definir_autopista(n, capacidad, (const int (*)[2])peso);
+    return 0;
+}
+
+void mostrar_autopista()
+{
+    printf("🛣️  Subtramos: %d (capacidad/peso auto/peso camion:", NUM_SUBTRAMOS);
+    for (int i = 0; i < NUM_SUBTRAMOS; i++)
+        printf(" %d/%d/%d", autopista.capacidad[i], autopista.peso[i][AUTO], autopista.peso[i][CAMION]);
+    printf(")\n");
+}
+
+void inicializar_subtramos(EstadoSubtramo subtramos[MAX_SUBTRAMOS])
+{
+    for (int i = 0; i < NUM_SUBTRAMOS; i++) {
+        subtramos[i].capacidad = autopista.capacidad[i];
+        subtramos[i].peso[AUTO] = autopista.peso[i][AUTO];
+        subtramos[i].peso[CAMION] = autopista.peso[i][CAMION];
+        subtramos[i].carga = 0;
+        subtramos[i].vehiculosPresentes = 0;
+        subtramos[i].contadorAutos = 0;
+        subtramos[i].contadorCamiones = 0;
+    }
+}
+
+// Con los pesos de la autopista por defecto es la misma regla que
+// Problema2Gamma2-1.c: en el subtramo 2 caben 2 autos o 1 camion solo; en
+// el resto manda la capacidad
+int puede_entrar_subtramo(const EstadoSubtramo* s, vehicleType tipo)
+{
+    return s->carga + s->peso[tipo] <= s->capacidad;
+}
+
+void ocupar_subtramo(EstadoSubtramo* s, vehicleType tipo)
+{
+    s->carga += s->peso[tipo];
+    s->vehiculosPresentes++;
+    if (tipo == AUTO)
+        s->contadorAutos++;
+    else
+        s->contadorCamiones++;
+}
+
+void liberar_subtramo(EstadoSubtramo* s, vehicleType tipo)
+{
+    s->carga -= s->peso[tipo];
+    s->vehiculosPresentes--;
+    if (tipo == AUTO)
+        s->contadorAutos--;
+    else
+        s->contadorCamiones--;
+}
+
+static unsigned long long mezclar(unsigned long long z)
+{
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void iniciar_flujo(FlujoAleatorio* f, unsigned int semilla, unsigned int flujo)
+{
+    f->clave = mezclar(((unsigned long long)semilla << 32) | flujo);
+    f->sorteos = 0;
+}
+
+int aleatorio(FlujoAleatorio* f)
+{
+    f->sorteos++;
+    return (int)(mezclar(f->clave + f->sorteos * 0x9E3779B97F4A7C15ULL) >> 33);
+}
+
+void generar_vehiculo(Vehiculo* v, int id, tiempo_us ahora, unsigned int semilla)
+{
+    v->id = id;
+    iniciar_flujo(&v->flujo, semilla, (unsigned int)id);
+    // Con 1/4 y 1/2 son el rand() % 4 == 0 y el rand() % 2 de Gamma2-1
+    Proporcion c = escenario.camiones, d = escenario.sentido4a1;
+    v->tipo = (aleatorio(&v->flujo) % c.denominador < c.numerador) ? CAMION : AUTO;
+    v->dir = (aleatorio(&v->flujo) % d.denominador < d.numerador) ? DIR_4A1 : DIR_1A4;
+    v->horaEntrada = ahora;
+}
+
+tiempo_us sortear_tiempo_subtramo(Vehiculo* v)
+{
+    int tiempo_subtramo = (aleatorio(&v->flujo) % 2) + 1; // 1-2 unidades
+    return (tiempo_us)tiempo_subtramo * USEG_POR_UNIDAD_SUBTRAMO;
+}
+
+tiempo_us sortear_tiempo_llegada(FlujoAleatorio* llegadas)
+{
+    return USEG_LLEGADA_MIN + (aleatorio(llegadas) % USEG_LLEGADA_RANGO);
+}
+
+int obtener_hora_simulacion(tiempo_us t)
+{
+    return (int)(t / USEG_POR_HORA) % 24;
+}
+
+void iniciar_estadisticas(Estadisticas* est)
+{
+    memset(est, 0, sizeof(*est));
+}
+
+void registrar_llegada(Estadisticas* est, const Vehiculo* v)
+{
+    int hora = obtener_hora_simulacion(v->horaEntrada);
+    est->estadisticasHorarias[hora][v->dir]++;
+    est->totalVehiculosDia++;
+}
+
+void registrar_entrada_hombrillo(EstadisticaHombrillo* h)
+{
+    h->vehiculosEsperando++;
+    if (h->vehiculosEsperando > h->maxEspera)
+        h->maxEspera = h->vehiculosEsperando;
+}
+
+void registrar_salida_hombrillo(EstadisticaHombrillo* h, tiempo_us espera)
+{
+    h->vehiculosEsperando--;
+    if (espera > h->tiempoMaxEspera)
+        h->tiempoMaxEspera = espera;
+    h->tiempoTotalEspera += espera;
+    h->totalVehiculosEsperado++;
+}
+
+// Mismo formato que mostrar_estadisticas() de Problema2Alpha.c, pero con los
+// tiempos de espera en fracciones de segundo (el motor de eventos mide en us)
+void mostrar_estadisticas(const Estadisticas* est)
+{
+    printf("\n");
+    printf("📊 ========== ESTADÍSTICAS FINALES ==========\n");
+
+    printf("\n📈 ESTADÍSTICAS HORARIAS (vehículos generados por hora):\n");
+    printf("Hora | Dirección 1→4 | Dirección 4→1 | Total\n");
+    printf("-----|---------------|---------------|-------\n");
+    for (int hora = 0; hora < 24; hora++) {
+        int total_hora = est->estadisticasHorarias[hora][0] + est->estadisticasHorarias[hora][1];
+        printf("%2d   | %13d | %13d | %5d\n",
+               hora+1, est->estadisticasHorarias[hora][0], est->estadisticasHorarias[hora][1], total_hora);
+    }
+
+    printf("\n🛣️  ESTADÍSTICAS POR SUBTRAMO (vehículos que circularon):\n");
+    for (int i = 0; i < NUM_SUBTRAMOS; i++) {
+        int total_subtramo = est->estadisticasSubtramos[i][0] + est->estadisticasSubtramos[i][1];
+        printf("Subtramo %d:\n", i + 1);
+        printf("  Dirección 1→4: %d vehículos\n", est->estadisticasSubtramos[i][0]);
+        printf("  Dirección 4→1: %d vehículos\n", est->estadisticasSubtramos[i][1]);
+        printf("  Total: %d vehículos\n", total_subtramo);
+    }
+
+    printf("\n🅿️  ESTADÍSTICAS DE HOMBRILLOS:\n");
+    for (int i = 0; i < NUM_HOMBRILLOS; i++) {
+        const EstadisticaHombrillo* h = &est->hombrillos[i];
+        printf("Hombrillo %d-%d:\n", i + 1, i + 2);
+        printf("  Máximo vehículos esperando: %d\n", h->maxEspera);
+        printf("  Tiempo máximo de espera: %.3f segundos\n", (double)h->tiempoMaxEspera / USEG_POR_SEGUNDO);
+        if (h->totalVehiculosEsperado > 0) {
+            double promedio = (double)h->tiempoTotalEspera / h->totalVehiculosEsperado / USEG_POR_SEGUNDO;
+            printf("  Tiempo promedio de espera: %.3f segundos\n", promedio);
+        }
+        printf("  Total vehículos que esperaron: %d\n", h->totalVehiculosEsperado);
+    }
+
+    printf("\n📦 TOTAL DE VEHÍCULOS EN EL DÍA: %d\n", est->totalVehiculosDia);
+    printf("🏁 Vehículos que completaron el recorrido: %d\n", est->vehiculosCompletados);
+    printf("==========================================\n");
+}
@@ -0,0 +1,159 @@
+// Modelo común de la autopista (subtramos, hombrillos y estadísticas)
+// Lo comparten todos los motores de simulador/ para que las estadísticas
+// sean comparables entre sí y con las variantes Problema2*.c
+#ifndef TRAFICO_H
+#define TRAFICO_H
+
+// Topología de la autopista: subtramos en fila con un hombrillo entre cada
+// par. La capacidad de un subtramo va en unidades de peso y cada tipo de
+// vehículo pesa lo suyo en cada subtramo: con capacidad 2 y pesos 1 (auto)
+// y 2 (camion) caben 2 autos o 1 camion solo, que es la regla del
+// subtramo 2 de Problema2Gamma2-1.c. Las tablas de recorrido dan en O(1)
+// el siguiente subtramo y el hombrillo de cada salto sin mirar qué
+// subtramo es
+#define MAX_SUBTRAMOS 64
+#define MAX_HOMBRILLOS (MAX_SUBTRAMOS - 1)
+
+// Todos los tiempos del modelo van en microsegundos, en la misma escala
+// que los usleep() de las versiones con hilos
+typedef long long tiempo_us;
+
+#define USEG_POR_SEGUNDO 1000000LL
+
+// Escenario: los parámetros del modelo que antes eran #define en cada
+// Problema*.c. Se leen una vez al arrancar (escenario.h) y después solo se
+// consultan; los valores por defecto son los de escenarios/base.txt
+typedef struct {
+    int numerador;
+    int denominador;
+} Proporcion;  // Sale con probabilidad numerador/denominador
+
+typedef struct {
+    int vehiculosPorHora;         // Con horas, tope de vehículos del día
+    int horas;
+    int segundosPorHora;          // Segundos reales que simulan 1 hora
+    Proporcion camiones;
+    Proporcion sentido4a1;        // Los que van del último subtramo al primero
+    tiempo_us llegadaMin;         // Entre llegadas: llegadaMin + [0, llegadaRango)
+    tiempo_us llegadaRango;
+    tiempo_us unidadSubtramo;     // Un subtramo se recorre en 1 o 2 unidades
+
+    // Derivados, calculados al fijar el escenario
+    int totalVehiculos;
+    tiempo_us usegPorHora;
+    tiempo_us usegTotal;
+} Escenario;
+
+extern Escenario escenario;
+
+#define VEHICULOS_POR_HORA (escenario.vehiculosPorHora)
+#define HORAS_SIMULACION (escenario.horas)
+#define TOTAL_VEHICULOS (escenario.totalVehiculos)
+#define SEGUNDOS_POR_HORA_SIMULACION (escenario.segundosPorHora)
+#define USEG_POR_HORA (escenario.usegPorHora)
+#define USEG_TOTAL_SIMULACION (escenario.usegTotal)
+#define USEG_POR_UNIDAD_SUBTRAMO (escenario.unidadSubtramo)
+#define USEG_LLEGADA_MIN (escenario.llegadaMin)
+#define USEG_LLEGADA_RANGO (escenario.llegadaRango)
+
+// Estructuras de datos
+typedef enum { AUTO, CAMION } vehicleType;
+typedef enum { DIR_1A4, DIR_4A1 } Direccion;  // Del primer subtramo al último y al revés
+
+typedef struct {
+    int numSubtramos;
+    int capacidad[MAX_SUBTRAMOS];
+    int peso[MAX_SUBTRAMOS][2];         // [subtramo][vehicleType]
+    int conPeso[MAX_SUBTRAMOS];         // Algún peso distinto de 1
+
+    // Recorrido, calculado por definir_autopista()
+    int entrada[2];                     // [Direccion]
+    int siguiente[2][MAX_SUBTRAMOS];    // [Direccion][subtramo]; -1 en el último
+    int hombrillo[2][MAX_SUBTRAMOS];    // Entre el subtramo y el siguiente
+} Autopista;
+
+// La que usan todos los motores; por defecto la de Problema2Gamma2-1.c
+extern Autopista autopista;
+
+#define NUM_SUBTRAMOS (autopista.numSubtramos)
+#define NUM_HOMBRILLOS (autopista.numSubtramos - 1)
+
+// Sorteos sin estado compartido: el número k de un flujo es una función
+// pura de (semilla del día, flujo, k). El flujo FLUJO_LLEGADAS da los
+// tiempos entre llegadas y el flujo id es el del vehículo id, así que lo
+// que sortea un vehículo no depende de qué hilo lo mueva ni de cuándo
+typedef struct {
+    unsigned long long clave;  // (semilla, flujo) ya mezclados
+    unsigned int sorteos;      // Número del siguiente sorteo
+} FlujoAleatorio;
+
+#define FLUJO_LLEGADAS 0
+
+typedef struct {
+    int id;                 // Identificación del vehículo
+    vehicleType tipo;       // Auto o camion
+    Direccion dir;          // direccion de conduccion
+    tiempo_us horaEntrada;  // Instante (del modelo) en que se generó
+    FlujoAleatorio flujo;   // Sus tiempos de recorrido
+} Vehiculo;
+
+// Ocupación de un subtramo. No lleva mutex ni semáforo: cada motor decide
+// cómo protegerla (o si no hace falta, como en el motor de eventos)
+typedef struct {
+    int capacidad;
+    int peso[2];            // [vehicleType], copiado de la autopista
+    int carga;              // Suma de los pesos presentes
+    int vehiculosPresentes;
+    int contadorAutos;
+    int contadorCamiones;
+} EstadoSubtramo;
+
+typedef struct {
+    int vehiculosEsperando;       // Contador actual de vehículos esperando
+    int maxEspera;                // Máximo histórico de vehículos esperando
+    tiempo_us tiempoMaxEspera;    // Tiempo de espera más largo registrado
+    tiempo_us tiempoTotalEspera;  // Suma acumulada de todos los tiempos de espera
+    int totalVehiculosEsperado;   // Total de vehículos que han esperado
+} EstadisticaHombrillo;
+
+typedef struct {
+    int estadisticasHorarias[24][2];                  // [hora][direccion]
+    int estadisticasSubtramos[MAX_SUBTRAMOS][2];      // [subtramo][direccion]
+    EstadisticaHombrillo hombrillos[MAX_HOMBRILLOS];
+    int totalVehiculosDia;
+    int vehiculosCompletados;
+} Estadisticas;
+
+// Autopista. definir_autopista() sale con error si numSubtramos no está
+// entre 1 y MAX_SUBTRAMOS. leer_autopista() acepta una lista separada por
+// comas de CAPACIDAD[/PESO_AUTO/PESO_CAMION][*REPETICIONES], por ejemplo
+// "4,2/1/2,1,3" (la de por defecto) o "40*3"; devuelve -1 si no se entiende
+void definir_autopista(int numSubtramos, const int* capacidad, const int (*peso)[2]);
+int leer_autopista(const char* texto);
+void mostrar_autopista();
+
+// Subtramos
+void inicializar_subtramos(EstadoSubtramo subtramos[MAX_SUBTRAMOS]);
+int puede_entrar_subtramo(const EstadoSubtramo* s, vehicleType tipo);
+void ocupar_subtramo(EstadoSubtramo* s, vehicleType tipo);
+void liberar_subtramo(EstadoSubtramo* s, vehicleType tipo);
+
+// Sorteos. aleatorio() da 31 bits, como rand(), con el mezclador de
+// SplitMix64 aplicado a clave + (k + 1) * 0x9E3779B97F4A7C15.
+// generar_vehiculo() usa los sorteos 0 y 1 del vehículo y cada subtramo
+// recorrido, uno más
+void iniciar_flujo(FlujoAleatorio* f, unsigned int semilla, unsigned int flujo);
+int aleatorio(FlujoAleatorio* f);
+void generar_vehiculo(Vehiculo* v, int id, tiempo_us ahora, unsigned int semilla);
+tiempo_us sortear_tiempo_subtramo(Vehiculo* v);
+tiempo_us sortear_tiempo_llegada(FlujoAleatorio* llegadas);
+
+// Estadísticas
+int obtener_hora_simulacion(tiempo_us t);
+void iniciar_estadisticas(Estadisticas* est);
+void registrar_llegada(Estadisticas* est, const Vehiculo* v);
+void registrar_entrada_hombrillo(EstadisticaHombrillo* h);
+void registrar_salida_hombrillo(EstadisticaHombrillo* h, tiempo_us espera);
+void mostrar_estadisticas(const Estadisticas* est);
+
+#endif
@@ -0,0 +1,231 @@
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+#include "traza.h"
+
+static unsigned char* poner_varint(unsigned char* p, uint64_t v)
+{
+    while (v >= 0x80) {
+        *p++ = (unsigned char)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (unsigned char)v;
+    return p;
+}
+
+static uint64_t zigzag(int64_t v)
+{
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static int64_t deshacer_zigzag(uint64_t v)
+{
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+// Solo para lo que quede si writev() escribe a medias
+static void escribir_todo(int fd, const void* datos, size_t tam)
+{
+    const char* p = datos;
+    while (tam > 0) {
+        ssize_t n = write(fd, p, tam);
+        if (n < 0) {
+            perror("write traza");
+            return;
+        }
+        p += n;
+        tam -= (size_t)n;
+    }
+}
+
+static void empezar_bloque(EscritorTraza* e)
+{
+    e->cabecera.eventos = 0;
+    e->fin = e->datos;
+}
+
+int abrir_escritor_traza(EscritorTraza* e, const char* fichero)
+{
+    e->fd = open(fichero, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    if (e->fd < 0) {
+        perror(fichero);
+        return -1;
+    }
+    escribir_todo(e->fd, TRAZA_MAGIA_FICHERO, 8);
+    e->eventos = 0;
+    e->bytes = 8;
+    empezar_bloque(e);
+    return 0;
+}
+
+void vaciar_escritor_traza(EscritorTraza* e)
+{
+    if (e->cabecera.eventos == 0)
+        return;
+
+    // Cabecera y datos en un solo writev()
+    size_t bytes = (size_t)(e->fin - e->datos);
+    e->cabecera.magia = TRAZA_MAGIA_BLOQUE;
+    e->cabecera.bytes = (uint32_t)bytes;
+    struct iovec partes[2] = {
+        { &e->cabecera, sizeof(CabeceraBloque) },
+        { e->datos, bytes },
+    };
+    ssize_t n = writev(e->fd, partes, 2);
+    if (n < 0) {
+        perror("writev traza");
+    } else if ((size_t)n < sizeof(CabeceraBloque)) {
+        escribir_todo(e->fd, (char*)&e->cabecera + n, sizeof(CabeceraBloque) - (size_t)n);
+        escribir_todo(e->fd, e->datos, bytes);
+    } else {
+        escribir_todo(e->fd, e->datos + (n - sizeof(CabeceraBloque)), bytes - (size_t)(n - sizeof(CabeceraBloque)));
+    }
+
+    e->bytes += sizeof(CabeceraBloque) + bytes;
+    empezar_bloque(e);
+}
+
+void anotar_evento_traza(EscritorTraza* e, const EventoTraza* ev)
+{
+    if (e->cabecera.eventos == 0) {
+        e->cabecera.tiempoBase = e->tiempoAnterior = ev->t;
+        e->cabecera.vehiculoBase = (uint32_t)ev->vehiculo;
+        e->vehiculoAnterior = ev->vehiculo;
+    }
+
+    unsigned char* p = e->fin;
+    *p++ = (unsigned char)(ev->clase | ev->tipo << 3 | ev->dir << 4 | (ev->valor != 0) << 5);
+    p = poner_varint(p, zigzag(ev->t - e->tiempoAnterior));
+    p = poner_varint(p, zigzag((int64_t)ev->vehiculo - e->vehiculoAnterior));
+    p = poner_varint(p, (uint32_t)ev->lugar);
+    if (ev->valor != 0)
+        p = poner_varint(p, zigzag(ev->valor));
+    e->fin = p;
+    e->tiempoAnterior = ev->t;
+    e->vehiculoAnterior = ev->vehiculo;
+    e->eventos++;
+
+    if (++e->cabecera.eventos == TRAZA_EVENTOS_POR_BLOQUE)
+        vaciar_escritor_traza(e);
+}
+
+void descartar_escritor_traza(EscritorTraza* e)
+{
+    e->eventos = 0;
+    e->bytes = 0;
+    empezar_bloque(e);
+}
+
+void cerrar_escritor_traza(EscritorTraza* e)
+{
+    vaciar_escritor_traza(e);
+    close(e->fd);
+    e->fd = -1;
+}
+
+int abrir_lector_traza(LectorTraza* l, const char* fichero)
+{
+    int fd = open(fichero, O_RDONLY);
+    if (fd < 0) {
+        perror(fichero);
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size < 8) {
+        fprintf(stderr, "%s: no es una traza\n", fichero);
+        close(fd);
+        return -1;
+    }
+    l->tam = (size_t)st.st_size;
+    l->base = mmap(NULL, l->tam, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (l->base == MAP_FAILED) {
+        perror("mmap");
+        return -1;
+    }
+    if (memcmp(l->base, TRAZA_MAGIA_FICHERO, 8) != 0) {
+        fprintf(stderr, "%s: no es una traza\n", fichero);
+        munmap((void*)l->base, l->tam);
+        return -1;
+    }
+    madvise((void*)l->base, l->tam, MADV_SEQUENTIAL);
+    l->pos = l->base + 8;
+    l->fin = l->base + l->tam;
+    return 0;
+}
+
+// Un varint corrupto no puede leer más allá de fin: lo deja en fin + 1 y el
+// bloque se rechaza
+static inline uint64_t leer_varint(const unsigned char** pp, const unsigned char* fin)
+{
+    const unsigned char* p = *pp;
+    if (p < fin && *p < 0x80) {
+        *pp = p + 1;
+        return *p;
+    }
+    uint64_t v = 0;
+    for (int desplazamiento = 0; p < fin && desplazamiento < 64; desplazamiento += 7) {
+        unsigned char b = *p++;
+        v |= (uint64_t)(b & 0x7f) << desplazamiento;
+        if (!(b & 0x80)) {
+            *pp = p;
+            return v;
+        }
+    }
+    *pp = fin + 1;
+    return 0;
+}
+
+int leer_bloque_traza(LectorTraza* l, EventoTraza* eventos)
+{
+    if (l->pos == l->fin)
+        return 0;
+
+    CabeceraBloque c;
+    if ((size_t)(l->fin - l->pos) < sizeof(c))
+        return -1;
+    memcpy(&c, l->pos, sizeof(c));
+    const unsigned char* p = l->pos + sizeof(c);
+    if (c.magia != TRAZA_MAGIA_BLOQUE || c.eventos > TRAZA_EVENTOS_POR_BLOQUE ||
+        c.bytes > (size_t)(l->fin - p) || c.bytes > (size_t)c.eventos * TRAZA_MAX_EVENTO)
+        return -1;
+    const unsigned char* finBloque = p + c.bytes;
+
+    tiempo_us t = c.tiempoBase;
+    int64_t vehiculo = c.vehiculoBase;
+    for (uint32_t k = 0; k < c.eventos; k++) {
+        if (p >= finBloque)
+            return -1;
+        EventoTraza* ev = &eventos[k];
+        unsigned char cabeza = *p++;
+        t += deshacer_zigzag(leer_varint(&p, finBloque));
+        vehiculo += deshacer_zigzag(leer_varint(&p, finBloque));
+        ev->t = t;
+        ev->vehiculo = (int)vehiculo;
+        ev->lugar = (int)(uint32_t)leer_varint(&p, finBloque);
+        ev->valor = (cabeza & 0x20) ? deshacer_zigzag(leer_varint(&p, finBloque)) : 0;
+        ev->clase = cabeza & 7;
+        ev->tipo = (cabeza >> 3) & 1;
+        ev->dir = (cabeza >> 4) & 1;
+    }
+    if (p != finBloque)
+        return -1;
+
+    l->pos = finBloque;
+    return (int)c.eventos;
+}
+
+void rebobinar_lector_traza(LectorTraza* l)
+{
+    l->pos = l->base + 8;
+}
+
+void cerrar_lector_traza(LectorTraza* l)
+{
+    munmap((void*)l->base, l->tam);
+}
@@ -0,0 +1,88 @@
+// Traza binaria compacta de los eventos de cada vehículo
+//
+// La escribe el hilo escritor del registro (registro.h) con --traza: cada
+// entrada, salida y espera en hombrillo de cada vehículo, sin texto. Los
+// eventos van en bloques independientes: la cabecera del bloque lleva el
+// tiempo y el vehículo de partida, y cada evento solo la diferencia con el
+// anterior en varints (7 bits por byte) en zigzag, más un byte con la
+// clase, el tipo y la dirección. Un evento ocupa unos 4-6 bytes frente a
+// los ~70 de una línea de texto.
+//
+// Cada bloque se escribe con un solo write() sobre un fichero abierto con
+// O_APPEND, así que los procesos hijos del motor procesos pueden escribir
+// en el mismo fichero: sus bloques se intercalan enteros.
+//
+// Formato (enteros en el orden de bytes de la máquina):
+//   fichero: "TRAZASIM" y después bloques
+//   bloque:  magia, eventos, bytes de datos, vehículo base (uint32),
+//            tiempo base (int64), datos
+//   evento:  clase | tipo << 3 | dir << 4 | (valor != 0) << 5 (1 byte),
+//            zigzag(dt), zigzag(dvehículo), lugar, y valor si no es 0
+#ifndef TRAZA_H
+#define TRAZA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "trafico.h"
+
+#define TRAZA_MAGIA_FICHERO "TRAZASIM"
+#define TRAZA_MAGIA_BLOQUE 0x51424c42u    // "BLBQ"
+#define TRAZA_EVENTOS_POR_BLOQUE 4096
+#define TRAZA_MAX_EVENTO 32                // Bytes que puede ocupar un evento
+
+// clase es un TipoRegistro (registro.h)
+typedef struct {
+    tiempo_us t;                // Tiempo del modelo
+    int vehiculo;
+    int lugar;                  // Subtramo, o hombrillo en las esperas
+    long long valor;            // us circulando/esperando, o el hombrillo
+    unsigned char clase;
+    unsigned char tipo;         // AUTO o CAMION
+    unsigned char dir;
+} EventoTraza;
+
+typedef struct {
+    uint32_t magia;
+    uint32_t eventos;
+    uint32_t bytes;
+    uint32_t vehiculoBase;
+    int64_t tiempoBase;
+} CabeceraBloque;
+
+// Escritura (un solo hilo)
+typedef struct {
+    int fd;
+    CabeceraBloque cabecera;
+    unsigned char datos[TRAZA_EVENTOS_POR_BLOQUE * TRAZA_MAX_EVENTO];
+    unsigned char* fin;
+    tiempo_us tiempoAnterior;
+    int vehiculoAnterior;
+    long eventos;
+    long bytes;
+} EscritorTraza;
+
+// -1 y perror si no puede abrir el fichero
+int abrir_escritor_traza(EscritorTraza* e, const char* fichero);
+void anotar_evento_traza(EscritorTraza* e, const EventoTraza* ev);
+void vaciar_escritor_traza(EscritorTraza* e);      // Escribe el bloque a medias
+void descartar_escritor_traza(EscritorTraza* e);   // Lo olvida (hijos de fork())
+void cerrar_escritor_traza(EscritorTraza* e);
+
+// Lectura: el fichero se proyecta con mmap y se decodifica bloque a bloque
+typedef struct {
+    const unsigned char* base;
+    const unsigned char* pos;
+    const unsigned char* fin;
+    size_t tam;
+} LectorTraza;
+
+int abrir_lector_traza(LectorTraza* l, const char* fichero);
+// Decodifica el siguiente bloque en eventos (caben
+// TRAZA_EVENTOS_POR_BLOQUE). Devuelve cuántos hay, 0 al terminar y -1 si
+// el fichero está corrupto
+int leer_bloque_traza(LectorTraza* l, EventoTraza* eventos);
+void rebobinar_lector_traza(LectorTraza* l);   // Vuelve al primer bloque
+void cerrar_lector_traza(LectorTraza* l);
+
+#endif
@@ -0,0 +1,167 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <sched.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+
+#include "vivo.h"
+
+static struct {
+    char nombre[64];
+    char motor[16];
+    int periodoMs;
+    SegmentoVivo* segmento;
+    FotografiarVivo fotografiar;
+    void* arg;
+    pthread_t publicador;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    int parar;
+} vivo = { .mutex = PTHREAD_MUTEX_INITIALIZER };
+
+void configurar_vivo(const char* nombre, const char* motor, int periodoMs)
+{
+    vivo.nombre[0] = '\0';
+    if (nombre == NULL)
+        return;
+    snprintf(vivo.nombre, sizeof(vivo.nombre), "%s", nombre);
+    snprintf(vivo.motor, sizeof(vivo.motor), "%s", motor);
+    vivo.periodoMs = periodoMs > 0 ? periodoMs : VIVO_PERIODO_MS;
+}
+
+// Un solo escritor: el hilo publicador
+static void publicar(int terminado)
+{
+    FotoVivo foto;
+    memset(&foto, 0, sizeof(foto));
+    vivo.fotografiar(vivo.arg, &foto);
+
+    SegmentoVivo* s = vivo.segmento;
+    unsigned int secuencia = s->secuencia;
+    __atomic_store_n(&s->secuencia, secuencia + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    s->foto = foto;
+    s->terminado = terminado;
+    s->publicaciones++;
+    __atomic_store_n(&s->secuencia, secuencia + 2, __ATOMIC_RELEASE);
+}
+
+static void* hilo_publicador(void* arg)
+{
+    (void)arg;
+    struct timespec limite;
+    clock_gettime(CLOCK_MONOTONIC, &limite);
+
+    pthread_mutex_lock(&vivo.mutex);
+    while (!vivo.parar) {
+        pthread_mutex_unlock(&vivo.mutex);
+        publicar(0);
+        pthread_mutex_lock(&vivo.mutex);
+
+        limite.tv_nsec += vivo.periodoMs % 1000 * 1000000L;
+        limite.tv_sec += vivo.periodoMs / 1000 + limite.tv_nsec / 1000000000L;
+        limite.tv_nsec %= 1000000000L;
+        while (!vivo.parar && pthread_cond_timedwait(&vivo.cond, &vivo.mutex, &limite) == 0)
+            ;
+    }
+    pthread_mutex_unlock(&vivo.mutex);
+    return NULL;
+}
+
+void iniciar_vivo(FotografiarVivo fotografiar, void* arg)
+{
+    if (vivo.nombre[0] == '\0')
+        return;
+
+    shm_unlink(vivo.nombre);   // Uno que quedase de una ejecución rota
+    int fd = shm_open(vivo.nombre, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        perror("shm_open vivo");
+        exit(1);
+    }
+    if (ftruncate(fd, sizeof(SegmentoVivo)) < 0) {
+        perror("ftruncate vivo");
+        exit(1);
+    }
+    vivo.segmento = mmap(NULL, sizeof(SegmentoVivo), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (vivo.segmento == MAP_FAILED) {
+        perror("mmap vivo");
+        exit(1);
+    }
+
+    SegmentoVivo* s = vivo.segmento;
+    s->version = VIVO_VERSION;
+    s->pid = (int)getpid();
+    memcpy(s->motor, vivo.motor, sizeof(s->motor));
+    __atomic_store_n(&s->magia, VIVO_MAGIA, __ATOMIC_RELEASE);
+
+    vivo.fotografiar = fotografiar;
+    vivo.arg = arg;
+    vivo.parar = 0;
+    pthread_condattr_t atributos;
+    pthread_condattr_init(&atributos);
+    pthread_condattr_setclock(&atributos, CLOCK_MONOTONIC);
+    pthread_cond_init(&vivo.cond, &atributos);
+    pthread_condattr_destroy(&atributos);
+    int error = pthread_create(&vivo.publicador, NULL, hilo_publicador, NULL);
+    if (error != 0) {
+        // La simulación sigue sin publicar; terminar_vivo() no tiene hilo
+        // que esperar
+        fprintf(stderr, "pthread_create vivo: %s\n", strerror(error));
+        pthread_cond_destroy(&vivo.cond);
+        munmap(vivo.segmento, sizeof(SegmentoVivo));
+        shm_unlink(vivo.nombre);
+        vivo.segmento = NULL;
+    }
+}
+
+void terminar_vivo()
+{
+    if (vivo.segmento == NULL)
+        return;
+
+    pthread_mutex_lock(&vivo.mutex);
+    vivo.parar = 1;
+    pthread_cond_signal(&vivo.cond);
+    pthread_mutex_unlock(&vivo.mutex);
+    pthread_join(vivo.publicador, NULL);
+    pthread_cond_destroy(&vivo.cond);
+
+    // El monitor que ya lo tenga abierto sigue viendo la foto final
+    publicar(1);
+    munmap(vivo.segmento, sizeof(SegmentoVivo));
+    shm_unlink(vivo.nombre);
+    vivo.segmento = NULL;
+}
+
+void foto_de_contadores(FotoVivo* foto, const ContadoresRepartidos* c)
+{
+    juntar_contadores(c, &foto->est);
+    ocupacion_contadores(c, foto->ocupacion);
+    foto->numSubtramos = NUM_SUBTRAMOS;
+    for (int i = 0; i < NUM_SUBTRAMOS; i++)
+        foto->capacidad[i] = autopista.capacidad[i];
+    foto->duracion = USEG_TOTAL_SIMULACION;
+    foto->usegPorHora = USEG_POR_HORA;
+    foto->enCurso = foto->est.totalVehiculosDia - foto->est.vehiculosCompletados;
+}
+
+void leer_segmento_vivo(const SegmentoVivo* s, SegmentoVivo* copia)
+{
+    for (;;) {
+        unsigned int antes = __atomic_load_n(&s->secuencia, __ATOMIC_ACQUIRE);
+        if (antes & 1) {
+            sched_yield();
+            continue;
+        }
+        memcpy(copia, (const void*)s, sizeof(*copia));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&s->secuencia, __ATOMIC_RELAXED) == antes)
+            return;
+    }
+}
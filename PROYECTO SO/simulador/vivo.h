@@ -0,0 +1,64 @@
+// Estadísticas en vivo en un segmento de memoria compartida
+//
+// Con --vivo el simulador publica cada poco (--periodo-vivo, 100 ms por
+// defecto) la ocupación de cada subtramo, los hombrillos, las llegadas por
+// hora y los vehículos en curso en un segmento shm_open que cualquiera
+// puede leer con monitor.c sin tocar ningún cerrojo del simulador.
+//
+// Publica un hilo aparte: toma una foto de los contadores del motor
+// (lecturas relajadas, sin cerrojos; cada número es exacto aunque no todos
+// del mismo instante) y la copia al segmento dentro de un seqlock: la
+// secuencia es impar mientras escribe, y el lector repite si la ve impar o
+// si ha cambiado al terminar de copiar. El lector solo lee, así que mirar
+// no le cuesta nada a la simulación.
+#ifndef VIVO_H
+#define VIVO_H
+
+#include "trafico.h"
+#include "contadores.h"
+
+#define VIVO_MAGIA 0x4f564956u    // "VIVO"
+#define VIVO_VERSION 1
+#define VIVO_PERIODO_MS 100
+
+typedef struct {
+    tiempo_us tiempoModelo;
+    tiempo_us duracion;                 // USEG_TOTAL_SIMULACION
+    tiempo_us usegPorHora;
+    int enCurso;                        // Generados y aún sin salir
+    int numSubtramos;
+    int capacidad[MAX_SUBTRAMOS];
+    int ocupacion[MAX_SUBTRAMOS];       // Vehículos dentro de cada subtramo
+    Estadisticas est;                   // Como mostrar_estadisticas()
+} FotoVivo;
+
+typedef struct {
+    unsigned int magia;
+    unsigned int version;
+    unsigned int secuencia;             // Impar mientras se escribe
+    int pid;
+    char motor[16];
+    int terminado;                      // La última foto ya no cambia
+    long publicaciones;
+    FotoVivo foto;
+} SegmentoVivo;
+
+// Lo que rellena cada motor
+typedef void (*FotografiarVivo)(void* arg, FotoVivo* foto);
+
+// La fija el programa antes de arrancar el motor; nombre NULL o sin
+// llamar: no se publica nada y los motores no notan nada
+void configurar_vivo(const char* nombre, const char* motor, int periodoMs);
+
+// Desde el motor, con sus contadores ya iniciados: arranca y para el hilo
+// que publica. terminar_vivo() publica la foto final y borra el segmento
+void iniciar_vivo(FotografiarVivo fotografiar, void* arg);
+void terminar_vivo();
+
+// La foto de los motores que cuentan con ContadoresRepartidos
+void foto_de_contadores(FotoVivo* foto, const ContadoresRepartidos* c);
+
+// Lectura (monitor.c): copia coherente del segmento, sin cerrojos
+void leer_segmento_vivo(const SegmentoVivo* s, SegmentoVivo* copia);
+
+#endif
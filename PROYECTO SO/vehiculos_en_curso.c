@@ -0,0 +1,51 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "vehiculos_en_curso.h"
+
+static int vehiculosEnCurso = 0;
+static pthread_mutex_t mutexEnCurso = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t condFin = PTHREAD_COND_INITIALIZER;
+
+void registrar_vehiculo()
+{
+    pthread_mutex_lock(&mutexEnCurso);
+    vehiculosEnCurso++;
+    pthread_mutex_unlock(&mutexEnCurso);
+}
+
+void vehiculo_terminado()
+{
+    pthread_mutex_lock(&mutexEnCurso);
+    vehiculosEnCurso--;
+    if (vehiculosEnCurso == 0)
+        pthread_cond_broadcast(&condFin);
+    pthread_mutex_unlock(&mutexEnCurso);
+}
+
+void esperar_vehiculos_en_curso()
+{
+    pthread_mutex_lock(&mutexEnCurso);
+    while (vehiculosEnCurso > 0)
+        pthread_cond_wait(&condFin, &mutexEnCurso);
+    pthread_mutex_unlock(&mutexEnCurso);
+}
+
+int lanzar_vehiculo(void* (*hilo)(void*), void* v)
+{
+    registrar_vehiculo();
+
+    pthread_t id;
+    int error = pthread_create(&id, NULL, hilo, v);
+    if (error != 0) {
+        // Sin esto main esperaría para siempre a un vehículo que no existe
+        fprintf(stderr, "pthread_create: %s\n", strerror(error));
+        vehiculo_terminado();
+        free(v);
+        return -1;
+    }
+    pthread_detach(id);  // Para terminar el hilo correctamente
+    return 0;
+}
@@ -0,0 +1,28 @@
+// Cuenta de los vehículos que aún circulan, compartida por los programas
+// de un hilo por vehículo (Problema2*.c, camion.c, camionsito.c, carros.c
+// y mainTest.c)
+//
+// main lanza cada vehículo con lanzar_vehiculo(), el hilo llama a
+// vehiculo_terminado() como última cosa y main espera con
+// esperar_vehiculos_en_curso() a que no quede ninguno antes de mostrar las
+// estadísticas y liberar los recursos. Se compila junto al programa:
+//   gcc -O2 -pthread camion.c espera_fifo.c vehiculos_en_curso.c -o camion
+#ifndef VEHICULOS_EN_CURSO_H
+#define VEHICULOS_EN_CURSO_H
+
+// Se apunta antes de crear su hilo, para que main nunca vea 0 mientras
+// queda un vehículo por arrancar
+void registrar_vehiculo();
+
+// Lo último que hace cada hilo de vehículo
+void vehiculo_terminado();
+
+// Vuelve en cuanto sale el último vehículo
+void esperar_vehiculos_en_curso();
+
+// Registra el vehículo v (reservado con malloc) y lo pone a circular en un
+// hilo separado con hilo(v). Si no se puede crear el hilo lo explica en
+// stderr, lo da por terminado, libera v y devuelve -1
+int lanzar_vehiculo(void* (*hilo)(void*), void* v);
+
+#endif